@@ -12,8 +12,11 @@ uniform sampler1D audioLeft, audioRight;
 float left (float val){ return texture(audioLeft , val).r; }
 float right(float val){ return texture(audioRight, val).r; }
 
+// Edits of these numbers take effect without a recompile
+#pragma tweak on
 float scale = 4;
 int iter = 10;
+#pragma tweak off
 
 void main() {
 	vec2 center = mouse - 0.5;
@@ -0,0 +1,79 @@
+// Declarations shared by all sandbox shaders, pulled in with
+// #include <sandbox.glsl>. Included once per shader.
+
+// Values that stay constant for the whole frame, updated
+// by the renderer with a single buffer upload. They are
+// read as sandbox.time and so on; the instance name keeps
+// them apart from plain uniforms like "uniform float time;"
+// that the other stage of a program may declare.
+layout(std140) uniform SandboxFrame{
+    mat4 P;
+    mat4 V;
+    mat4 M;
+    vec2 mouse;
+    float time;
+    float timeDelta;
+    int frame;
+    float ration;
+    float audioLevel;
+    float audioPeak;
+    float audioOnset;
+    float beat;
+    float bpm;
+    // Seconds that start over every hour; time is in milliseconds
+    // and loses precision after a few hours
+    float timeSeconds;
+} sandbox;
+
+uniform sampler1D audioLeftData;
+uniform sampler1D audioRightData;
+uniform sampler1D audioLeftSpectrum;
+uniform sampler1D audioRightSpectrum;
+
+
+// Helper functions
+
+float left (float val){ return texture(audioLeftData , val).r ; }
+float right(float val){ return texture(audioRightData, val).r ; }
+float leftSpectrum (float val){ return texture(audioLeftSpectrum , val).r ; }
+float rightSpectrum(float val){ return texture(audioRightSpectrum, val).r ; }
+
+mat4 translate(float x, float y, float z){ return mat4(
+    1,0,0,0,
+    0,1,0,0,
+    0,0,1,0,
+    x,y,z,1
+); }
+
+mat4 scale(float x, float y, float z){ return  mat4(
+    x,0,0,0,
+    0,y,0,0,
+    0,0,z,0,
+    0,0,0,1
+); }
+
+mat4 scale(float s){ return scale(s,s,s); }
+
+mat4 rotateX(float a){ return mat4(
+    1, 0     , 0     , 0,
+    0, cos(a), sin(a), 0,
+    0,-sin(a), cos(a), 0,
+    0, 0     , 0     , 1
+
+); }
+
+mat4 rotateY(float a){ return mat4(
+     cos(a), 0, sin(a), 0,
+     0     , 1, 0     , 0,
+    -sin(a), 0, cos(a), 0,
+     0     , 0, 0     , 1
+
+); }
+
+mat4 rotateZ(float a){ return mat4(
+     cos(a), sin(a), 0, 0,
+    -sin(a), cos(a), 0, 0,
+     0     , 0     , 1, 0,
+     0     , 0     , 0, 1
+
+); }
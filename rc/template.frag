@@ -10,23 +10,12 @@ in vec3 csEyeDirection;
 in vec3 csLightDirection;
 
 
-// Values that stay constant for the whole mesh.
-uniform float time;
-uniform vec2 mouse;
-uniform float ration;
-
-uniform sampler1D audioLeftData;
-uniform sampler1D audioRightData;
+#include <sandbox.glsl>
 
 
 // Ouput data
 out vec4 color;
 
-
-float left (float val){ return texture(audioLeftData , val).r ; }
-float right(float val){ return texture(audioRightData, val).r ; }
-
-
 void main(){
     // Light emission properties
     vec3 LightColor = vec3(1,1,1);
@@ -17,24 +17,13 @@ out vec3 csNormal;
 out vec3 csEyeDirection;
 out vec3 csLightDirection;
 
-// Values that stay constant for the whole mesh.
-uniform mat4 M;
-uniform mat4 V;
-uniform mat4 P;
-
-uniform float time;
-uniform vec2 mouse;
-uniform float ration;
-
-uniform sampler1D audioLeftData;
-uniform sampler1D audioRightData;
-
+#include <sandbox.glsl>
 
 void main(){
     vec4 wsLightPos = vec4(0,2,2, 1);
 
     // manipulation of MVP before using it
-    mat4 m = M, v = V, p = P, mv = v * m, mvp = p * mv;
+    mat4 m = sandbox.M, v = sandbox.V, p = sandbox.P, mv = v * m, mvp = p * mv;
 
     // Prepare vectors for multiplication
     vec4 msVertPos  = vec4(msVertexPosition, 1);
@@ -61,50 +50,3 @@ void main(){
     // UV of the vertex. No special space for this one.
     uv = vertexUV;
 }
-
-
-
-// Helper functions
-
-float left (float val){ return texture(audioLeftData , val).r ; }
-float right(float val){ return texture(audioRightData, val).r ; }
-
-mat4 translate(float x, float y, float z){ return mat4(
-    1,0,0,0,
-    0,1,0,0,
-    0,0,1,0,
-    x,y,z,1
-); }
-
-mat4 scale(float x, float y, float z){ return  mat4(
-    x,0,0,0,
-    0,y,0,0,
-    0,0,z,0,
-    0,0,0,1
-); }
-
-mat4 scale(float s){ return scale(s,s,s); }
-
-mat4 rotateX(float a){ return mat4(
-    1, 0     , 0     , 0,
-    0, cos(a), sin(a), 0,
-    0,-sin(a), cos(a), 0,
-    0, 0     , 0     , 1
-
-); }
-
-mat4 rotateY(float a){ return mat4(
-     cos(a), 0, sin(a), 0,
-     0     , 1, 0     , 0,
-    -sin(a), 0, cos(a), 0,
-     0     , 0, 0     , 1
-
-); }
-
-mat4 rotateZ(float a){ return mat4(
-     cos(a), sin(a), 0, 0,
-    -sin(a), cos(a), 0, 0,
-     0     , 0     , 1, 0,
-     0     , 0     , 0, 1
-
-); }
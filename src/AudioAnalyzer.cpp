@@ -0,0 +1,171 @@
+#include "AudioAnalyzer.hpp"
+#include "AudioCapture.hpp"
+
+#include <cmath>
+
+/**
+ * @brief AudioAnalyzer::AudioAnalyzer
+ */
+AudioAnalyzer::AudioAnalyzer() : envelope(envelopeSize){
+    reset();
+}
+
+/**
+ * @brief AudioAnalyzer::reset
+ *
+ * Forgets all blocks analyzed so far.
+ */
+void AudioAnalyzer::reset() noexcept{
+    previousLeft.clear();
+    previousRight.clear();
+    envelope.fill(0);
+    envelopeEnd = 0;
+    position = 0;
+    fluxMean = 0;
+    beatLag = 0;
+    lastBeatBin = 0;
+}
+
+/**
+ * @brief AudioAnalyzer::analyze
+ * @param block The block following the one analyzed last
+ * @return The features of block
+ */
+AudioFeatures AudioAnalyzer::analyze(const AudioBlock &block) noexcept{
+    AudioFeatures features{0, 0, 0, 0, 0};
+
+    double squares = 0;
+    for(auto channel : {&block.left, &block.right}){
+        for(float sample : *channel){
+            squares += sample * sample;
+            features.peak = qMax(features.peak, std::fabs(sample));
+        }
+    }
+    int samples = block.left.size() + block.right.size();
+    if(samples > 0)
+        features.level = float(std::sqrt(squares / samples));
+
+    float value = (flux(block.leftSpectrum, previousLeft) + flux(block.rightSpectrum, previousRight)) / 2;
+    previousLeft = block.leftSpectrum;
+    previousRight = block.rightSpectrum;
+
+    // An onset is a flux well above its running mean
+    fluxMean = fluxMean > 0 ? 0.95f * fluxMean + 0.05f * value : value;
+    float threshold = 1.5f * fluxMean;
+    if(threshold > 0)
+        features.onset = qBound(0.0f, (value - threshold) / threshold, 1.0f);
+
+    if(block.sampleRate <= 0)
+        return features;
+    double duration = double(block.left.size()) / block.sampleRate;
+    qint64 first = qint64(position * envelopeRate);
+    position += duration;
+    qint64 last = qint64(position * envelopeRate);
+    addToEnvelope(first, last, value);
+    estimateTempo();
+
+    if(beatLag > 0){
+        double sinceBeat = position * envelopeRate - lastBeatBin;
+        features.beat = float(std::fmod(sinceBeat / beatLag, 1.0));
+        if(features.beat < 0)
+            features.beat += 1;
+        features.bpm = 60.0f * envelopeRate / beatLag;
+    }
+    return features;
+}
+
+/**
+ * @brief AudioAnalyzer::flux
+ * @param spectrum Spectrum of the current block
+ * @param previous Spectrum of the previous block
+ * @return The mean rise of the magnitudes
+ *
+ * Blocks of different size have spectra of different size,
+ * so bins are matched by frequency.
+ */
+float AudioAnalyzer::flux(const QVector<float> &spectrum, const QVector<float> &previous) noexcept{
+    if(spectrum.isEmpty() || previous.isEmpty())
+        return 0;
+    float sum = 0;
+    for(int i = 0; i < spectrum.size(); ++i){
+        float rise = spectrum[i] - previous[int(qint64(i) * previous.size() / spectrum.size())];
+        if(rise > 0)
+            sum += rise;
+    }
+    return sum / spectrum.size();
+}
+
+/**
+ * @brief AudioAnalyzer::addToEnvelope
+ * @param first Bin the block starts in
+ * @param last Bin the block ends in
+ * @param value Flux of the block
+ *
+ * The flux counts for the bin the block starts in, the other
+ * bins it covers are silent. Blocks shorter than a bin share
+ * it and keep the larger flux.
+ */
+void AudioAnalyzer::addToEnvelope(qint64 first, qint64 last, float value) noexcept{
+    for(qint64 bin = qMax(first, last - envelopeSize + 1); bin <= last; ++bin){
+        float &slot = envelope[int(bin % envelopeSize)];
+        float binValue = bin == first ? value : 0;
+        slot = bin >= envelopeEnd ? binValue : qMax(slot, binValue);
+    }
+    envelopeEnd = qMax(envelopeEnd, last + 1);
+}
+
+/**
+ * @brief AudioAnalyzer::envelopeAt
+ * @param bin A bin of the last envelopeSize ones
+ * @return Its flux
+ */
+float AudioAnalyzer::envelopeAt(qint64 bin) const noexcept{
+    return envelope[int(bin % envelopeSize)];
+}
+
+/**
+ * @brief AudioAnalyzer::estimateTempo
+ *
+ * Picks the beat period with the strongest autocorrelation of
+ * the envelope, then the phase whose comb of beats collects the
+ * most flux. Needs two seconds of envelope.
+ */
+void AudioAnalyzer::estimateTempo() noexcept{
+    int count = int(qMin<qint64>(envelopeEnd, envelopeSize));
+    if(count < 2 * envelopeRate)
+        return;
+
+    qint64 start = envelopeEnd - count;
+    float mean = 0;
+    for(qint64 bin = start; bin < envelopeEnd; ++bin)
+        mean += envelopeAt(bin);
+    mean /= count;
+
+    int minLag = 60 * envelopeRate / maxBpm, maxLag = 60 * envelopeRate / minBpm;
+    float bestScore = 0;
+    int bestLag = 0;
+    for(int lag = minLag; lag <= maxLag && lag < count; ++lag){
+        float score = 0;
+        for(qint64 bin = start + lag; bin < envelopeEnd; ++bin)
+            score += (envelopeAt(bin) - mean) * (envelopeAt(bin - lag) - mean);
+        score /= count - lag;
+        if(score > bestScore){
+            bestScore = score;
+            bestLag = lag;
+        }
+    }
+    if(bestLag == 0)
+        return;
+    beatLag = bestLag;
+
+    float bestComb = -1;
+    for(int offset = 0; offset < beatLag; ++offset){
+        float comb = 0;
+        for(qint64 bin = envelopeEnd - 1 - offset; bin >= start; bin -= beatLag)
+            comb += envelopeAt(bin);
+        if(comb > bestComb){
+            bestComb = comb;
+            lastBeatBin = envelopeEnd - 1 - offset;
+        }
+    }
+}
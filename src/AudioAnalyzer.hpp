@@ -0,0 +1,57 @@
+#ifndef AUDIOANALYZER_HPP
+#define AUDIOANALYZER_HPP
+
+#include <QVector>
+
+struct AudioBlock;
+
+/**
+ * @brief The AudioFeatures struct
+ *
+ * What a shader wants to know about a block without sampling
+ * the audio textures: RMS level and peak of both channels,
+ * the onset strength in [0, 1], the phase of the current beat
+ * in [0, 1) and the estimated tempo in beats per minute.
+ */
+struct AudioFeatures{
+    float level, peak, onset, beat, bpm;
+};
+
+/**
+ * @brief The AudioAnalyzer class
+ *
+ * Extracts the features of consecutive blocks. Onsets are
+ * detected from the spectral flux against its running mean.
+ * The flux is also collected into an envelope with a fixed
+ * rate, whose autocorrelation gives the tempo and whose comb
+ * filtered maximum gives the beat phase.
+ *
+ * The analyzer keeps its own time, advanced by the length of
+ * each block, so the same blocks always give the same features.
+ */
+class AudioAnalyzer{
+public:
+    AudioAnalyzer();
+    void reset() noexcept;
+    AudioFeatures analyze(const AudioBlock &block) noexcept;
+
+private:
+    static const int envelopeRate = 100;
+    static const int envelopeSize = 512;
+    static const int minBpm = 60, maxBpm = 180;
+
+    static float flux(const QVector<float> &spectrum, const QVector<float> &previous) noexcept;
+    void addToEnvelope(qint64 first, qint64 last, float value) noexcept;
+    void estimateTempo() noexcept;
+    float envelopeAt(qint64 bin) const noexcept;
+
+    QVector<float> previousLeft, previousRight;
+    QVector<float> envelope;
+    qint64 envelopeEnd;
+    double position;
+    float fluxMean;
+    int beatLag;
+    qint64 lastBeatBin;
+};
+
+#endif // AUDIOANALYZER_HPP
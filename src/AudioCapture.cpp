@@ -0,0 +1,464 @@
+#include "AudioCapture.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <complex>
+
+#include <QtEndian>
+
+/**
+ * @brief AudioCapture::AudioCapture
+ * @param parent Parent object
+ *
+ * The device is opened by start(), on the thread the
+ * capture was moved to.
+ */
+AudioCapture::AudioCapture(QObject *parent) :
+    QObject(parent), input(0), active(true), windowFrames(0), decodeQueued(false), sequence(0),
+    currentStatus{QString(), 0, 0, 0, 0, 0, 0}, lastUploaded(-1)
+{
+    clock.start();
+}
+
+/**
+ * @brief AudioCapture::~AudioCapture
+ */
+AudioCapture::~AudioCapture(){
+    stop();
+}
+
+/**
+ * @brief AudioCapture::start
+ *
+ * Opens the input device or the audio file of the stored
+ * audio settings and starts capturing.
+ */
+void AudioCapture::start() noexcept{
+    if(input || file)
+        return;
+    auto settings = AudioSettings::load();
+
+    if(!settings.file.isEmpty()){
+        QAudioFormat raw;
+        raw.setCodec("audio/pcm");
+        raw.setByteOrder(QAudioFormat::LittleEndian);
+        raw.setSampleType(QAudioFormat::Float);
+        raw.setSampleSize(32);
+        raw.setSampleRate(settings.sampleRate);
+        raw.setChannelCount(settings.channels);
+        auto audioFile = std::make_shared<const AudioFile>(settings.file, raw);
+        if(audioFile->isValid()){
+            auto format = audioFile->format();
+            int frames = int(qMin<qint64>(settings.bufferFrames > 0 ? settings.bufferFrames : 1024,
+                                          audioFile->frames()));
+            QMutexLocker ringLock(&ringMutex);
+            file = audioFile;
+            windowFrames = frames;
+            aheadWindows = QList<qint64>() << 0;
+            if(!decodeQueued){
+                decodeQueued = true;
+                QMetaObject::invokeMethod(this, "decodeWindows", Qt::QueuedConnection);
+            }
+            QMutexLocker statusLock(&statusMutex);
+            currentStatus = {settings.file, format.sampleRate(), format.channelCount(), frames, frames, 0, 0};
+            return;
+        }
+        qWarning() << tr("Audio file cannot be read, using the device:") << settings.file;
+    }
+
+    analyzer.reset();
+    input = new AudioInputProcessor(settings, this);
+    connect(input, &AudioInputProcessor::processData, this, &AudioCapture::process);
+    input->start();
+    if(!active)
+        input->suspend();
+
+    auto format = input->format();
+    QMutexLocker lock(&statusMutex);
+    currentStatus = {input->deviceName(), format.sampleRate(), format.channelCount(),
+                     input->bufferFrames(), input->periodFrames(), 0, 0};
+}
+
+/**
+ * @brief AudioCapture::stop
+ *
+ * Closes the input device. Has to run on the capture's thread.
+ */
+void AudioCapture::stop() noexcept{
+    delete input;
+    input = 0;
+
+    {
+        QMutexLocker lock(&ringMutex);
+        file.reset();
+        aheadWindows.clear();
+        for(auto &block : ring)
+            block.reset();
+    }
+    QMutexLocker lock(&featureMutex);
+    analyzedFile.reset();
+    analyzedFeatures.clear();
+}
+
+/**
+ * @brief AudioCapture::restart
+ *
+ * Reopens the device after the audio settings changed.
+ */
+void AudioCapture::restart() noexcept{
+    stop();
+    start();
+}
+
+/**
+ * @brief AudioCapture::setActive
+ * @param active False while no renderer is running
+ *
+ * Suspends the device while nobody needs its data.
+ */
+void AudioCapture::setActive(bool active) noexcept{
+    this->active = active;
+    if(!input)
+        return;
+    if(active)
+        input->resume();
+    else
+        input->suspend();
+}
+
+/**
+ * @brief AudioCapture::latest
+ * @return The newest block, or null before the first one
+ *
+ * Safe to call from any thread.
+ */
+std::shared_ptr<const AudioBlock> AudioCapture::latest() const noexcept{
+    QMutexLocker lock(&ringMutex);
+    if(file)
+        return nullptr;
+    return sequence ? ring[(sequence - 1) % ringSize] : nullptr;
+}
+
+/**
+ * @brief AudioCapture::blockAt
+ * @param msecs Time of the frame that shows the block
+ * @return The window of the file that contains msecs, or
+ * latest() if there is no file
+ *
+ * A window that is not decoded ahead yet is decoded right
+ * away, so the result only depends on msecs. Safe to call
+ * from any thread.
+ */
+std::shared_ptr<const AudioBlock> AudioCapture::blockAt(qint64 msecs) const noexcept{
+    qint64 window;
+    {
+        QMutexLocker lock(&ringMutex);
+        if(!file)
+            return sequence ? ring[(sequence - 1) % ringSize] : nullptr;
+        window = qMax<qint64>(0, msecs) * file->format().sampleRate() / 1000 / windowFrames;
+
+        auto &next = ring[(window + 1) % ringSize];
+        if((!next || next->sequence != window + 1) && !aheadWindows.contains(window + 1)){
+            aheadWindows.append(window + 1);
+            if(!decodeQueued){
+                decodeQueued = true;
+                QMetaObject::invokeMethod(const_cast<AudioCapture *>(this), "decodeWindows", Qt::QueuedConnection);
+            }
+        }
+    }
+    return fileWindow(window);
+}
+
+/**
+ * @brief AudioCapture::decodeWindows
+ *
+ * Decodes the windows asked for ahead and the ones after each
+ * of them that are missing in the ring, up to half of the
+ * ring, so several renderers at different times all get
+ * theirs. Runs on the audio thread.
+ */
+void AudioCapture::decodeWindows() noexcept{
+    QList<qint64> firsts;
+    {
+        QMutexLocker lock(&ringMutex);
+        decodeQueued = false;
+        firsts.swap(aheadWindows);
+    }
+    for(auto first : firsts){
+        for(qint64 window = first; window < first + ringSize / 2; ++window)
+            fileWindow(window);
+    }
+}
+
+/**
+ * @brief AudioCapture::fileWindow
+ * @param window Index of a window of the file
+ * @return The window from the ring, decoded first if it is
+ * missing, or null if there is no file
+ *
+ * Decodes without holding the lock. Two threads may decode
+ * the same window at once; the first one stored is returned
+ * to both.
+ */
+std::shared_ptr<const AudioBlock> AudioCapture::fileWindow(qint64 window) const noexcept{
+    std::shared_ptr<const AudioFile> source;
+    int frames;
+    {
+        QMutexLocker lock(&ringMutex);
+        auto &slot = ring[window % ringSize];
+        if(slot && slot->sequence == window)
+            return slot;
+        if(!file)
+            return nullptr;
+        source = file;
+        frames = windowFrames;
+    }
+
+    auto block = decodeWindow(*source, frames, window);
+    block->features = fileFeatures(source, frames, *block);
+
+    QMutexLocker lock(&ringMutex);
+    auto &slot = ring[window % ringSize];
+    if(file != source)
+        return block;
+    if(!slot || slot->sequence != window)
+        slot = block;
+    return slot;
+}
+
+/**
+ * @brief AudioCapture::fileFeatures
+ * @param file The file the window belongs to
+ * @param windowFrames Frames per window
+ * @param block A decoded window, the file is looped
+ * @return The features of the window
+ *
+ * The analyzer needs the windows in order, so the ones before
+ * that are not analyzed yet are decoded for it first. Every
+ * window of the file is analyzed at most once.
+ */
+AudioFeatures AudioCapture::fileFeatures(const std::shared_ptr<const AudioFile> &file, int windowFrames,
+                                         const AudioBlock &block) const noexcept{
+    QMutexLocker lock(&featureMutex);
+    if(analyzedFile != file){
+        analyzedFile = file;
+        analyzedFeatures.clear();
+        fileAnalyzer.reset();
+    }
+    qint64 windows = (file->frames() + windowFrames - 1) / windowFrames;
+    int index = int(block.sequence % windows);
+    while(analyzedFeatures.size() < index)
+        analyzedFeatures.append(fileAnalyzer.analyze(*decodeWindow(*file, windowFrames, analyzedFeatures.size())));
+    if(analyzedFeatures.size() == index)
+        analyzedFeatures.append(fileAnalyzer.analyze(block));
+    return analyzedFeatures[index];
+}
+
+/**
+ * @brief AudioCapture::decodeWindow
+ * @param file An audio file
+ * @param windowFrames Frames per window
+ * @param window Index of the window, the file is looped
+ * @return The decoded window, without features
+ *
+ * The file starts over with the first window after the
+ * last one, which is filled up from the start of the file.
+ */
+std::shared_ptr<AudioBlock> AudioCapture::decodeWindow(const AudioFile &file, int windowFrames, qint64 window) noexcept{
+    qint64 windows = (file.frames() + windowFrames - 1) / windowFrames;
+    qint64 first = window % windows * windowFrames;
+    std::shared_ptr<AudioBlock> block;
+    if(first + windowFrames <= file.frames())
+        block = decode(file.frame(first), windowFrames, file.format());
+    else {
+        int bytes = file.format().bytesPerFrame();
+        QByteArray data(windowFrames * bytes, Qt::Uninitialized);
+        for(int i = 0; i < windowFrames; ++i)
+            memcpy(data.data() + i * bytes, file.frame((first + i) % file.frames()), bytes);
+        block = decode(data.constData(), windowFrames, file.format());
+    }
+    block->sequence = window;
+    block->captured = -1;
+    return block;
+}
+
+/**
+ * @brief AudioCapture::uploaded
+ * @param block A block a renderer just uploaded
+ *
+ * Measures the latency of the first upload of each block.
+ * Called by the render thread.
+ */
+void AudioCapture::uploaded(const AudioBlock &block) const noexcept{
+    if(block.captured < 0)
+        return;
+    double latency = (clock.nsecsElapsed() - block.captured) / 1e6;
+    if(block.sampleRate > 0)
+        latency += 1000.0 * block.left.size() / block.sampleRate;
+
+    QMutexLocker lock(&statusMutex);
+    if(block.sequence <= lastUploaded)
+        return;
+    lastUploaded = block.sequence;
+    auto &average = currentStatus.averageLatency;
+    average = average > 0 ? 0.9 * average + 0.1 * latency : latency;
+    currentStatus.worstLatency = qMax(currentStatus.worstLatency, latency);
+}
+
+/**
+ * @brief AudioCapture::status
+ * @return Format of the device and latency since the last call
+ *
+ * The worst latency starts over with every call.
+ */
+AudioStatus AudioCapture::status() const noexcept{
+    QMutexLocker lock(&statusMutex);
+    auto result = currentStatus;
+    currentStatus.worstLatency = 0;
+    return result;
+}
+
+/**
+ * @brief AudioCapture::process
+ * @param data Interleaved samples in the format of the device
+ *
+ * Decodes one block of the device and publishes it.
+ */
+void AudioCapture::process(QByteArray data) noexcept{
+    auto format = input->format();
+    if(format.bytesPerFrame() <= 0)
+        return;
+    int frames = data.size() / format.bytesPerFrame();
+    if(frames == 0)
+        return;
+
+    auto block = decode(data.constData(), frames, format);
+    block->captured = clock.nsecsElapsed();
+    block->features = analyzer.analyze(*block);
+    publish(block);
+}
+
+/**
+ * @brief AudioCapture::decode
+ * @param data Interleaved samples
+ * @param frames Number of frames in data
+ * @param format Format of data
+ * @return The converted and deinterleaved samples with their spectra
+ */
+std::shared_ptr<AudioBlock> AudioCapture::decode(const char *data, int frames, const QAudioFormat &format) noexcept{
+    int sampleBytes = format.sampleSize() / 8;
+    int channels = format.channelCount();
+
+    auto block = std::make_shared<AudioBlock>();
+    block->sampleRate = format.sampleRate();
+    block->left.resize(frames);
+    if(channels > 1)
+        block->right.resize(frames);
+
+    const char *frame = data;
+    for(int i = 0; i < frames; ++i, frame += sampleBytes * channels){
+        block->left[i] = sample(frame, format);
+        if(channels > 1)
+            block->right[i] = sample(frame + sampleBytes, format);
+    }
+
+    block->leftSpectrum = spectrum(block->left);
+    if(channels > 1)
+        block->rightSpectrum = spectrum(block->right);
+    else {
+        // Shared, not copied
+        block->right = block->left;
+        block->rightSpectrum = block->leftSpectrum;
+    }
+    return block;
+}
+
+/**
+ * @brief AudioCapture::publish
+ * @param block A block that is not changed anymore
+ */
+void AudioCapture::publish(std::shared_ptr<AudioBlock> block) noexcept{
+    QMutexLocker lock(&ringMutex);
+    block->sequence = sequence;
+    ring[sequence % ringSize] = block;
+    ++sequence;
+}
+
+/**
+ * @brief AudioCapture::sample
+ * @param data First byte of the sample
+ * @param format Format of the device
+ * @return The sample as float in [-1, 1]
+ */
+float AudioCapture::sample(const char *data, const QAudioFormat &format) noexcept{
+    auto bytes = reinterpret_cast<const uchar *>(data);
+    bool little = format.byteOrder() == QAudioFormat::LittleEndian;
+    switch(format.sampleSize()){
+    case 8:
+        if(format.sampleType() == QAudioFormat::UnSignedInt)
+            return (bytes[0] - 128) / 128.0f;
+        return qint8(bytes[0]) / 128.0f;
+    case 16: {
+        quint16 value = little ? qFromLittleEndian<quint16>(bytes) : qFromBigEndian<quint16>(bytes);
+        if(format.sampleType() == QAudioFormat::UnSignedInt)
+            return (int(value) - 32768) / 32768.0f;
+        return qint16(value) / 32768.0f;
+    }
+    case 32: {
+        quint32 value = little ? qFromLittleEndian<quint32>(bytes) : qFromBigEndian<quint32>(bytes);
+        if(format.sampleType() == QAudioFormat::Float){
+            float result;
+            memcpy(&result, &value, sizeof(result));
+            return result;
+        }
+        if(format.sampleType() == QAudioFormat::UnSignedInt)
+            return float((double(value) - 2147483648.0) / 2147483648.0);
+        return float(qint32(value) / 2147483648.0);
+    }
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief AudioCapture::spectrum
+ * @param samples Samples of one channel
+ * @return Magnitudes of the lower half of the spectrum
+ *
+ * A Hann-windowed radix-2 FFT over the largest power of two
+ * that fits into the block.
+ */
+QVector<float> AudioCapture::spectrum(const QVector<float> &samples) noexcept{
+    int size = 1;
+    while(size * 2 <= samples.size())
+        size *= 2;
+    if(size < 2)
+        return QVector<float>();
+
+    const float pi = 3.14159265358979f;
+    std::vector<std::complex<float>> values(size);
+    for(int i = 0, j = 0; i < size; ++i){
+        float window = 0.5f - 0.5f * std::cos(2 * pi * i / (size - 1));
+        values[j] = samples[i] * window;
+        // Bit reversed order
+        for(int bit = size >> 1; (j ^= bit) < bit; bit >>= 1);
+    }
+
+    for(int length = 2; length <= size; length <<= 1){
+        auto step = std::polar(1.0f, -2 * pi / length);
+        for(int start = 0; start < size; start += length){
+            std::complex<float> twiddle(1);
+            for(int k = 0; k < length / 2; ++k, twiddle *= step){
+                auto even = values[start + k];
+                auto odd = values[start + k + length / 2] * twiddle;
+                values[start + k] = even + odd;
+                values[start + k + length / 2] = even - odd;
+            }
+        }
+    }
+
+    QVector<float> magnitudes(size / 2);
+    for(int i = 0; i < size / 2; ++i)
+        magnitudes[i] = std::abs(values[i]) * 2 / size;
+    return magnitudes;
+}
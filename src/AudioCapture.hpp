@@ -0,0 +1,132 @@
+#ifndef AUDIOCAPTURE_HPP
+#define AUDIOCAPTURE_HPP
+
+#include <memory>
+
+#include <QObject>
+#include <QMutex>
+#include <QVector>
+#include <QElapsedTimer>
+
+#include "AudioInputProcessor.hpp"
+#include "AudioFile.hpp"
+#include "AudioAnalyzer.hpp"
+
+/**
+ * @brief The AudioBlock struct
+ *
+ * One block of captured audio, converted to float and split
+ * into channels, with the magnitude spectrum of each channel
+ * and its features.
+ * A published block is never changed again, so any number of
+ * renderers can upload straight from it.
+ */
+struct AudioBlock{
+    qint64 sequence;
+    // Nanoseconds on the clock of the capture, -1 if read from a file
+    qint64 captured;
+    int sampleRate;
+    QVector<float> left, right;
+    QVector<float> leftSpectrum, rightSpectrum;
+    AudioFeatures features;
+};
+
+/**
+ * @brief The AudioStatus struct
+ *
+ * The format the device actually runs with and the measured
+ * latency from capture to texture in milliseconds: the length
+ * of a block plus the time until a renderer uploaded it.
+ */
+struct AudioStatus{
+    QString device;
+    int sampleRate, channels, bufferFrames, periodFrames;
+    double averageLatency, worstLatency;
+};
+
+/**
+ * @brief The AudioCapture class
+ *
+ * The one audio capture of the application. It lives on an
+ * audio worker thread owned by the Backend, converts what
+ * the input device delivers and publishes the blocks into a
+ * ring that renderers read from on the render thread. Reading
+ * only copies a shared pointer, never samples.
+ *
+ * With an audio file set, no device is opened. The file is
+ * mapped and cut into windows of the buffer size. blockAt()
+ * decodes the window asked for if it is missing, without
+ * holding the lock, and the windows after the ones asked for
+ * are decoded ahead on the audio thread. The window only
+ * depends on the time asked for, so a frame rendered at the
+ * same time always sees the same samples.
+ * Features of live blocks are extracted as they arrive. The
+ * ones of a file are extracted in order when a window is
+ * decoded the first time, so a renderer that starts late
+ * in the file pays once for analyzing the windows before.
+ */
+class AudioCapture : public QObject{
+    Q_OBJECT
+public:
+    static const int ringSize = 16;
+
+    explicit AudioCapture(QObject *parent = 0);
+    ~AudioCapture();
+    std::shared_ptr<const AudioBlock> latest() const noexcept;
+    std::shared_ptr<const AudioBlock> blockAt(qint64 msecs) const noexcept;
+    void uploaded(const AudioBlock &block) const noexcept;
+    AudioStatus status() const noexcept;
+
+public Q_SLOTS:
+    void start() noexcept;
+    void stop() noexcept;
+    void restart() noexcept;
+    void setActive(bool active) noexcept;
+
+private Q_SLOTS:
+    void process(QByteArray data) noexcept;
+    void decodeWindows() noexcept;
+
+private:
+    AudioCapture(const AudioCapture &);
+    AudioCapture& operator=(const AudioCapture& rhs);
+
+    void publish(std::shared_ptr<AudioBlock> block) noexcept;
+    std::shared_ptr<const AudioBlock> fileWindow(qint64 window) const noexcept;
+    AudioFeatures fileFeatures(const std::shared_ptr<const AudioFile> &file, int windowFrames,
+                               const AudioBlock &block) const noexcept;
+    static std::shared_ptr<AudioBlock> decodeWindow(const AudioFile &file, int windowFrames, qint64 window) noexcept;
+    static std::shared_ptr<AudioBlock> decode(const char *data, int frames, const QAudioFormat &format) noexcept;
+    static float sample(const char *data, const QAudioFormat &format) noexcept;
+    static QVector<float> spectrum(const QVector<float> &samples) noexcept;
+
+    AudioInputProcessor *input;
+    bool active;
+    mutable QMutex ringMutex;
+    // Holds the decoded windows of the file instead while there is one
+    mutable std::shared_ptr<const AudioBlock> ring[ringSize];
+    // Only replaced on the audio thread, under the lock; readers
+    // decode from their own reference
+    std::shared_ptr<const AudioFile> file;
+    int windowFrames;
+    // Windows after the ones the renderers asked for, to be
+    // decoded ahead, and whether that is queued
+    mutable QList<qint64> aheadWindows;
+    mutable bool decodeQueued;
+    AudioAnalyzer analyzer;
+    // Features of the windows of analyzedFile up to the last one
+    // decoded, extracted in order by fileAnalyzer
+    mutable QMutex featureMutex;
+    mutable std::shared_ptr<const AudioFile> analyzedFile;
+    mutable QVector<AudioFeatures> analyzedFeatures;
+    mutable AudioAnalyzer fileAnalyzer;
+    qint64 sequence;
+    QElapsedTimer clock;
+
+    // Written by the audio and the render thread, read by the GUI
+    mutable QMutex statusMutex;
+    mutable AudioStatus currentStatus;
+    mutable qint64 lastUploaded;
+};
+
+#endif // AUDIOCAPTURE_HPP
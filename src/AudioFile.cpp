@@ -0,0 +1,120 @@
+#include "AudioFile.hpp"
+
+#include <cstring>
+
+#include <QtEndian>
+#include <QDebug>
+
+/**
+ * @brief AudioFile::AudioFile
+ * @param path File to map
+ * @param rawFormat Format of files without a WAV header
+ */
+AudioFile::AudioFile(const QString &path, const QAudioFormat &rawFormat) :
+    file(path), samples(0), frameCount(0)
+{
+    if(!file.open(QIODevice::ReadOnly)){
+        qWarning() << "Could not open audio file:" << path;
+        return;
+    }
+    auto data = file.map(0, file.size());
+    if(!data){
+        qWarning() << "Could not map audio file:" << path;
+        return;
+    }
+
+    if(file.size() >= 12 && !memcmp(data, "RIFF", 4) && !memcmp(data + 8, "WAVE", 4)){
+        if(!parseWav(data, file.size()))
+            qWarning() << "Unsupported WAV file:" << path;
+        return;
+    }
+
+    fileFormat = rawFormat;
+    if(fileFormat.bytesPerFrame() > 0){
+        samples = data;
+        frameCount = file.size() / fileFormat.bytesPerFrame();
+    }
+}
+
+/**
+ * @brief AudioFile::parseWav
+ * @param data Start of the mapping
+ * @param size Size of the mapping
+ * @return True if a format and data chunk were found
+ *
+ * Reads PCM and IEEE float files, also in the extensible
+ * variant. Other chunks are skipped.
+ */
+bool AudioFile::parseWav(const uchar *data, qint64 size) noexcept{
+    bool formatFound = false;
+    qint64 pos = 12;
+    while(pos + 8 <= size){
+        const uchar *chunk = data + pos;
+        qint64 chunkSize = qFromLittleEndian<quint32>(chunk + 4);
+        const uchar *body = chunk + 8;
+        chunkSize = qMin(chunkSize, size - pos - 8);
+
+        if(!memcmp(chunk, "fmt ", 4) && chunkSize >= 16){
+            int tag = qFromLittleEndian<quint16>(body);
+            if(tag == 0xFFFE && chunkSize >= 26)
+                tag = qFromLittleEndian<quint16>(body + 24);
+            int bits = qFromLittleEndian<quint16>(body + 14);
+            if(tag != 1 && tag != 3)
+                return false;
+
+            fileFormat.setCodec("audio/pcm");
+            fileFormat.setByteOrder(QAudioFormat::LittleEndian);
+            fileFormat.setChannelCount(qFromLittleEndian<quint16>(body + 2));
+            fileFormat.setSampleRate(qFromLittleEndian<quint32>(body + 4));
+            fileFormat.setSampleSize(bits);
+            if(tag == 3)
+                fileFormat.setSampleType(QAudioFormat::Float);
+            else
+                fileFormat.setSampleType(bits == 8 ? QAudioFormat::UnSignedInt : QAudioFormat::SignedInt);
+            formatFound = true;
+        } else if(!memcmp(chunk, "data", 4) && formatFound){
+            if(fileFormat.bytesPerFrame() <= 0)
+                return false;
+            samples = body;
+            frameCount = chunkSize / fileFormat.bytesPerFrame();
+            return true;
+        }
+
+        // Chunks are padded to an even size
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+    return false;
+}
+
+/**
+ * @brief AudioFile::isValid
+ * @return True if the file holds at least one frame
+ */
+bool AudioFile::isValid() const noexcept{
+    return frameCount > 0;
+}
+
+/**
+ * @brief AudioFile::format
+ * @return Format of the samples
+ */
+const QAudioFormat &AudioFile::format() const noexcept{
+    return fileFormat;
+}
+
+/**
+ * @brief AudioFile::frames
+ * @return Number of frames in the file
+ */
+qint64 AudioFile::frames() const noexcept{
+    return frameCount;
+}
+
+/**
+ * @brief AudioFile::frame
+ * @param index Frame in [0, frames())
+ * @return The first byte of the frame
+ */
+const char *AudioFile::frame(qint64 index) const noexcept{
+    return reinterpret_cast<const char *>(samples + index * fileFormat.bytesPerFrame());
+}
@@ -0,0 +1,35 @@
+#ifndef AUDIOFILE_HPP
+#define AUDIOFILE_HPP
+
+#include <QFile>
+#include <QAudioFormat>
+
+/**
+ * @brief The AudioFile class
+ *
+ * A WAV or raw PCM file mapped into memory. Nothing is read
+ * or decoded up front; frame() points right into the mapping.
+ * Files that do not start with a RIFF/WAVE header are taken
+ * as raw samples in rawFormat.
+ */
+class AudioFile{
+public:
+    AudioFile(const QString &path, const QAudioFormat &rawFormat);
+    bool isValid() const noexcept;
+    const QAudioFormat &format() const noexcept;
+    qint64 frames() const noexcept;
+    const char *frame(qint64 index) const noexcept;
+
+private:
+    AudioFile(const AudioFile &);
+    AudioFile& operator=(const AudioFile& rhs);
+
+    bool parseWav(const uchar *data, qint64 size) noexcept;
+
+    QFile file;
+    QAudioFormat fileFormat;
+    const uchar *samples;
+    qint64 frameCount;
+};
+
+#endif // AUDIOFILE_HPP
@@ -1,35 +1,83 @@
 #include "AudioInputProcessor.hpp"
+#include "SettingsBackend.hpp"
 
-AudioInputProcessor::AudioInputProcessor(QObject *parent) :
+/**
+ * @brief AudioSettings::load
+ * @return The audio settings of the application
+ */
+AudioSettings AudioSettings::load() noexcept{
+    AudioSettings settings;
+    settings.device = SettingsBackend::getSettingsFor("AudioDevice", QString()).toString();
+    settings.sampleRate = SettingsBackend::getSettingsFor("AudioSampleRate", 48000).toInt();
+    settings.channels = SettingsBackend::getSettingsFor("AudioChannels", 2).toInt();
+    settings.bufferFrames = SettingsBackend::getSettingsFor("AudioBufferFrames", 0).toInt();
+    settings.file = SettingsBackend::getSettingsFor("AudioFile", QString()).toString();
+    return settings;
+}
+
+/**
+ * @brief AudioSettings::save
+ *
+ * Stores the settings as the ones of the application.
+ */
+void AudioSettings::save() const noexcept{
+    SettingsBackend::addSettings("AudioDevice", device);
+    SettingsBackend::addSettings("AudioSampleRate", sampleRate);
+    SettingsBackend::addSettings("AudioChannels", channels);
+    SettingsBackend::addSettings("AudioBufferFrames", bufferFrames);
+    SettingsBackend::addSettings("AudioFile", file);
+}
+
+/**
+ * @brief AudioInputProcessor::AudioInputProcessor
+ * @param settings Device and format to ask for
+ * @param parent Parent object
+ *
+ * Opens the device with the requested format, or with the
+ * nearest one it supports, which is reported as a warning.
+ */
+AudioInputProcessor::AudioInputProcessor(const AudioSettings &settings, QObject *parent) :
     QIODevice(parent)
 {
     auto inputDevice = QAudioDeviceInfo::defaultInputDevice();
+    bool found = false;
     for(auto &dev : QAudioDeviceInfo::availableDevices(QAudio::AudioInput)){
-        if(dev.deviceName().contains("output", Qt::CaseInsensitive)){
+        if(!settings.device.isEmpty()){
+            if(dev.deviceName() == settings.device){
+                inputDevice = dev;
+                found = true;
+                break;
+            }
+        } else if(dev.deviceName().contains("output", Qt::CaseInsensitive)){
             inputDevice = dev;
             if(dev.deviceName().contains("analog", Qt::CaseInsensitive))
                 break;
         }
     }
+    if(!settings.device.isEmpty() && !found)
+        qWarning() << tr("Audio device not found, using the default:") << settings.device;
+    device = inputDevice.deviceName();
 
     QAudioFormat format;
 //    format.setByteOrder(QAudioFormat::LittleEndian);
-    format.setChannelCount(2);
+    format.setChannelCount(settings.channels);
     format.setCodec("audio/pcm");
-    format.setSampleRate(8000);
+    format.setSampleRate(settings.sampleRate);
     format.setSampleSize(32);
     format.setSampleType(QAudioFormat::Float);
 
     if(!inputDevice.isFormatSupported(format)){
-        qWarning() << tr("Format is not supported");
         format = inputDevice.nearestFormat(format);
-        qDebug() << tr("\tchannels:") << format.channelCount();
-        qDebug() << tr("\tsample rate:") << format.sampleRate();
-        qDebug() << tr("\tsample size:") << format.sampleSize();
-        qDebug() << tr("\tsample type:") << format.sampleType();
+        qWarning() << tr("Format is not supported, using the nearest one");
+        qWarning() << tr("\tchannels:") << format.channelCount();
+        qWarning() << tr("\tsample rate:") << format.sampleRate();
+        qWarning() << tr("\tsample size:") << format.sampleSize();
+        qWarning() << tr("\tsample type:") << format.sampleType();
     }
 
     input = std::unique_ptr<QAudioInput>(new QAudioInput(inputDevice, format, this));
+    if(settings.bufferFrames > 0)
+        input->setBufferSize(settings.bufferFrames * bytesPerFrame());
 }
 
 void AudioInputProcessor::start() noexcept
@@ -38,11 +86,63 @@ void AudioInputProcessor::start() noexcept
     input->start(this);
 }
 
+/**
+ * @brief AudioInputProcessor::suspend
+ *
+ * Stops delivering data but keeps the device open.
+ */
+void AudioInputProcessor::suspend() noexcept
+{
+    input->suspend();
+}
+
+/**
+ * @brief AudioInputProcessor::resume
+ *
+ * Continues delivering data after suspend().
+ */
+void AudioInputProcessor::resume() noexcept
+{
+    input->resume();
+}
+
 const QAudioFormat AudioInputProcessor::format() const noexcept
 {
     return input->format();
 }
 
+/**
+ * @brief AudioInputProcessor::deviceName
+ * @return Name of the device that was opened
+ */
+QString AudioInputProcessor::deviceName() const noexcept
+{
+    return device;
+}
+
+/**
+ * @brief AudioInputProcessor::bufferFrames
+ * @return Frames the device buffers, known once started
+ */
+int AudioInputProcessor::bufferFrames() const noexcept
+{
+    return input->bufferSize() / bytesPerFrame();
+}
+
+/**
+ * @brief AudioInputProcessor::periodFrames
+ * @return Frames the device delivers at once, known once started
+ */
+int AudioInputProcessor::periodFrames() const noexcept
+{
+    return input->periodSize() / bytesPerFrame();
+}
+
+int AudioInputProcessor::bytesPerFrame() const noexcept
+{
+    return qMax(1, input->format().bytesPerFrame());
+}
+
 qint64 AudioInputProcessor::readData(char *data, qint64 maxlen) noexcept
 {
     Q_UNUSED(data);
@@ -7,20 +7,48 @@
 #include <QDebug>
 #include <QAudioInput>
 
+/**
+ * @brief The AudioSettings struct
+ *
+ * What the capture asks the input device for. An empty
+ * device name picks the default device, zero buffer frames
+ * keep the buffer size of the device. A file replaces the
+ * device; raw files are read as float samples with the
+ * given rate and channels.
+ */
+struct AudioSettings{
+    QString device;
+    int sampleRate;
+    int channels;
+    int bufferFrames;
+    QString file;
+
+    static AudioSettings load() noexcept;
+    void save() const noexcept;
+};
+
 class AudioInputProcessor : public QIODevice
 {
     Q_OBJECT
 public:
-    explicit AudioInputProcessor(QObject *parent = 0);
+    explicit AudioInputProcessor(const AudioSettings &settings, QObject *parent = 0);
     void start() noexcept;
+    void suspend() noexcept;
+    void resume() noexcept;
     const QAudioFormat format() const noexcept;
+    QString deviceName() const noexcept;
+    int bufferFrames() const noexcept;
+    int periodFrames() const noexcept;
 
 Q_SIGNALS:
     void processData(QByteArray);
 
 
 private:
+    int bytesPerFrame() const noexcept;
+
     std::unique_ptr<QAudioInput> input;
+    QString device;
 //    QMutex dataAccess;
 //    char *data;
 
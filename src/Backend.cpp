@@ -10,28 +10,48 @@ using namespace Instances;
  * @param parent
  *
  * The constructor of the Backend class.
- * Initializes the editor window list and the thread list as well
- * as the settings backend.
+ * Initializes the editor window list, the render thread and
+ * the audio capture as well as the settings backend.
  */
-Backend::Backend(QObject *parent) : QObject(parent){
+Backend::Backend(QObject *parent) :
+    QObject(parent), settingsStore(SettingsBackend::globalName), audio(new AudioCapture())
+{
     QApplication::setStyle(SettingsBackend::getSettingsFor("Design", "").toString());
+    TextureCache::instance()->setCompression(SettingsBackend::getSettingsFor("CompressTextures", false).toBool());
+    connect(&renderThread, &RenderThread::released, this, &Backend::rendererReleased);
+    connect(&validatorThread, &ShaderValidatorThread::validated, this, &Backend::codeValidated);
+    // Diagnostics are emitted on the render thread
+    qRegisterMetaType<QList<ShaderDiagnostic>>("QList<ShaderDiagnostic>");
+    renderThread.start(QThread::HighPriority);
+
+    // The device is opened on the audio thread and stays
+    // suspended until a renderer runs
+    audio->moveToThread(&audioThread);
+    audioThread.start(QThread::HighPriority);
+    QMetaObject::invokeMethod(audio, "start", Qt::QueuedConnection);
+    updateAudioActivity();
 }
 
 /**
  * @brief Backend::~Backend
  *
  * The destructor of the Backend class.
- * Eliminates all the threads that were orphaned
- * when all the windows closed.
+ * Stops all the renderers that were orphaned
+ * when all the windows closed, the render thread and
+ * the audio capture. The settings store writes the
+ * settings that are not on disk yet last.
  */
 Backend::~Backend(){
-    for(auto &thread : threads.values()){
-        if(thread){
-            if(thread->isRunning())
-                thread->terminate();
-            thread.reset();
-        }
-    }
+    validatorThread.stop();
+    for(auto id : renderers.keys() + parkedRenderers.keys())
+        releaseRenderer(id);
+    renderThread.stop();
+    stoppingRenderers.clear();
+
+    QMetaObject::invokeMethod(audio, "stop", Qt::BlockingQueuedConnection);
+    audioThread.quit();
+    audioThread.wait();
+    delete audio;
 }
 
 /**
@@ -131,7 +151,7 @@ void Backend::instanceDestroyed(QObject *instance) noexcept
  * @param child
  *
  * Is called by one of the editor window instances;
- * removes the child from the list and closes the thread.
+ * removes the child from the list and stops its renderer.
  * Removes all the settings that belong to the current child.
  * BUG: When the settings of the next children are updated,
  *      the settings window will display the settings of the
@@ -152,7 +172,11 @@ bool Backend::removeInstance(int id, bool removeSettings) noexcept{
         instances[id]->deleteLater();
         instances.remove(id);
     }
-    terminateThread(id);
+    releaseRenderer(id);
+    validatorThread.forget(id);
+    runRevisions.remove(id);
+    failedValidations.remove(id);
+    models.remove(id);
     if(removeSettings && ids.size() > 1){
         SettingsBackend::removeSettings(id);
         ids.removeOne(id);
@@ -228,10 +252,14 @@ QHash<QString, QVariant> Backend::getSettings(int id) noexcept
  * @brief Backend::settingsWindowRequested
  * @param instance
  *
- * Creates a settings window instance.
+ * Creates a settings window instance. Changed audio
+ * settings reopen the audio device right away.
  */
 void Backend::settingsWindowRequested(IInstance *instance) noexcept{
-    SettingsWindow settingsWin(instance->ID);
+    SettingsWindow settingsWin(instance->ID, audio);
+    connect(&settingsWin, &SettingsWindow::audioSettingsChanged, this, [this](){
+        QMetaObject::invokeMethod(audio, "restart", Qt::QueuedConnection);
+    });
     settingsWin.exec();
 }
 
@@ -295,23 +323,84 @@ bool Backend::isLast() noexcept{
 
 /**
  * @brief Backend::instanceRunCode
+ * @param instance
+ * @param live True if the run follows an edit in live mode
  *
- * reacts to the run SIGNAL by running the code(duh) that is
- * in the editor at the moment.
+ * reacts to the run SIGNAL by validating the code that is
+ * in the editor at the moment; it is run once it passed,
+ * see codeValidated().
  */
-void Backend::instanceRunCode(IInstance *instance) noexcept
+void Backend::instanceRunCode(IInstance *instance, bool live) noexcept
 {
     auto id = instance->ID;
-    if(threads.contains(id)){
-        bool worked = threads[id]->updateCode(instance->vertexSourceCode(), instance->fragmentSourceCode());
-        if(!worked){
-            instances[id]->reportError(tr("Code is faulty."));
-        }
+    if(live)
+        liveRuns.insert(id);
+    else
+        liveRuns.remove(id);
+    validatorThread.request(id, ShaderValidatorThread::Request{
+                                instance->vertexSourceCode(), instance->fragmentSourceCode(),
+                                modelDirectory(id), includePaths(), ++runRevisions[id]});
+}
+
+/**
+ * @brief Backend::codeValidated
+ * @param id
+ * @param revision The run the code was validated for
+ * @param vertexSource
+ * @param fragmentSource
+ * @param result
+ *
+ * Reacts to the validator thread having checked the code of
+ * a run. Code without errors goes to the renderer of the
+ * instance, which is started if needed; otherwise the errors
+ * are reported and the renderer keeps its code. Live runs of
+ * code that expands to what the renderer runs, apart from
+ * comments and whitespace, are not handed over again; a run
+ * the user asked for always is, so a failed compile can be
+ * retried.
+ */
+void Backend::codeValidated(long id, int revision, QString vertexSource, QString fragmentSource,
+                            ShaderValidator::Result result) noexcept{
+    if(!instances.contains(id) || runRevisions.value(id) != revision)
+        return;
+    if(!result.ok()){
+        failedValidations.insert(id);
+        getVertexDiagnostics(id, result.vertex);
+        getFragmentDiagnostics(id, result.fragment);
+        return;
+    }
+    if(failedValidations.remove(id)){
+        getVertexDiagnostics(id, QList<ShaderDiagnostic>());
+        getFragmentDiagnostics(id, QList<ShaderDiagnostic>());
+    }
+
+    if(renderers.contains(id)){
+        if(liveRuns.contains(id) && runningHashes.value(id) == result.hash)
+            return;
+        queuedHashes.insert(id, result.hash);
+        renderers[id]->updateCode(vertexSource, fragmentSource);
     }else{
-        runGlFile(instance);
+        queuedHashes.insert(id, result.hash);
+        runGlFile(instances[id].get(), vertexSource, fragmentSource);
     }
 }
 
+/**
+ * @brief Backend::codeCompiled
+ * @param id
+ * @param ok True if the renderer runs the code it was handed
+ *
+ * Reacts to the renderer of an instance compiling its code. Only
+ * code that compiled counts as running; after a failure the same
+ * code is handed over again by the next run.
+ */
+void Backend::codeCompiled(long id, bool ok) noexcept{
+    if(ok && queuedHashes.contains(id))
+        runningHashes.insert(id, queuedHashes.take(id));
+    else if(!ok)
+        runningHashes.remove(id);
+}
+
 /**
  * @brief Backend::instanceStopCode
  * @param instance
@@ -321,7 +410,8 @@ void Backend::instanceRunCode(IInstance *instance) noexcept
  */
 void Backend::instanceStopCode(IInstance *instance) noexcept
 {
-    terminateThread(instance->ID);
+    ++runRevisions[instance->ID];
+    stopRenderer(instance->ID);
 }
 
 /**
@@ -399,76 +489,212 @@ void Backend::instanceRequestSettings(IInstance *instance, QHash<QString,
 void Backend::instanceLoadModel(IInstance *instance, const QString &file, const QVector3D &offset,
                                 const QVector3D &scaling, const QVector3D &rotation) noexcept
 {
-    if(threads.contains(instance->ID))
-        threads[instance->ID]->loadModel(file, offset, scaling, rotation);
+    models.insert(instance->ID, Model{file, offset, scaling, rotation});
+    applyModel(instance->ID);
+}
+
+/**
+ * @brief Backend::applyModel
+ * @param id
+ *
+ * Hands the model of an instance to its running renderer,
+ * unless the renderer has it already.
+ */
+void Backend::applyModel(long id) noexcept{
+    if(!renderers.contains(id) || !models.contains(id))
+        return;
+    auto &model = models[id];
+    if(loadedModels.contains(id) && loadedModels[id] == model)
+        return;
+    renderers[id]->loadModel(model.file, model.offset, model.scaling, model.rotation);
+    loadedModels.insert(id, model);
+}
+
+/**
+ * @brief Backend::modelDirectory
+ * @param id
+ * @return The directory quoted includes are also looked up in
+ *
+ * That is the directory of the model, like the renderer does.
+ */
+QString Backend::modelDirectory(long id) const noexcept{
+    QString file = models.value(id).file;
+    return file.isEmpty() ? QString() : QFileInfo(file).absolutePath();
 }
 
 /**
  * @brief Backend::runGlFile
- * @param filename
- * @param instructions
- * @param index
+ * @param instance
+ * @param vertexSource Validated vertex shader code
+ * @param fragmentSource Validated fragment shader code
  *
- * Creates a thread that executes GL source code.
+ * Reuses the parked renderer of the instance or creates one
+ * that executes GL source code, and hands it to the render thread.
  */
-void Backend::runGlFile(IInstance *instance) noexcept{
-    std::shared_ptr<GlLiveThread> thread(new GlLiveThread(instance->ID, this));
-    connect(thread.get(), &GlLiveThread::doneSignal,  this, &Backend::getExecutionResults);
-    connect(thread.get(), &GlLiveThread::errorSignal, this, &Backend::getError);
-    connect(thread.get(), &GlLiveThread::vertexError,   this, &Backend::getVertexError);
-    connect(thread.get(), &GlLiveThread::fragmentError, this, &Backend::getFragmentError);
-    auto runObj = new Renderer(instance->vertexSourceCode(), instance->fragmentSourceCode());
-    runObj->resize(800, 600);
-    runObj->show();
-    thread->initialize(runObj);
-    thread->start();
-    threads.insert(thread->ID, thread);
+void Backend::runGlFile(IInstance *instance, const QString &vertexSource, const QString &fragmentSource) noexcept{
+    auto id = instance->ID;
+    if(parkedRenderers.contains(id)){
+        auto renderer = parkedRenderers.take(id);
+        renderer->setIncludePaths(includePaths());
+        renderer->updateCode(vertexSource, fragmentSource);
+        renderer->setParked(false);
+        renderThread.add(renderer.get());
+        renderers.insert(id, renderer);
+        applyModel(id);
+        updateAudioActivity();
+        return;
+    }
+
+    // The renderer may still be delivering the event that stops it
+    std::shared_ptr<Renderer> renderer(new Renderer(vertexSource, fragmentSource),
+                                       [](Renderer *renderer){ renderer->deleteLater(); });
+    connect(renderer.get(), &Renderer::doneSignal, this, [=](QString msg){
+        getExecutionResults(id, msg);
+    });
+    connect(renderer.get(), &Renderer::errored, this, [=](QString msg){
+        getError(id, msg);
+    });
+    connect(renderer.get(), &Renderer::compiled, this, [=](bool ok){
+        codeCompiled(id, ok);
+    });
+    connect(renderer.get(), &Renderer::vertexDiagnostics, this, [=](QList<ShaderDiagnostic> diagnostics){
+        getVertexDiagnostics(id, diagnostics);
+    });
+    connect(renderer.get(), &Renderer::fragmentDiagnostics, this, [=](QList<ShaderDiagnostic> diagnostics){
+        getFragmentDiagnostics(id, diagnostics);
+    });
+    renderer->setAudioCapture(audio);
+    renderer->setIncludePaths(includePaths());
+    renderer->resize(800, 600);
+    renderer->show();
+    renderers.insert(id, renderer);
+    applyModel(id);
+    renderThread.add(renderer.get());
+    updateAudioActivity();
 }
 
 /**
  * @brief Backend::getExecutionResults
  *
- * reacts to the done SIGNAL by terminating the thread and
+ * reacts to the done SIGNAL by stopping the renderer and
  * emitting a showResults SIGNAL for the QWidgets to display
  */
-void Backend::getExecutionResults(GlLiveThread* thread, QString returnedException) noexcept{
-    // Already gone?
-    disconnect(thread, &GlLiveThread::doneSignal, this, &Backend::getExecutionResults);
-    instances[thread->ID]->reportWarning(returnedException);
-    terminateThread(thread->ID);
+void Backend::getExecutionResults(long id, QString returnedException) noexcept{
+    if(instances.contains(id))
+        instances[id]->reportWarning(returnedException);
+    stopRenderer(id);
 }
 
-void Backend::getError(GlLiveThread* thread, QString error) noexcept{
-    instances[thread->ID]->reportWarning(error);
+void Backend::getError(long id, QString error) noexcept{
+    if(instances.contains(id))
+        instances[id]->reportWarning(error);
 }
 
-void Backend::getVertexError(GlLiveThread* thread, QString error, int line) noexcept{
-    instances[thread->ID]->reportWarning(error);
-    if(line >= 0)
-        instances[thread->ID]->highlightErroredVertexLine(line);
+/**
+ * @brief Backend::getVertexDiagnostics
+ * @param id
+ * @param diagnostics All errors and warnings of one compile
+ *
+ * Reports the diagnostics to the instance, which marks those
+ * in its code. An empty list clears the marks.
+ */
+void Backend::getVertexDiagnostics(long id, const QList<ShaderDiagnostic> &diagnostics) noexcept{
+    if(!instances.contains(id))
+        return;
+    if(!diagnostics.isEmpty())
+        instances[id]->reportWarning(ShaderDiagnostics::format(diagnostics));
+    instances[id]->showVertexDiagnostics(diagnostics);
 }
 
-void Backend::getFragmentError(GlLiveThread* thread, QString error, int line) noexcept{
-    instances[thread->ID]->reportWarning(error);
-    if(line >= 0)
-        instances[thread->ID]->highlightErroredFragmentLine(line);
+/**
+ * @brief Backend::getFragmentDiagnostics
+ * @param id
+ * @param diagnostics All errors and warnings of one compile
+ *
+ * Like getVertexDiagnostics(), for the fragment shader.
+ */
+void Backend::getFragmentDiagnostics(long id, const QList<ShaderDiagnostic> &diagnostics) noexcept{
+    if(!instances.contains(id))
+        return;
+    if(!diagnostics.isEmpty())
+        instances[id]->reportWarning(ShaderDiagnostics::format(diagnostics));
+    instances[id]->showFragmentDiagnostics(diagnostics);
 }
 
 /**
- * @brief Backend::terminateThread
- * @param thread
+ * @brief Backend::stopRenderer
+ * @param id
  *
- * terminates a specific thread and deletes it from the list.
+ * Parks the renderer of an instance with its context and
+ * compiled program intact, so the next run of the instance
+ * can reuse it.
  */
-void Backend::terminateThread(long id) noexcept{
-    if(threads.contains(id)){
-        if(threads[id]->isRunning())
-            threads[id]->terminate();
-        threads[id]->wait();
-        threads[id]->deleteLater();
-        threads.remove(id);
-    }
+void Backend::stopRenderer(long id) noexcept{
+    if(!renderers.contains(id))
+        return;
+    auto renderer = renderers.take(id);
+    renderer->setParked(true);
+    renderThread.park(renderer.get());
+    parkedRenderers.insert(id, renderer);
+    if(instances.contains(id))
+        instances[id]->codeStopped();
+    updateAudioActivity();
+}
 
+/**
+ * @brief Backend::releaseRenderer
+ * @param id
+ *
+ * Asks the render thread to stop the renderer of an instance,
+ * running or parked. The renderer is kept until the render
+ * thread released its GL resources, see rendererReleased().
+ */
+void Backend::releaseRenderer(long id) noexcept{
+    std::shared_ptr<Renderer> renderer;
+    if(renderers.contains(id))
+        renderer = renderers.take(id);
+    else if(parkedRenderers.contains(id))
+        renderer = parkedRenderers.take(id);
+    else
+        return;
+    renderer->hide();
+    runningHashes.remove(id);
+    queuedHashes.remove(id);
+    liveRuns.remove(id);
+    loadedModels.remove(id);
+    stoppingRenderers.insert(renderer.get(), renderer);
+    renderThread.remove(renderer.get());
+    updateAudioActivity();
+}
+
+/**
+ * @brief Backend::updateAudioActivity
+ *
+ * Suspends the audio capture while no renderer is running.
+ */
+void Backend::updateAudioActivity() noexcept{
+    QMetaObject::invokeMethod(audio, "setActive", Qt::QueuedConnection,
+                              Q_ARG(bool, !renderers.isEmpty()));
+}
+
+/**
+ * @brief Backend::includePaths
+ * @return The directories shaders look up #include files in
+ */
+QStringList Backend::includePaths() noexcept{
+    return SettingsBackend::getSettingsFor("ShaderIncludePaths", QString()).toString()
+            .split(';', QString::SkipEmptyParts);
+}
+
+/**
+ * @brief Backend::rendererReleased
+ * @param renderer
+ *
+ * Reacts to the render thread having released a renderer
+ * by deleting it.
+ */
+void Backend::rendererReleased(Renderer *renderer) noexcept{
+    stoppingRenderers.remove(renderer);
 }
 
 /**
@@ -3,10 +3,15 @@
 
 #include <QDesktopServices>
 #include <QUrl>
+#include <QFileInfo>
+#include <QVector3D>
+#include <QSet>
 
 #include "SettingsBackend.hpp"
 #include "SettingsWindow.hpp"
-#include "LiveThread.hpp"
+#include "RenderThread.hpp"
+#include "ShaderValidatorThread.hpp"
+#include "AudioCapture.hpp"
 #include "Instances/IInstance.hpp"
 
 using namespace Instances;
@@ -18,8 +23,15 @@ using namespace Instances;
  * The heart and soul of the eidtors functionality.
  * Is connected to all the other parts of the application
  * (through SIGNALs as well as references) and keeps track
- * of all the windows and code evaluation threads that are created
- * and deleted.
+ * of all the windows and renderers that are created and deleted.
+ * All renderers are drawn by a single render thread it owns
+ * and share the audio capture it runs on an audio thread.
+ * Code that is run is validated on a validator thread first;
+ * code with errors never reaches a renderer, and code that
+ * differs from the running code only in comments or
+ * whitespace is not compiled again.
+ * The settings are cached by a store it owns, which writes
+ * them in batches in the background and once more at exit.
  */
 class Backend : public QObject
 {
@@ -55,7 +67,7 @@ public Q_SLOTS:
     void openHelp(IInstance *) noexcept;
     void instanceClosing(IInstance *) noexcept;
     void instanceDestroyed(QObject*) noexcept;
-    void instanceRunCode(IInstance *) noexcept;
+    void instanceRunCode(IInstance *, bool live) noexcept;
     void instanceStopCode(IInstance *) noexcept;
     void instanceChangedSetting(IInstance *, const QString &key, const QVariant &value) noexcept;
     void instanceRequestSetting(IInstance *, const QString &key, QVariant &value) noexcept;
@@ -64,19 +76,56 @@ public Q_SLOTS:
     void instanceLoadModel(IInstance*, const QString &, const QVector3D &, const QVector3D &, const QVector3D &) noexcept;
 //    void instanceRemoveID(IInstance *instance);
     void childSaidCloseAll() noexcept;
-    void getExecutionResults(GlLiveThread*, QString) noexcept;
+    void getExecutionResults(long, QString) noexcept;
 
-    void getError(GlLiveThread*, QString) noexcept;
-    void getVertexError(GlLiveThread*, QString, int) noexcept;
-    void getFragmentError(GlLiveThread*, QString, int) noexcept;
+    void getError(long, QString) noexcept;
+    void getVertexDiagnostics(long, const QList<ShaderDiagnostic> &) noexcept;
+    void getFragmentDiagnostics(long, const QList<ShaderDiagnostic> &) noexcept;
+    void codeValidated(long, int, QString, QString, ShaderValidator::Result) noexcept;
+    void codeCompiled(long, bool) noexcept;
+    void rendererReleased(Renderer *) noexcept;
 
 private:
-    void runGlFile(IInstance *) noexcept;
-    void terminateThread(long id) noexcept;
+    struct Model{
+        QString file;
+        QVector3D offset, scaling, rotation;
+
+        bool operator==(const Model &other) const noexcept{
+            return file == other.file && offset == other.offset
+                    && scaling == other.scaling && rotation == other.rotation;
+        }
+    };
+
+    void runGlFile(IInstance *, const QString &, const QString &) noexcept;
+    void applyModel(long id) noexcept;
+    QString modelDirectory(long id) const noexcept;
+    void stopRenderer(long id) noexcept;
+    void releaseRenderer(long id) noexcept;
     void saveIDs() noexcept;
+    void updateAudioActivity() noexcept;
+    static QStringList includePaths() noexcept;
+    // First, so it is destroyed, and written, last
+    SettingsStore settingsStore;
     QList<int> ids;
     QHash<long, std::shared_ptr<IInstance>> instances;
-    QHash<long, std::shared_ptr<LiveThread>> threads;
+    QHash<long, std::shared_ptr<Renderer>> renderers;
+    QHash<long, std::shared_ptr<Renderer>> parkedRenderers;
+    QHash<Renderer *, std::shared_ptr<Renderer>> stoppingRenderers;
+    RenderThread renderThread;
+    ShaderValidatorThread validatorThread;
+    // Results of older runs and of runs that were stopped are dropped
+    QHash<long, int> runRevisions;
+    // Hash of the code the renderer of an instance runs, and of
+    // the code it was handed and has not compiled yet
+    QHash<long, QByteArray> runningHashes, queuedHashes;
+    // Instances whose latest run follows an edit in live mode
+    QSet<long> liveRuns;
+    // Instances that show the errors of a failed validation
+    QSet<long> failedValidations;
+    // Models the instances asked for and the renderers have
+    QHash<long, Model> models, loadedModels;
+    QThread audioThread;
+    AudioCapture *audio;
 };
 
 #endif // BACKEND_HPP
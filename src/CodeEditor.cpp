@@ -1,5 +1,15 @@
 #include "CodeEditor.hpp"
 
+#include <memory>
+
+#include <QMenu>
+#include <QContextMenuEvent>
+
+// Pause in typing after which the code is parsed
+static const int parseDelay = 150;
+// Characters loadText() inserts per turn of the event loop
+static const int loadSliceSize = 1 << 16;
+
 /**
  * @brief CodeEditor::CodeEditor
  * @param parent
@@ -10,14 +20,27 @@
  * and connects slots and signals. Needs a highlighting
  * file.
  */
-CodeEditor::CodeEditor(QWidget *parent) : QPlainTextEdit(parent){
+CodeEditor::CodeEditor(QWidget *parent) :
+    QPlainTextEdit(parent), digitWidth(0), gutterDigits(0), gutterWidth(0), parseRevision(0), loadedLength(0)
+{
     lineHighlighting = new LineHighlighting(this);
     syntaxEngine = new CodeHighlighter(this->document());
+    parserThread = new GlslParserThread(this);
+
+    parseTimer.setSingleShot(true);
+    parseTimer.setInterval(parseDelay);
+    connect(document(), &QTextDocument::contentsChanged, &parseTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(&parseTimer, &QTimer::timeout, this, &CodeEditor::requestParse);
+    connect(parserThread, &GlslParserThread::parsed, this, &CodeEditor::showParseResult);
+
+    loadTimer.setInterval(0);
+    connect(&loadTimer, &QTimer::timeout, this, &CodeEditor::loadSlice);
 
     connect(this, &CodeEditor::blockCountChanged, this, &CodeEditor::updatelineHighlightingWidth);
     connect(this, &CodeEditor::updateRequest, this, &CodeEditor::updatelineHighlighting);
     connect(this, &CodeEditor::cursorPositionChanged, this, &CodeEditor::highlightCurrentLine);
 
+    updateDigitAtlas();
     updatelineHighlightingWidth();
     highlightCurrentLine();
 
@@ -26,16 +49,114 @@ CodeEditor::CodeEditor(QWidget *parent) : QPlainTextEdit(parent){
     font.setBold(true);
     font.setStyleStrategy(QFont::PreferAntialias);
     setFont(font);
+
+    updateVisibleBlocks();
+}
+
+/**
+ * @brief CodeEditor::updateVisibleBlocks
+ *
+ * Tells the syntax highlighter which blocks to format first.
+ * Assumes a line per block, so wrapped blocks make the range
+ * larger than the viewport, never smaller.
+ */
+void CodeEditor::updateVisibleBlocks() noexcept{
+    int first = firstVisibleBlock().blockNumber();
+    int lines = viewport()->height() / qMax(1, fontMetrics().height());
+    syntaxEngine->setVisibleBlocks(qMax(0, first), qMax(0, first) + lines + 1);
+}
+
+/**
+ * @brief CodeEditor::loadText
+ * @param text The code of a file
+ *
+ * Replaces the code. Text of more than one slice is inserted
+ * slice by slice; meanwhile the editor is read-only and the
+ * highlighter is detached, so it formats the document once
+ * at the end. textLoaded() is emitted when the code is
+ * complete, which happens right away for small texts. The
+ * document is unmodified and has no undo history after.
+ */
+void CodeEditor::loadText(const QString &text) noexcept{
+    loadTimer.stop();
+    if(text.size() <= loadSliceSize){
+        if(isLoading()){
+            loadingText.clear();
+            setReadOnly(false);
+            syntaxEngine->setDocument(document());
+            document()->setUndoRedoEnabled(true);
+        }
+        setPlainText(text);
+        Q_EMIT textLoaded();
+        return;
+    }
+
+    if(!isLoading()){
+        setReadOnly(true);
+        syntaxEngine->setDocument(0);
+        document()->setUndoRedoEnabled(false);
+    }
+    clear();
+    loadingText = text;
+    loadedLength = 0;
+    loadSlice();
+    loadTimer.start();
+}
+
+/**
+ * @brief CodeEditor::isLoading
+ * @return True while loadText() has not inserted all of the code
+ */
+bool CodeEditor::isLoading() const noexcept{
+    return !loadingText.isNull();
+}
+
+/**
+ * @brief CodeEditor::loadSlice
+ *
+ * Appends the next slice of the loading text and finishes
+ * loading after the last one(SLOT).
+ */
+void CodeEditor::loadSlice() noexcept{
+    if(!isLoading()){
+        loadTimer.stop();
+        return;
+    }
+    QTextCursor cursor(document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.insertText(loadingText.mid(loadedLength, loadSliceSize));
+    loadedLength += loadSliceSize;
+    if(loadedLength < loadingText.size())
+        return;
+
+    loadTimer.stop();
+    loadingText = QString();
+    setReadOnly(false);
+    document()->setUndoRedoEnabled(true);
+    document()->setModified(false);
+    syntaxEngine->setDocument(document());
+    setTextCursor(QTextCursor(document()));
+    highlightCurrentLine();
+    Q_EMIT textLoaded();
 }
 
 /**
  * @brief CodeEditor::lineHighlightingWidth
  * @return the width of the line to be highlighted
  *
- * Helper function that computes the width of the line that is
- * to be highlighted.
+ * The width as of the last change of the number of digits.
  */
 int CodeEditor::lineHighlightingWidth() noexcept{
+    return gutterWidth;
+}
+
+/**
+ * @brief CodeEditor::updatelineHighlightingWidth
+ *
+ * sets the highlighting whenever the block count changes, if
+ * the line numbers got a digit more or less(SLOT)
+ */
+void CodeEditor::updatelineHighlightingWidth() noexcept{
     auto digits = 1,
     maxLen = qMax(1, blockCount());
     //computes how many blocks we have
@@ -43,19 +164,57 @@ int CodeEditor::lineHighlightingWidth() noexcept{
         maxLen /= 10;
         ++digits;
     }
-    //computes the width with respect to the font
-    auto space = 3 + fontMetrics().width(QLatin1Char('9')) * digits;
+    if(digits == gutterDigits)
+        return;
+    gutterDigits = digits;
+    gutterWidth = 3 + digitWidth * digits;
 
-    return space;
+    setViewportMargins(gutterWidth, 0, 0, 0);
+    QRect rect = contentsRect();
+    lineHighlighting->setGeometry(QRect(rect.left(), rect.top(), gutterWidth, rect.height()));
 }
 
 /**
- * @brief CodeEditor::updatelineHighlightingWidth
+ * @brief CodeEditor::updateDigitAtlas
  *
- * sets the highlighting whenever the block count changes(SLOT)
+ * Renders the digits side by side into a pixmap, each in a
+ * cell of the width of the widest digit. Its resolution is
+ * the one of the screen the gutter is on.
  */
-void CodeEditor::updatelineHighlightingWidth() noexcept{
-    setViewportMargins(lineHighlightingWidth(), 0, 0, 0);
+void CodeEditor::updateDigitAtlas() noexcept{
+    auto metrics = fontMetrics();
+    digitWidth = 0;
+    for(char digit = '0'; digit <= '9'; ++digit)
+        digitWidth = qMax(digitWidth, metrics.width(QLatin1Char(digit)));
+
+    qreal ratio = lineHighlighting->devicePixelRatio();
+    digitAtlas = QPixmap(QSize(digitWidth * 10, metrics.height()) * ratio);
+    digitAtlas.setDevicePixelRatio(ratio);
+    digitAtlas.fill(Qt::transparent);
+
+    QPainter painter(&digitAtlas);
+    painter.setFont(font());
+    painter.setPen(Qt::black);
+    for(int digit = 0; digit < 10; ++digit)
+        painter.drawText(QRect(digit * digitWidth, 0, digitWidth, metrics.height()),
+                         Qt::AlignCenter, QString::number(digit));
+}
+
+/**
+ * @brief CodeEditor::changeEvent
+ * @param e
+ *
+ * renders the digits of the line numbers again when the
+ * font changes.
+ */
+void CodeEditor::changeEvent(QEvent *e) noexcept{
+    QPlainTextEdit::changeEvent(e);
+    if(e->type() != QEvent::FontChange)
+        return;
+    updateDigitAtlas();
+    gutterDigits = 0;
+    updatelineHighlightingWidth();
+    lineHighlighting->update();
 }
 
 /**
@@ -67,13 +226,16 @@ void CodeEditor::updatelineHighlightingWidth() noexcept{
  * is requested(SLOT)
  */
 void CodeEditor::updatelineHighlighting(const QRect &rect, int delta_y) noexcept{
+    // Requests narrower than the viewport are the cursor
+    // blinking or a selection; they never move a line
     if(delta_y)
         lineHighlighting->scroll(0, delta_y);
-    else
+    else if(rect.width() >= viewport()->width())
         lineHighlighting->update(0, rect.y(), lineHighlighting->width(), rect.height());
+    else
+        return;
 
-    if(rect.contains(viewport()->rect()))
-        updatelineHighlightingWidth();
+    updateVisibleBlocks();
 }
 
 
@@ -88,6 +250,7 @@ void CodeEditor::resizeEvent(QResizeEvent *e) noexcept{
 
     QRect rect = contentsRect();
     lineHighlighting->setGeometry(QRect(rect.left(), rect.top(), lineHighlightingWidth(), rect.height()));
+    updateVisibleBlocks();
 }
 
 /**
@@ -109,7 +272,7 @@ void CodeEditor::highlightCurrentLine() noexcept{
         selection.cursor.clearSelection();
         QList<QTextEdit::ExtraSelection> selections;
         selections.append(selection);
-        setExtraSelections(selections);
+        setExtraSelections(selections + diagnosticSelections + syntaxSelections);
     }
 }
 
@@ -118,9 +281,16 @@ void CodeEditor::highlightCurrentLine() noexcept{
  * @param event
  *
  * updates the line highlighting whenever scrolling happens;
- * invoked from updateLineHighlighting().
+ * invoked from updateLineHighlighting(). Only the blocks in
+ * the rect of the event are painted, digit by digit from
+ * the atlas.
  */
 void CodeEditor::lineHighlightingPaintEvent(QPaintEvent *event) noexcept{
+    if(digitAtlas.devicePixelRatio() != lineHighlighting->devicePixelRatio())
+        updateDigitAtlas();
+    qreal ratio = digitAtlas.devicePixelRatio();
+    int digitHeight = qRound(digitAtlas.height() / ratio);
+
     //computes first and last block numbers
     auto textBlock = firstVisibleBlock();
     auto textBlockNum = textBlock.blockNumber();
@@ -133,12 +303,16 @@ void CodeEditor::lineHighlightingPaintEvent(QPaintEvent *event) noexcept{
 
     //sets the numbers for all the lines visible
     while(textBlock.isValid() && top <= event->rect().bottom()){
-        //sets line num starting for current line
+        //sets line num starting for current line, last digit first
         if(textBlock.isVisible() && bottom >= event->rect().top()){
-            auto num = QString::number(textBlockNum + 1);
-            painter.setPen(Qt::black);
-            painter.drawText(0, top, lineHighlighting->width(), fontMetrics().height(),
-                            Qt::AlignRight, num);
+            auto x = lineHighlighting->width();
+            auto num = textBlockNum + 1;
+            do{
+                x -= digitWidth;
+                painter.drawPixmap(QRectF(x, top, digitWidth, digitHeight), digitAtlas,
+                                   QRectF(num % 10 * digitWidth * ratio, 0, digitWidth * ratio, digitAtlas.height()));
+                num /= 10;
+            }while(num);
         }
 
         //selects next line and computes its' numbers
@@ -174,15 +348,173 @@ void CodeEditor::highlightErroredLine(int lineno) noexcept{
 
 }
 
+/**
+ * @brief CodeEditor::showDiagnostics
+ * @param diagnostics
+ *
+ * highlights the lines of all diagnostics in this code, errors
+ * in red and warnings in yellow, and moves the cursor to the
+ * first one. The marks follow edits until the next call; an
+ * empty list clears them.
+ */
+void CodeEditor::showDiagnostics(const QList<ShaderDiagnostic> &diagnostics) noexcept{
+    diagnosticSelections.clear();
+    QTextCursor first;
+    for(auto &diagnostic : diagnostics){
+        // Lines of included files are not in this document
+        if(!diagnostic.file.isEmpty() || diagnostic.line < 1 || diagnostic.line > blockCount())
+            continue;
+
+        QTextEdit::ExtraSelection selection;
+        auto lineColor = diagnostic.severity == ShaderDiagnostic::Error ? QColor(Qt::red).lighter(180)
+                                                                        : QColor(Qt::yellow).lighter(160);
+        selection.format.setProperty(QTextFormat::FullWidthSelection, true);
+        selection.format.setBackground(lineColor);
+        selection.cursor = QTextCursor(document()->findBlockByLineNumber(diagnostic.line - 1));
+        diagnosticSelections.append(selection);
+
+        if(first.isNull() && diagnostic.severity == ShaderDiagnostic::Error)
+            first = selection.cursor;
+    }
+
+    if(!first.isNull()){
+        first.movePosition(QTextCursor::EndOfLine);
+        setTextCursor(first);
+    }
+    highlightCurrentLine();
+}
+
+/**
+ * @brief CodeEditor::parseResult
+ * @return Symbols and syntax errors of the last parse
+ */
+const GlslParseResult &CodeEditor::parseResult() const noexcept{
+    return parseResultValue;
+}
+
+/**
+ * @brief CodeEditor::requestParse
+ *
+ * Hands the current code to the parser thread(SLOT).
+ */
+void CodeEditor::requestParse() noexcept{
+    parserThread->request(toPlainText(), ++parseRevision);
+}
+
+/**
+ * @brief CodeEditor::showParseResult
+ * @param revision
+ * @param result
+ *
+ * Takes the symbols and underlines the syntax errors and
+ * warnings of a parse, unless the code changed since it was
+ * requested(SLOT).
+ */
+void CodeEditor::showParseResult(int revision, GlslParseResult result) noexcept{
+    if(revision != parseRevision)
+        return;
+    parseResultValue = result;
+
+    syntaxSelections.clear();
+    for(auto &error : result.errors){
+        if(error.line < 1 || error.line > blockCount())
+            continue;
+        QTextEdit::ExtraSelection selection;
+        selection.format.setUnderlineStyle(QTextCharFormat::WaveUnderline);
+        selection.format.setUnderlineColor(error.severity == ShaderDiagnostic::Error ? Qt::red : Qt::darkYellow);
+        auto block = document()->findBlockByLineNumber(error.line - 1);
+        selection.cursor = QTextCursor(block);
+        selection.cursor.setPosition(block.position() + qBound(0, error.column - 1, qMax(0, block.length() - 2)));
+        selection.cursor.movePosition(QTextCursor::NextCharacter, QTextCursor::KeepAnchor);
+        syntaxSelections.append(selection);
+    }
+    highlightCurrentLine();
+    Q_EMIT parsed();
+}
+
+/**
+ * @brief CodeEditor::goToDefinition
+ * @return True if the word at the cursor is a known symbol
+ *
+ * Moves the cursor to the declaration of the word at the cursor.
+ */
+bool CodeEditor::goToDefinition() noexcept{
+    auto cursor = textCursor();
+    cursor.select(QTextCursor::WordUnderCursor);
+    auto symbol = parseResultValue.find(cursor.selectedText());
+    return symbol && goToLine(symbol->line, symbol->column);
+}
+
+/**
+ * @brief CodeEditor::goToLine
+ * @param line Line, counted from one
+ * @param column Column, counted from one
+ * @return False if there is no such line
+ */
+bool CodeEditor::goToLine(int line, int column) noexcept{
+    auto block = document()->findBlockByLineNumber(line - 1);
+    if(!block.isValid())
+        return false;
+    QTextCursor cursor(block);
+    cursor.setPosition(block.position() + qBound(0, column - 1, block.length() - 1));
+    setTextCursor(cursor);
+    centerCursor();
+    return true;
+}
+
+/**
+ * @brief CodeEditor::contextMenuEvent
+ * @param e
+ *
+ * adds go to definition and an outline of the functions,
+ * types and resources of the code to the standard menu.
+ */
+void CodeEditor::contextMenuEvent(QContextMenuEvent *e) noexcept{
+    std::unique_ptr<QMenu> menu(createStandardContextMenu());
+    menu->addSeparator();
+
+    auto cursor = cursorForPosition(e->pos());
+    cursor.select(QTextCursor::WordUnderCursor);
+    auto definition = menu->addAction(tr("Go to Definition"));
+    definition->setShortcut(QKeySequence(Qt::Key_F12));
+    definition->setEnabled(parseResultValue.find(cursor.selectedText()) != 0);
+    connect(definition, &QAction::triggered, [=](){
+        setTextCursor(cursor);
+        goToDefinition();
+    });
+
+    auto outline = menu->addMenu(tr("Outline"));
+    for(auto &symbol : parseResultValue.symbols){
+        if(symbol.kind != GlslSymbol::Function && symbol.kind != GlslSymbol::Struct
+                && symbol.kind != GlslSymbol::UniformBlock && symbol.kind != GlslSymbol::Texture
+                && symbol.kind != GlslSymbol::Video && symbol.kind != GlslSymbol::Include)
+            continue;
+        QString text = symbol.kind == GlslSymbol::Function ? symbol.detail : symbol.name;
+        int line = symbol.line, column = symbol.column;
+        auto action = outline->addAction(QString("%1\t%2").arg(text).arg(line));
+        connect(action, &QAction::triggered, [=](){
+            goToLine(line, column);
+        });
+    }
+    outline->setEnabled(!outline->isEmpty());
+
+    menu->exec(e->globalPos());
+}
+
 /**
  * @brief CodeEditor::keyPressEvent
  * @param e
  *
  * intercepts the keyPressEvent e so that a tab is rendered
- * as 4 spaces.
+ * as 4 spaces and F12 goes to the definition of the word at
+ * the cursor.
  */
 void CodeEditor::keyPressEvent(QKeyEvent *e) noexcept{
-    if(e->key() == Qt::Key_Tab){
+    if(e->key() == Qt::Key_F12){
+        goToDefinition();
+        e->accept();
+    }
+    else if(e->key() == Qt::Key_Tab){
         insertPlainText("    ");
         e->accept();
     }
@@ -3,8 +3,11 @@
 
 #include <QPlainTextEdit>
 #include <QPainter>
+#include <QTimer>
 
 #include "CodeHighlighter.hpp"
+#include "ShaderDiagnostics.hpp"
+#include "GlslParserThread.hpp"
 
 class LineHighlighting;
 
@@ -16,6 +19,20 @@ class LineHighlighting;
  * A subclass of QPlainTextEdit that is optimized for code;
  * with Syntax Highlighting, line numbers and highlighting of
  * the current line.
+ *
+ * A moment after each edit the code is parsed on a
+ * GlslParserThread. Its symbols feed the outline in the
+ * context menu and go to definition (F12), its syntax errors
+ * are underlined before the code is ever compiled.
+ *
+ * Large files are filled in with loadText() a slice per turn
+ * of the event loop, without highlighting and undo history,
+ * so the window stays responsive while a file loads.
+ *
+ * Line numbers are copied out of a pixmap that holds the ten
+ * digits, rendered once per font. The gutter only repaints
+ * what scrolled in or changed, and it only resizes when the
+ * number of digits of the line count does.
  */
 class CodeEditor : public QPlainTextEdit{
     Q_OBJECT
@@ -25,20 +42,50 @@ public:
     void lineHighlightingPaintEvent(QPaintEvent *event) noexcept;
     int lineHighlightingWidth() noexcept;
     void highlightErroredLine(int) noexcept;
+    void showDiagnostics(const QList<ShaderDiagnostic> &) noexcept;
     void setHighlighting(int highlighting) noexcept;
+    const GlslParseResult &parseResult() const noexcept;
+    bool goToDefinition() noexcept;
+    bool goToLine(int line, int column = 1) noexcept;
+    void loadText(const QString &text) noexcept;
+    bool isLoading() const noexcept;
+
+Q_SIGNALS:
+    void parsed();
+    void textLoaded();
 
 protected:
     void resizeEvent(QResizeEvent *event) noexcept;
+    void changeEvent(QEvent *event) noexcept;
     void keyPressEvent(QKeyEvent *e) noexcept;
+    void contextMenuEvent(QContextMenuEvent *e) noexcept;
 
 private Q_SLOTS:
     void updatelineHighlightingWidth() noexcept;
     void highlightCurrentLine() noexcept;
     void updatelineHighlighting(const QRect &, int) noexcept;
+    void updateVisibleBlocks() noexcept;
+    void requestParse() noexcept;
+    void showParseResult(int revision, GlslParseResult result) noexcept;
+    void loadSlice() noexcept;
 
 private:
+    void updateDigitAtlas() noexcept;
+
     QWidget *lineHighlighting;
+    QPixmap digitAtlas;
+    int digitWidth, gutterDigits, gutterWidth;
     CodeHighlighter *syntaxEngine;
+    QList<QTextEdit::ExtraSelection> diagnosticSelections, syntaxSelections;
+
+    GlslParserThread *parserThread;
+    QTimer parseTimer;
+    int parseRevision;
+    GlslParseResult parseResultValue;
+
+    QTimer loadTimer;
+    QString loadingText;
+    int loadedLength;
 };
 
 
@@ -1,156 +1,157 @@
 #include "CodeHighlighter.hpp"
 
+#include <QElapsedTimer>
+#include <climits>
+
+// Idle time spent on pending blocks at once
+static const int sliceMsecs = 8;
+
+/**
+ * @brief The PendingBlock struct
+ *
+ * Marks a block whose state is known, but which is not
+ * formatted yet.
+ */
+struct PendingBlock : public QTextBlockUserData{ };
+
 /**
  * @brief CodeHighlighter::CodeHighlighter
  * @param parent
  * @param file
  *
  * The constructor of the syntax highlighter.
- * Needs a highlighting file.
+ * Needs a highlighting file. Formats all blocks right away
+ * until the visible ones are set.
  */
-CodeHighlighter::CodeHighlighter(QTextDocument *parent) : QSyntaxHighlighter(parent){
+CodeHighlighter::CodeHighlighter(QTextDocument *parent) :
+    QSyntaxHighlighter(parent),
+    firstVisible(0), lastVisible(INT_MAX), pendingFrom(INT_MAX), forceFormat(false)
+{
+    pendingTimer.setSingleShot(true);
+    pendingTimer.setInterval(0);
+    connect(&pendingTimer, &QTimer::timeout, this, &CodeHighlighter::highlightPending);
     setupHighlighting();
 }
 
+/**
+ * @brief CodeHighlighter::setVisibleBlocks
+ * @param first Number of the first visible block
+ * @param last Number of the last visible block
+ *
+ * Pending blocks in the range are formatted first, as soon
+ * as the event loop runs.
+ */
+void CodeHighlighter::setVisibleBlocks(int first, int last) noexcept{
+    if(first == firstVisible && last == lastVisible)
+        return;
+    firstVisible = first;
+    lastVisible = last;
+    if(pendingFrom != INT_MAX)
+        pendingTimer.start();
+}
+
+/**
+ * @brief CodeHighlighter::hasPendingBlocks
+ * @return True while some blocks wait to be formatted
+ */
+bool CodeHighlighter::hasPendingBlocks() const noexcept{
+    return pendingFrom != INT_MAX;
+}
+
 /**
  * @brief CodeHighlighter::setupHighlighting
- * @param file
  *
- * Sets up the highlighting rules.
- * TODO: Make it more flexible - File format?
+ * Sets up the keywords and the formats of the tokens.
  * TODO: Highlight bracket-pairs
- * TODO: Build quot-pairs ( "bla " bla " bla " -> all is highlighted)
- * TODO: don't let the multi line comment trust preview format (see function highlightBlock(...) )
  */
 void CodeHighlighter::setupHighlighting() noexcept{
     QFile highlighting;
     highlighting.setFileName(":/rc/highlighting/glsl");
     highlighting.open(QFile::ReadOnly | QFile::Text);
-    Rule rule;
-    Rules.clear();
-
-    // Keyword
-    rule.format.setForeground(Qt::blue); // rule.format already freshly initialized
-//    rule.format.setFontWeight(QFont::Bold);
-    QStringList keywordPatterns;
-    auto keywords = QTextStream(&highlighting).readAll();
-    for(auto in: keywords.split("\n")){
-        if(in != "")
-            keywordPatterns << in;
-    }
-    for(auto &pattern: keywordPatterns){
-        rule.pattern = QRegExp(pattern);
-        Rules.append(rule);
-    }
 
-    // Branch
-    rule.format = QTextCharFormat();
-    rule.format.setForeground(Qt::blue);
-
-    rule.pattern = QRegExp("\\b(for(each)?|while|if|else)\\s*(?=\\()");
-    Rules.append(rule);
-
-    rule.pattern = QRegExp("\\bdo\\s*(?=\\{)");
-    Rules.append(rule);
-
-
-    // Digits
-    rule.format = QTextCharFormat();
-    rule.format.setForeground(QColor(255, 128, 0));
-    rule.pattern = QRegExp("\\b[0-9]+|[0-9]*\\.[0-9]+\\b");
-    Rules.append(rule);
-
-    auto filename = QFileInfo(highlighting.fileName()).fileName();
-
-    // Single line comment
-    rule.format = QTextCharFormat();
-    rule.format.setForeground(Qt::darkGreen);
-    rule.pattern = QRegExp("//.*$");
-    Rules.append(rule);
-
-    // Multi line comment
-    // rule.format is already comment
-    multiLineCommentNotation = rule.format; // needed for later highlight
-    //work in progress; make for more elaborate matching
-    //commentStartExpression = QRegExp("[^/(//[^\\r\\n]+)]?/\\*");
-    commentStartExpression = QRegExp("/\\*");
-    commentEndExpression = QRegExp("\\*/");
-
-    // Directive
-    rule.format = QTextCharFormat();
-    rule.format.setForeground(Qt::darkMagenta);
-    //highlight the whole line provided theres a # at the beginning
-    rule.pattern = QRegExp("^\\s*#.*$");
-    Rules.append(rule);
-
-    // GL
-    rule.format = QTextCharFormat();
-    //rule.format.setFontWeight(QFont::Bold);
-    rule.format.setForeground(Qt::darkCyan);
-    rule.pattern = QRegExp("\\b(GL|gl)(_)?[A-Za-z]+\\b");
-    Rules.append(rule);
-
-    // Quotation
-    rule.format = QTextCharFormat();
-    rule.format.setFontItalic(true);
-    rule.format.setForeground(Qt::darkRed);
-    rule.pattern = QRegExp("\"(\\\"|.)*\"");
-    Rules.append(rule);
+    // One keyword per line
+    lexer = GlslLexer(QTextStream(&highlighting).readAll().split("\n", QString::SkipEmptyParts));
+
+    for(auto &format : formats)
+        format = QTextCharFormat();
+
+    formats[GlslLexer::Token::Keyword].setForeground(Qt::blue);
+    formats[GlslLexer::Token::Number].setForeground(QColor(255, 128, 0));
+    formats[GlslLexer::Token::Comment].setForeground(Qt::darkGreen);
+    formats[GlslLexer::Token::Directive].setForeground(Qt::darkMagenta);
+    formats[GlslLexer::Token::GlIdentifier].setForeground(Qt::darkCyan);
+    formats[GlslLexer::Token::String].setFontItalic(true);
+    formats[GlslLexer::Token::String].setForeground(Qt::darkRed);
 }
 
 /**
  * @brief CodeHighlighter::highlightBlock
  * @param text
  *
- * Highlights blocks(duh) by evaluating the regexes
- * created in the constructor.
- * TODO: Code and time complexity are suboptimal.
- *       Is there a better way?
+ * Highlights blocks(duh) by formatting the tokens the lexer
+ * finds in them. The block state tells whether the block ends
+ * inside a comment.
  */
 void CodeHighlighter::highlightBlock(const QString &text) noexcept{
-    /*
-     * goes through the text once for each rule and
-     * highlights the code according to those
-     */
-    for(auto &rule: Rules){
-        QRegExp regEx(rule.pattern);
-        auto i = regEx.indexIn(text);
-        while(i >= 0){
-            auto length = regEx.matchedLength();
-            setFormat(i, length, rule.format);
-            i = regEx.indexIn(text, i + length);
-        }
+    auto state = previousBlockState() == GlslLexer::InComment ? GlslLexer::InComment : GlslLexer::Normal;
+    tokens.clear();
+    setCurrentBlockState(lexer.tokenize(text, state, tokens));
+
+    auto block = currentBlock();
+    int number = block.blockNumber();
+    if(!forceFormat && (number < firstVisible || number > lastVisible)){
+        if(!currentBlockUserData())
+            setCurrentBlockUserData(new PendingBlock);
+        pendingFrom = qMin(pendingFrom, block.position());
+        if(!pendingTimer.isActive())
+            pendingTimer.start();
+        return;
     }
-    setCurrentBlockState(0);
-
-   /*
-    * goes through the text once more for the slightly
-    * more complex multiline comment rule: searches for
-    * a start of the comment and the accoring end and
-    * highlights them and the text between.
-    *
-    * MAINTAINABILITY NOTES:
-    * Requires keeping track of three indices:
-    *      si = start index
-    *      ei = end index
-    *      commentLen = length of the comment(i.e. offset ; needed?)
-    */
-    auto si = 0;
-    if(previousBlockState() != 1)
-        si = commentStartExpression.indexIn(text);
-
-    // TODO: don't trust the preview format
-    while(si >= 0 && this->format(si) != multiLineCommentNotation){
-        auto ei = commentEndExpression.indexIn(text, si);
-        int commentLen;
-        if(ei == -1){
-            setCurrentBlockState(1);
-            commentLen = text.length() - si;
-        }else
-            commentLen = ei - si + commentEndExpression.matchedLength();
-
-        setFormat(si, commentLen, multiLineCommentNotation);
-        si = commentStartExpression.indexIn(text, si + commentLen);
+
+    if(currentBlockUserData())
+        setCurrentBlockUserData(0);
+    // Edits move the pending blocks after them
+    if(pendingFrom != INT_MAX)
+        pendingFrom = qMin(pendingFrom, block.position());
+    for(auto &token : tokens)
+        setFormat(token.start, token.length, formats[token.kind]);
+}
+
+/**
+ * @brief CodeHighlighter::highlightPending
+ *
+ * Formats the pending visible blocks, then pending blocks in
+ * document order for one slice of time. Starts over with the
+ * next slice if some are left. As the states of pending blocks
+ * are right, formatting one does not touch the blocks after it.
+ */
+void CodeHighlighter::highlightPending() noexcept{
+    auto doc = document();
+    if(!doc){
+        pendingFrom = INT_MAX;
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    forceFormat = true;
+
+    for(auto block = doc->findBlockByNumber(firstVisible);
+        block.isValid() && block.blockNumber() <= lastVisible; block = block.next())
+        if(block.userData())
+            rehighlightBlock(block);
+
+    auto block = doc->findBlock(pendingFrom);
+    while(block.isValid() && timer.elapsed() < sliceMsecs){
+        if(block.userData())
+            rehighlightBlock(block);
+        block = block.next();
     }
 
+    forceFormat = false;
+    if(block.isValid()){
+        pendingFrom = block.position();
+        pendingTimer.start();
+    } else
+        pendingFrom = INT_MAX;
 }
@@ -4,13 +4,25 @@
 #include <QSyntaxHighlighter>
 #include <QTextStream>
 #include <QFileInfo>
+#include <QTimer>
+
+#include "GlslLexer.hpp"
 
 /**
  * @brief The CodeHighlighter class
  * @author Veit Heller(s0539501) & Tobias Brosge(s0539713)
  *
  * A subclass of QSyntaxHighlighter that implements Syntax
- * Highlighting(duh!) for the Code Editor class.
+ * Highlighting(duh!) for the Code Editor class. Each block
+ * is split into tokens by a GlslLexer in one pass; the block
+ * state is the lexer state, so comments span blocks.
+ *
+ * Only the visible blocks are formatted right away. Others
+ * get their state, so following blocks are lexed correctly,
+ * and are formatted later in short slices while the event
+ * loop is idle. Like this a huge file shows its first screen
+ * without waiting for the rest. The user data of a block is
+ * reserved to mark it as pending.
  */
 class CodeHighlighter : public QSyntaxHighlighter{
     Q_OBJECT
@@ -18,24 +30,28 @@ class CodeHighlighter : public QSyntaxHighlighter{
 public:
     CodeHighlighter(QTextDocument *parent = 0);
     void setupHighlighting() noexcept;
+    void setVisibleBlocks(int first, int last) noexcept;
+    bool hasPendingBlocks() const noexcept;
 
 protected:
     void highlightBlock(const QString &text) noexcept;
 
+private Q_SLOTS:
+    void highlightPending() noexcept;
+
 private:
     CodeHighlighter& operator=(const CodeHighlighter& rhs) noexcept;
     CodeHighlighter& operator=(CodeHighlighter&& rhs) noexcept;
 
-    struct Rule{
-        QRegExp pattern;
-        QTextCharFormat format;
-    };
-    QVector<Rule> Rules;
-
-    QRegExp commentStartExpression;
-    QRegExp commentEndExpression;
+    GlslLexer lexer;
+    QTextCharFormat formats[GlslLexer::Token::String + 1];
+    QVector<GlslLexer::Token> tokens;
 
-    QTextCharFormat multiLineCommentNotation;
+    QTimer pendingTimer;
+    int firstVisible, lastVisible;
+    // Position of the first block that may be pending
+    int pendingFrom;
+    bool forceFormat;
 };
 
 #endif
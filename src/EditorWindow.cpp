@@ -4,6 +4,9 @@
 static const QString vertexTemplate = ":/rc/template.vert";
 static const QString fragmentTemplate = ":/rc/template.frag";
 
+// Pause in typing after which live mode runs the code
+static const int liveDelay = 40;
+
 /**
  * @brief EditorWindow::EditorWindow
  *
@@ -14,7 +17,7 @@ static const QString fragmentTemplate = ":/rc/template.frag";
  * that was last displayed when closing the editor.
  * Also, it deals with platform-specific displaying quirks.
  */
-EditorWindow::EditorWindow(const QHash<QString, QVariant> &settings, QWidget *parent) : QMainWindow(parent){
+EditorWindow::EditorWindow(const QHash<QString, QVariant> &settings, QWidget *parent) : QMainWindow(parent), running(false), runPending(false){
     vertexCodeEditor = new CodeEditor(this);
     fragmentCodeEditor = new CodeEditor(this);
 
@@ -43,6 +46,21 @@ EditorWindow::EditorWindow(const QHash<QString, QVariant> &settings, QWidget *pa
 
     connect(vertexCodeEditor->document(), &QTextDocument::contentsChanged, this, &EditorWindow::docModified);
     connect(fragmentCodeEditor->document(), &QTextDocument::contentsChanged, this, &EditorWindow::docModified);
+    connect(vertexCodeEditor->document(), &QTextDocument::contentsChanged, this, &EditorWindow::codeEdited);
+    connect(fragmentCodeEditor->document(), &QTextDocument::contentsChanged, this, &EditorWindow::codeEdited);
+    connect(vertexCodeEditor, &CodeEditor::textLoaded, this, &EditorWindow::codeLoaded);
+    connect(fragmentCodeEditor, &CodeEditor::textLoaded, this, &EditorWindow::codeLoaded);
+
+    fileThread = new ShaderFileThread(this);
+    connect(fileThread, &ShaderFileThread::loaded, this, &EditorWindow::fileLoaded);
+    connect(fileThread, &ShaderFileThread::saved, this, &EditorWindow::fileSaved);
+
+    fileWatcher = new FileWatcher(this);
+    connect(fileWatcher, &FileWatcher::changed, this, &EditorWindow::filesChanged);
+
+    liveTimer.setSingleShot(true);
+    liveTimer.setInterval(liveDelay);
+    connect(&liveTimer, &QTimer::timeout, this, &EditorWindow::runLive);
 
     applySettings(settings);
 
@@ -60,9 +78,11 @@ EditorWindow::EditorWindow(const QHash<QString, QVariant> &settings, QWidget *pa
  * @brief EditorWindow::~EditorWindow
  *
  * Destructor of the EditorWindow class.
- * Deletes all the GUI elements.
+ * Deletes all the GUI elements. Saves that are still being
+ * written are finished first.
  */
 EditorWindow::~EditorWindow(){
+    delete fileThread;
     delete vertexCodeEditor;
     delete fragmentCodeEditor;
     delete newAction;
@@ -70,6 +90,7 @@ EditorWindow::~EditorWindow(){
     delete saveAction;
     delete exitAction;
     delete runAction;
+    delete liveAction;
     delete settingsAction;
     delete helpAction;
     delete loadObjectAction;
@@ -181,6 +202,7 @@ void EditorWindow::saveSettings() noexcept{
 
     settings.insert("vertexFile", currentVertexFile);
     settings.insert("fragmentFile", currentFragmentFile);
+    settings.insert("liveMode", liveAction->isChecked());
 
     settings.insert("modelFile", modelFile);
     settings.insert("modelOffsetX", modelOffset.x());
@@ -233,29 +255,32 @@ void EditorWindow::warningDisplay(const QString &message) noexcept{
  */
 void EditorWindow::codeStopped() noexcept
 {
+    running = false;
+    liveTimer.stop();
     runAction->setIcon(QIcon(":/images/run.png"));
+    runPending = false;
 }
 
 /**
- * @brief EditorWindow::highlightErroredVertexLine
- * @param lineno
+ * @brief EditorWindow::showVertexDiagnostics
+ * @param diagnostics
  *
- * Highlights a given line in red. Signifies an error in
- * that line.
+ * Marks the lines of all diagnostics of the vertex code,
+ * errors in red and warnings in yellow.
  */
-void EditorWindow::highlightErroredVertexLine(int lineno) noexcept{
-    vertexCodeEditor->highlightErroredLine(lineno);
+void EditorWindow::showVertexDiagnostics(const QList<ShaderDiagnostic> &diagnostics) noexcept{
+    vertexCodeEditor->showDiagnostics(diagnostics);
 }
 
 /**
- * @brief EditorWindow::highlightErroredFragmentLine
- * @param lineno
+ * @brief EditorWindow::showFragmentDiagnostics
+ * @param diagnostics
  *
- * Highlights a given line in red. Signifies an error in
- * that line.
+ * Marks the lines of all diagnostics of the fragment code,
+ * errors in red and warnings in yellow.
  */
-void EditorWindow::highlightErroredFragmentLine(int lineno) noexcept{
-    fragmentCodeEditor->highlightErroredLine(lineno);
+void EditorWindow::showFragmentDiagnostics(const QList<ShaderDiagnostic> &diagnostics) noexcept{
+    fragmentCodeEditor->showDiagnostics(diagnostics);
 }
 
 /**
@@ -282,6 +307,7 @@ void EditorWindow::applySettings(const QHash<QString, QVariant> &settings) noexc
     modelRotation.setY(settings.value("modelRotationY", 0).toFloat());
     modelRotation.setZ(settings.value("modelRotationZ", 0).toFloat());
     objectLoaderDialog->setData(modelFile, modelOffset, modelScaling, modelRotation);
+    liveAction->setChecked(settings.value("liveMode", false).toBool());
 
     currentVertexFile = settings.value("vertexFile", vertexTemplate).toString();
     currentFragmentFile = settings.value("fragmentFile", fragmentTemplate).toString();
@@ -293,12 +319,65 @@ void EditorWindow::applySettings(const QHash<QString, QVariant> &settings) noexc
 /**
  * @brief EditorWindow:: runFile
  *
- * lets the backend run the file.
+ * lets the backend run the file. The model goes first, as
+ * includes are also looked up next to it; the backend does
+ * not load it again if it did not change.
  */
 void EditorWindow::runFile() noexcept{
     runAction->setIcon(QIcon(":/images/refresh.png"));
-    Q_EMIT runCode(this);
+    running = true;
     Q_EMIT loadModel(modelFile, modelOffset, modelScaling, modelRotation);
+    // Half of a file does not compile; it runs once it is complete
+    runPending = isLoading();
+    if(!runPending)
+        Q_EMIT runCode(this, false);
+}
+
+/**
+ * @brief EditorWindow::codeEdited
+ *
+ * reacts to the contentsChanged() SIGNAL by running the code
+ * after a pause in typing, if live mode is on and the code
+ * runs(SLOT).
+ */
+void EditorWindow::codeEdited() noexcept{
+    if(running && liveAction->isChecked())
+        liveTimer.start();
+}
+
+/**
+ * @brief EditorWindow::runLive
+ *
+ * lets the backend run the edited code(SLOT).
+ */
+void EditorWindow::runLive() noexcept{
+    if(running && !isLoading())
+        Q_EMIT runCode(this, true);
+}
+
+/**
+ * @brief EditorWindow::codeLoaded
+ *
+ * reacts to an editor that finished filling in a file by
+ * running the code if that had to wait for it(SLOT).
+ */
+void EditorWindow::codeLoaded() noexcept{
+    docModified();
+    if(isLoading())
+        return;
+    if(runPending && running)
+        Q_EMIT runCode(this, false);
+    else
+        codeEdited();
+    runPending = false;
+}
+
+/**
+ * @brief EditorWindow::isLoading
+ * @return True while an editor is filled in with a file
+ */
+bool EditorWindow::isLoading() const noexcept{
+    return vertexCodeEditor->isLoading() || fragmentCodeEditor->isLoading();
 }
 
 /**
@@ -370,6 +449,14 @@ void EditorWindow::addActions() noexcept{
     runAction->setStatusTip(tr("Runs the code in the editor"));
     connect(runAction, &QAction::triggered, this, &EditorWindow::runFile);
 
+    liveAction = new QAction(tr("&Live"), this);
+    liveAction->setCheckable(true);
+    liveAction->setStatusTip(tr("Runs the code again while you type"));
+    connect(liveAction, &QAction::toggled, this, [this](bool live){
+        if(live)
+            runLive();
+    });
+
     settingsAction = new QAction(QIcon(":/images/settings.png"), tr("Settings"), this);
     settingsAction->setShortcuts(QKeySequence::Preferences);
     settingsAction->setStatusTip(tr("Opens A Settings Window"));
@@ -402,6 +489,7 @@ void EditorWindow::addMenus() noexcept{
     eMenu = menuBar()->addMenu(tr("&Edit"));
     eMenu->addAction(settingsAction);
     eMenu->addAction(runAction);
+    eMenu->addAction(liveAction);
     menuBar()->addSeparator();
 
     hMenu = menuBar()->addMenu(tr("&Help"));
@@ -423,6 +511,7 @@ void EditorWindow::addToolBars() noexcept{
     editBar = addToolBar(tr("Edit"));
     fileBar->addAction(settingsAction);
     fileBar->addAction(runAction);
+    fileBar->addAction(liveAction);
     fileBar->addAction(loadObjectAction);
 }
 
@@ -465,7 +554,8 @@ bool EditorWindow::saveDialog() noexcept{
  * @brief EditorWindow::loadFile
  * @param path
  *
- * loads a file of a given name
+ * loads a file of a given name. Reading it happens on the
+ * file thread, see fileLoaded().
  */
 void EditorWindow::loadFile(const QString &path, bool v, bool f) noexcept{
     QFileInfo fileInfo(path);
@@ -486,37 +576,69 @@ void EditorWindow::loadFile(const QString &path, bool v, bool f) noexcept{
             fragmentFile = true;
     }
 
-    QFile file(path);
+    requestLoad(vertexFile ? vertexCodeEditor : fragmentCodeEditor, path, false);
+    statusBar()->showMessage(tr("Loading %1...").arg(stripName(path)));
+}
+
+/**
+ * @brief EditorWindow::requestLoad
+ * @param editor The editor the file is for
+ * @param path Path of the file
+ * @param reload True if the editor shows the file already
+ *
+ * Queues reading the file. Loads of the editor that still
+ * wait are dropped, the newest one wins.
+ */
+void EditorWindow::requestLoad(CodeEditor *editor, const QString &path, bool reload) noexcept{
+    for(auto it = loads.begin(); it != loads.end();){
+        if(it.value().editor == editor)
+            it = loads.erase(it);
+        else
+            ++it;
+    }
+    loads.insert(fileThread->load(path), Load{editor, reload});
+}
+
+/**
+ * @brief EditorWindow::fileLoaded
+ * @param ticket The load the file was read for
+ * @param path Path of the file
+ * @param content The text of the file or an error
+ *
+ * Fills the editor in with the file; large files are filled
+ * in while the window stays responsive(SLOT).
+ */
+void EditorWindow::fileLoaded(int ticket, QString path, ShaderFile::Content content) noexcept{
+    if(!loads.contains(ticket))
+        return;
+    auto load = loads.take(ticket);
     //display an error message if the file cannot be opened and why
-    if(!file.open(QFile::ReadOnly | QFile::Text)){
-        auto msg = tr("Cannot read file %1:\n%2.").arg(path).arg(file.errorString());
-        QMessageBox::warning(this, tr("ShaderSandbox"), msg);
+    if(!content.ok()){
+        if(!load.reload){
+            auto msg = tr("Cannot read file %1:\n%2.").arg(path).arg(content.error);
+            QMessageBox::warning(this, tr("ShaderSandbox"), msg);
+        }
         return;
     }
 
-    /*
-     * while the application is busy loading,
-     * set a waiting cursor. Real fancy, huh?
-     */
-    QTextStream in(&file);
-#ifndef QT_NO_CURSOR
-    QApplication::setOverrideCursor(Qt::WaitCursor);
-#endif
+    bool vertex = load.editor == vertexCodeEditor;
+    QString text = content.text;
+    content.text.clear();
+    (vertex ? vertexEncoding : fragmentEncoding) = content;
 
-    if(vertexFile){
-        vertexCodeEditor->setPlainText(in.readAll());
-        setAsCurrentFile(path, currentFragmentFile);
-    }
-    if(fragmentFile){
-        fragmentCodeEditor->setPlainText(in.readAll());
-        setAsCurrentFile(currentVertexFile, path);
+    if(load.reload){
+        if(reloadFile(load.editor, path, text) && running)
+            Q_EMIT runCode(this, true);
+        return;
     }
 
-#ifndef QT_NO_CURSOR
-    QApplication::restoreOverrideCursor();
-#endif
+    load.editor->loadText(text);
+    if(vertex)
+        setAsCurrentFile(path, currentFragmentFile);
+    else
+        setAsCurrentFile(currentVertexFile, path);
 
-    //set current file and display a message in the status bar
+    //display a message in the status bar
     statusBar()->showMessage(tr("File was loaded"), 2000);
 }
 
@@ -543,53 +665,70 @@ bool EditorWindow::saveFile() noexcept{
         return saveFile(choice);
 }
 
+/**
+ * @brief EditorWindow::saveFile
+ * @param shaderType "VertexShader" or "FragmentShader"
+ * @return bool - false if there is nothing to save/
+ *         true if the file is being saved
+ *
+ * queues saving the code of the editor; the file thread
+ * writes it, see fileSaved().
+ */
 bool EditorWindow::saveFile(QString shaderType) noexcept{
-    QFile file;
-    if(shaderType == "VertexShader" && (currentVertexFile.isEmpty() || currentVertexFile == vertexTemplate))
-        file.setFileName(QFileDialog::getSaveFileName(this));
-    else if(shaderType == "FragmentShader" && (currentFragmentFile.isEmpty() || currentFragmentFile == fragmentTemplate))
-        file.setFileName(QFileDialog::getSaveFileName(this));
-    else if(shaderType == "VertexShader")
-        file.setFileName(currentVertexFile);
-    else
-        file.setFileName(currentFragmentFile);
-
-
-    if(file.fileName().isEmpty()) return false;
-
-
-    //display an error message if the file cannot be saved and why
-    if(!file.open(QFile::WriteOnly | QFile::Text)){
-        warningDisplay(tr("Cannot write file %1:\n%2.").arg(file.fileName()).arg(file.errorString()));
+    bool vertex = shaderType == "VertexShader";
+    auto editor = vertex ? vertexCodeEditor : fragmentCodeEditor;
+    if(editor->isLoading()){
+        warningDisplay(tr("The file is still being loaded."));
         return false;
     }
 
-    /*
-     * while the application is busy loading,
-     * set a waiting cursor. Real fancy, huh?
-     */
-    QTextStream out(&file);
-#ifndef QT_NO_CURSOR
-    QApplication::setOverrideCursor(Qt::WaitCursor);
-#endif
+    QString path;
+    if(vertex && (currentVertexFile.isEmpty() || currentVertexFile == vertexTemplate))
+        path = QFileDialog::getSaveFileName(this);
+    else if(!vertex && (currentFragmentFile.isEmpty() || currentFragmentFile == fragmentTemplate))
+        path = QFileDialog::getSaveFileName(this);
+    else
+        path = vertex ? currentVertexFile : currentFragmentFile;
 
-    if(shaderType == "VertexShader"){
-        out << vertexCodeEditor->toPlainText();
-        currentVertexFile = file.fileName();
-    } else {
-        out << fragmentCodeEditor->toPlainText();
-        currentFragmentFile = file.fileName();
-    }
+    if(path.isEmpty()) return false;
 
-#ifndef QT_NO_CURSOR
-    QApplication::restoreOverrideCursor();
-#endif
+    ShaderFile::Content content = vertex ? vertexEncoding : fragmentEncoding;
+    content.text = editor->toPlainText();
+    saves.insert(fileThread->save(path, content), editor);
+
+    if(vertex)
+        currentVertexFile = path;
+    else
+        currentFragmentFile = path;
 
     setAsCurrentFile(currentVertexFile, currentFragmentFile);
-    statusBar()->showMessage(tr("File saved"), 2000);
+    statusBar()->showMessage(tr("Saving %1...").arg(stripName(path)));
     return true;
 }
 
+/**
+ * @brief EditorWindow::fileSaved
+ * @param ticket The save the file was written for
+ * @param path Path of the file
+ * @param error Why the file could not be written, empty on success
+ *
+ * A file that was not written is marked modified again(SLOT).
+ */
+void EditorWindow::fileSaved(int ticket, QString path, QString error) noexcept{
+    auto editor = saves.take(ticket);
+    if(!error.isEmpty()){
+        //display an error message if the file cannot be saved and why
+        warningDisplay(tr("Cannot write file %1:\n%2.").arg(path).arg(error));
+        if(editor)
+            editor->document()->setModified(true);
+        docModified();
+        return;
+    }
+    // Not a change of another program
+    fileWatcher->refresh(path);
+    statusBar()->showMessage(tr("File saved"), 2000);
+}
+
 
 /**
  * @brief EditorWindow::setAsCurrentFile
@@ -603,6 +742,7 @@ void EditorWindow::setAsCurrentFile(const QString &vertexFile, const QString &fr
 
     Q_EMIT changedSetting(this, "vertexFile", vertexFile);
     Q_EMIT changedSetting(this, "fragmentFile", fragmentFile);
+    fileWatcher->setFiles(QStringList() << vertexFile << fragmentFile);
 
     vertexCodeEditor->document()->setModified(false);
     fragmentCodeEditor->document()->setModified(false);
@@ -619,6 +759,58 @@ void EditorWindow::setAsCurrentFile(const QString &vertexFile, const QString &fr
     setWindowTitle(title.append(" [*]"));
 }
 
+/**
+ * @brief EditorWindow::filesChanged
+ * @param files Files that other programs changed
+ *
+ * Loads the shaders that changed on disk again; the code is
+ * run again if it runs, see fileLoaded()(SLOT).
+ */
+void EditorWindow::filesChanged(const QStringList &files) noexcept{
+    for(auto &file : files){
+        if(file == QFileInfo(currentVertexFile).absoluteFilePath())
+            requestLoad(vertexCodeEditor, file, true);
+        if(file == QFileInfo(currentFragmentFile).absoluteFilePath())
+            requestLoad(fragmentCodeEditor, file, true);
+    }
+}
+
+/**
+ * @brief EditorWindow::reloadFile
+ * @param editor The editor that shows the file
+ * @param path Path of the file
+ * @param text The code the file has now
+ * @return True if the code of the editor changed
+ *
+ * A file that has the code of the editor is left alone.
+ * Unsaved changes are only replaced if the user agrees. The
+ * reload can be undone.
+ */
+bool EditorWindow::reloadFile(CodeEditor *editor, const QString &path, const QString &text) noexcept{
+    if(editor->isLoading() || text == editor->toPlainText())
+        return false;
+
+    if(editor->document()->isModified()){
+        auto question = QMessageBox::question(this, tr("ShaderSandbox"),
+            tr("%1 was changed by another program.\n"
+               "Do you want to load it again and lose your changes?").arg(stripName(path)),
+            QMessageBox::Yes | QMessageBox::No);
+        if(question != QMessageBox::Yes)
+            return false;
+    }
+
+    int position = editor->textCursor().position();
+    QTextCursor cursor(editor->document());
+    cursor.select(QTextCursor::Document);
+    cursor.insertText(text);
+    cursor.setPosition(qMin(position, editor->document()->characterCount() - 1));
+    editor->setTextCursor(cursor);
+    editor->document()->setModified(false);
+    docModified();
+    statusBar()->showMessage(tr("%1 was loaded again").arg(stripName(path)), 2000);
+    return true;
+}
+
 /**
  * @brief EditorWindow::stripName
  * @param fullName
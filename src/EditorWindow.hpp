@@ -12,9 +12,12 @@
 #include <QStatusBar>
 #include <QSplitter>
 #include <QInputDialog>
+#include <QTimer>
 
 #include "CodeEditor.hpp"
 #include "ObjectLoaderDialog.hpp"
+#include "FileWatcher.hpp"
+#include "ShaderFileThread.hpp"
 
 /**
  * @brief The EditorWindow class
@@ -22,6 +25,11 @@
  *
  * A subclass of QMainWindow that makes the CodeEditor more
  * interactive by implementing save/load and open/close features.
+ * In live mode, running code is run again a moment after each
+ * edit; the backend skips edits that do not change the shader.
+ * Files that are changed by other programs are loaded again.
+ * Files are read and written on a ShaderFileThread; code that
+ * is still being filled in is never run.
  */
 class EditorWindow : public QMainWindow{
     Q_OBJECT
@@ -31,8 +39,8 @@ public:
     ~EditorWindow();
     void showResults(const QString &) noexcept;
     void warningDisplay(const QString &) noexcept;
-    void highlightErroredVertexLine(int) noexcept;
-    void highlightErroredFragmentLine(int) noexcept;
+    void showVertexDiagnostics(const QList<ShaderDiagnostic> &) noexcept;
+    void showFragmentDiagnostics(const QList<ShaderDiagnostic> &) noexcept;
     void codeStopped() noexcept;
 
     QString getVertexSourceCode() const noexcept;
@@ -48,6 +56,12 @@ private Q_SLOTS:
 
     void docModified() noexcept;
     void runFile() noexcept;
+    void runLive() noexcept;
+    void codeEdited() noexcept;
+    void filesChanged(const QStringList &) noexcept;
+    void fileLoaded(int ticket, QString path, ShaderFile::Content content) noexcept;
+    void fileSaved(int ticket, QString path, QString error) noexcept;
+    void codeLoaded() noexcept;
     bool saveFile() noexcept;
 
     void gotOpenHelp() noexcept;
@@ -59,7 +73,7 @@ Q_SIGNALS:
     void closeAll(EditorWindow *);
     void openSettings(EditorWindow *);
     void openHelp(EditorWindow *);
-    void runCode(EditorWindow *);
+    void runCode(EditorWindow *, bool live);
     void stopCode(EditorWindow *);
     void titleChanged(EditorWindow *);
     void changedSetting(EditorWindow *, const QString &, const QVariant &);
@@ -76,17 +90,31 @@ private:
     void addStatusBar() noexcept;
     void applySettings(const QHash<QString, QVariant> &) noexcept;
     void loadFile(const QString &, bool v = false, bool f = false) noexcept;
+    void requestLoad(CodeEditor *, const QString &, bool reload) noexcept;
+    bool isLoading() const noexcept;
     bool saveDialog() noexcept;
     bool saveFile(QString shaderType) noexcept;
     void saveSettings() noexcept;
     void setAsCurrentFile(const QString &vertexFile, const QString &fragmentFile) noexcept;
     QString stripName(const QString &) noexcept;
+    bool reloadFile(CodeEditor *, const QString &, const QString &) noexcept;
 
     int templateNum;
 
     QSplitter *codeEditors;
     CodeEditor *vertexCodeEditor, *fragmentCodeEditor;
     QString currentVertexFile, currentFragmentFile;
+    FileWatcher *fileWatcher;
+
+    struct Load{
+        CodeEditor *editor;
+        bool reload;
+    };
+    ShaderFileThread *fileThread;
+    QHash<int, Load> loads;
+    QHash<int, CodeEditor*> saves;
+    // Encoding and line endings to save the files with
+    ShaderFile::Content vertexEncoding, fragmentEncoding;
 
     QMenu *fMenu;
     QMenu *eMenu;
@@ -98,10 +126,14 @@ private:
     QAction *saveAction;
     QAction *exitAction;
     QAction *runAction;
+    QAction *liveAction;
     QAction *settingsAction;
     QAction *helpAction;
     QAction *loadObjectAction;
 
+    QTimer liveTimer;
+    bool running, runPending;
+
     QString modelFile;
     QVector3D modelOffset, modelScaling, modelRotation;
     ObjectLoaderDialog *objectLoaderDialog;
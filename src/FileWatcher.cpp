@@ -0,0 +1,174 @@
+#include "FileWatcher.hpp"
+
+#include <QFileInfo>
+
+/**
+ * @brief FileWatcher::FileWatcher
+ * @param parent Parent object
+ */
+FileWatcher::FileWatcher(QObject *parent) : QObject(parent){
+    timer.setSingleShot(true);
+    timer.setInterval(coalesceDelay);
+    connect(&watcher, &QFileSystemWatcher::fileChanged, this, &FileWatcher::fileChanged);
+    connect(&watcher, &QFileSystemWatcher::directoryChanged, this, &FileWatcher::directoryChanged);
+    connect(&timer, &QTimer::timeout, this, &FileWatcher::flush);
+}
+
+/**
+ * @brief FileWatcher::setFiles
+ * @param files Paths of the files to watch
+ *
+ * Files that are watched already keep their stamp, so a
+ * change that happened meanwhile is still reported.
+ */
+void FileWatcher::setFiles(const QStringList &files) noexcept{
+    QHash<QString, Stamp> watched;
+    for(auto &file : files){
+        if(file.isEmpty() || file.startsWith(':'))
+            continue;
+        QString path = QFileInfo(file).absoluteFilePath();
+        if(watched.contains(path))
+            continue;
+        watched.insert(path, stamps.contains(path) ? stamps[path] : stampOf(path));
+    }
+
+    QStringList removed, added;
+    for(auto &path : stamps.keys())
+        if(!watched.contains(path))
+            removed.append(path);
+    for(auto &path : watched.keys())
+        if(!stamps.contains(path))
+            added.append(path);
+    if(!removed.isEmpty())
+        watcher.removePaths(removed);
+    if(!added.isEmpty())
+        watcher.addPaths(added);
+    for(auto &path : removed)
+        pending.remove(path);
+    stamps = watched;
+    watchDirectories();
+}
+
+/**
+ * @brief FileWatcher::files
+ * @return Absolute paths of the watched files
+ */
+QStringList FileWatcher::files() const noexcept{
+    return stamps.keys();
+}
+
+/**
+ * @brief FileWatcher::refresh
+ * @param file A watched file the application wrote itself
+ *
+ * Takes the file as it is now as known, so the change is
+ * not reported.
+ */
+void FileWatcher::refresh(const QString &file) noexcept{
+    QString path = QFileInfo(file).absoluteFilePath();
+    if(stamps.contains(path))
+        stamps[path] = stampOf(path);
+}
+
+/**
+ * @brief FileWatcher::fileChanged
+ * @param file A file that was written, replaced or removed
+ *
+ * Starts the delay again, so a burst is reported at its end(SLOT).
+ */
+void FileWatcher::fileChanged(const QString &file) noexcept{
+    if(!stamps.contains(file))
+        return;
+    pending.insert(file);
+    timer.start();
+}
+
+/**
+ * @brief FileWatcher::directoryChanged
+ * @param directory A directory of files that do not exist
+ *
+ * Looks at the missing files of the directory at the end
+ * of the delay, as one of them may have appeared(SLOT).
+ */
+void FileWatcher::directoryChanged(const QString &directory) noexcept{
+    auto watchedFiles = watcher.files();
+    for(auto &file : stamps.keys()){
+        if(watchedFiles.contains(file) || QFileInfo(file).absolutePath() != directory)
+            continue;
+        pending.insert(file);
+        timer.start();
+    }
+}
+
+/**
+ * @brief FileWatcher::flush
+ *
+ * Reports the files that really changed since the last
+ * report and watches replaced and recreated files again(SLOT).
+ */
+void FileWatcher::flush() noexcept{
+    QStringList changedFiles;
+    for(auto &file : pending){
+        auto stamp = stampOf(file);
+        // Removed or still being replaced; its directory is watched
+        if(!stamp.modified.isValid())
+            continue;
+        if(!watcher.files().contains(file))
+            watcher.addPath(file);
+        auto &known = stamps[file];
+        if(stamp.modified == known.modified && stamp.size == known.size)
+            continue;
+        known = stamp;
+        changedFiles.append(file);
+    }
+    pending.clear();
+    watchDirectories();
+    if(!changedFiles.isEmpty())
+        Q_EMIT changed(changedFiles);
+}
+
+/**
+ * @brief FileWatcher::watchDirectories
+ *
+ * Watches the directories of the files that cannot be
+ * watched themselves, and only those.
+ */
+void FileWatcher::watchDirectories() noexcept{
+    auto watchedFiles = watcher.files();
+    QSet<QString> needed;
+    for(auto &file : stamps.keys()){
+        if(watchedFiles.contains(file))
+            continue;
+        if(!stampOf(file).modified.isValid()){
+            QString directory = QFileInfo(file).absolutePath();
+            if(QFileInfo(directory).isDir())
+                needed.insert(directory);
+        } else
+            watcher.addPath(file);
+    }
+
+    auto watchedDirectories = watcher.directories();
+    QStringList removed, added;
+    for(auto &directory : watchedDirectories)
+        if(!needed.contains(directory))
+            removed.append(directory);
+    for(auto &directory : needed)
+        if(!watchedDirectories.contains(directory))
+            added.append(directory);
+    if(!removed.isEmpty())
+        watcher.removePaths(removed);
+    if(!added.isEmpty())
+        watcher.addPaths(added);
+}
+
+/**
+ * @brief FileWatcher::stampOf
+ * @param file Path of a file
+ * @return Its modification time and size, invalid if it does not exist
+ */
+FileWatcher::Stamp FileWatcher::stampOf(const QString &file) noexcept{
+    QFileInfo info(file);
+    if(!info.exists())
+        return Stamp{QDateTime(), -1};
+    return Stamp{info.lastModified(), info.size()};
+}
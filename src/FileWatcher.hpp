@@ -0,0 +1,60 @@
+#ifndef FILEWATCHER_HPP
+#define FILEWATCHER_HPP
+
+#include <QFileSystemWatcher>
+#include <QStringList>
+#include <QDateTime>
+#include <QTimer>
+#include <QHash>
+#include <QSet>
+
+/**
+ * @brief The FileWatcher class
+ *
+ * Watches a set of files and reports the ones that changed
+ * on disk. Editors save in bursts of writes, or write a new
+ * file and rename it over the old one; all notifications
+ * within a short delay are coalesced into one report, and a
+ * file is only reported if its modification time or size
+ * differ from what was reported before. Files that were
+ * replaced are watched again. Files that do not exist, yet or
+ * anymore, are watched through their directory meanwhile and
+ * reported once they appear. Resource paths are ignored.
+ */
+class FileWatcher : public QObject{
+    Q_OBJECT
+public:
+    static const int coalesceDelay = 100;
+
+    explicit FileWatcher(QObject *parent = 0);
+    void setFiles(const QStringList &files) noexcept;
+    QStringList files() const noexcept;
+    void refresh(const QString &file) noexcept;
+
+Q_SIGNALS:
+    void changed(const QStringList &files);
+
+private Q_SLOTS:
+    void fileChanged(const QString &file) noexcept;
+    void directoryChanged(const QString &directory) noexcept;
+    void flush() noexcept;
+
+private:
+    struct Stamp{
+        QDateTime modified;
+        qint64 size;
+    };
+
+    FileWatcher(const FileWatcher &);
+    FileWatcher& operator=(const FileWatcher& rhs);
+
+    static Stamp stampOf(const QString &file) noexcept;
+    void watchDirectories() noexcept;
+
+    QFileSystemWatcher watcher;
+    QTimer timer;
+    QHash<QString, Stamp> stamps;
+    QSet<QString> pending;
+};
+
+#endif // FILEWATCHER_HPP
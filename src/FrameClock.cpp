@@ -0,0 +1,133 @@
+#include "FrameClock.hpp"
+
+#include <cmath>
+
+/**
+ * @brief FrameClock::FrameClock
+ *
+ * Creates a running clock at zero in real time mode.
+ */
+FrameClock::FrameClock() : step(0), paused(false){
+    restart();
+}
+
+/**
+ * @brief FrameClock::restart
+ *
+ * Goes back to zero and frame zero. Pause and step stay.
+ */
+void FrameClock::restart() noexcept{
+    timer.start();
+    lastNsecs = 0;
+    current = deltaValue = realDeltaValue = 0;
+    frameCount = -1;
+}
+
+/**
+ * @brief FrameClock::tick
+ *
+ * Advances to the next frame: by the fixed step if one is
+ * set, otherwise by the real time since the last tick, and
+ * not at all while paused. The first tick is frame zero at
+ * time zero.
+ */
+void FrameClock::tick() noexcept{
+    qint64 now = timer.nsecsElapsed();
+    realDeltaValue = frameCount < 0 ? 0 : (now - lastNsecs) / 1e6;
+    lastNsecs = now;
+
+    if(frameCount < 0 || paused)
+        deltaValue = 0;
+    else
+        deltaValue = step > 0 ? step : realDeltaValue;
+    current += deltaValue;
+    ++frameCount;
+}
+
+/**
+ * @brief FrameClock::msecs
+ * @return The time of the current frame in milliseconds
+ */
+double FrameClock::msecs() const noexcept{
+    return current;
+}
+
+/**
+ * @brief FrameClock::seconds
+ * @return The time of the current frame in seconds, starting
+ * over every wrapSeconds
+ *
+ * Small enough to stay precise to a fraction of a millisecond
+ * in a float.
+ */
+double FrameClock::seconds() const noexcept{
+    return std::fmod(current / 1000, wrapSeconds);
+}
+
+/**
+ * @brief FrameClock::delta
+ * @return Milliseconds the shown time advanced with the last tick
+ */
+double FrameClock::delta() const noexcept{
+    return deltaValue;
+}
+
+/**
+ * @brief FrameClock::realDelta
+ * @return Real milliseconds between the last two ticks
+ */
+double FrameClock::realDelta() const noexcept{
+    return realDeltaValue;
+}
+
+/**
+ * @brief FrameClock::frame
+ * @return Number of the current frame, counted from zero
+ */
+qint64 FrameClock::frame() const noexcept{
+    return qMax<qint64>(0, frameCount);
+}
+
+/**
+ * @brief FrameClock::setPaused
+ * @param paused True to hold the shown time
+ *
+ * Frames are still counted while paused.
+ */
+void FrameClock::setPaused(bool paused) noexcept{
+    this->paused = paused;
+}
+
+/**
+ * @brief FrameClock::isPaused
+ * @return True while the shown time is held
+ */
+bool FrameClock::isPaused() const noexcept{
+    return paused;
+}
+
+/**
+ * @brief FrameClock::scrub
+ * @param msecs Time to jump to, clamped to zero
+ *
+ * The next frame shows msecs plus the delta of its tick.
+ */
+void FrameClock::scrub(double msecs) noexcept{
+    current = qMax(0.0, msecs);
+}
+
+/**
+ * @brief FrameClock::setFixedStep
+ * @param msecs Milliseconds per frame, or zero for real time
+ */
+void FrameClock::setFixedStep(double msecs) noexcept{
+    step = qMax(0.0, msecs);
+}
+
+/**
+ * @brief FrameClock::fixedStep
+ * @return Milliseconds per frame, zero in real time mode
+ */
+double FrameClock::fixedStep() const noexcept{
+    return step;
+}
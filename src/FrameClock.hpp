@@ -0,0 +1,50 @@
+#ifndef FRAMECLOCK_HPP
+#define FRAMECLOCK_HPP
+
+#include <QElapsedTimer>
+
+/**
+ * @brief The FrameClock class
+ *
+ * The time a renderer shows, advanced once per frame by tick().
+ * It reads a monotonic clock with nanosecond resolution and
+ * accumulates in double precision milliseconds, so it neither
+ * wraps nor loses precision over days of uptime.
+ *
+ * The shown time can be paused and scrubbed. With a fixed step
+ * it advances by exactly that much per frame, whatever the real
+ * frame rate is, which makes the output of a frame reproducible.
+ * realDelta() always follows the real clock, for input handling.
+ *
+ * A float holds the milliseconds only to about 8ms after a day,
+ * so shaders also get seconds() that start over every hour.
+ */
+class FrameClock{
+public:
+    FrameClock();
+    void restart() noexcept;
+    void tick() noexcept;
+
+    static const int wrapSeconds = 3600;
+
+    double msecs() const noexcept;
+    double seconds() const noexcept;
+    double delta() const noexcept;
+    double realDelta() const noexcept;
+    qint64 frame() const noexcept;
+
+    void setPaused(bool paused) noexcept;
+    bool isPaused() const noexcept;
+    void scrub(double msecs) noexcept;
+    void setFixedStep(double msecs) noexcept;
+    double fixedStep() const noexcept;
+
+private:
+    QElapsedTimer timer;
+    qint64 lastNsecs;
+    double current, step, deltaValue, realDeltaValue;
+    qint64 frameCount;
+    bool paused;
+};
+
+#endif // FRAMECLOCK_HPP
@@ -0,0 +1,186 @@
+#include "GlStateCache.hpp"
+
+#include <limits>
+
+/**
+ * @brief GlStateCache::GlStateCache
+ *
+ * Creates a cache that knows nothing yet, so every first call
+ * is issued. Requires the owning context to be current.
+ */
+GlStateCache::GlStateCache() : issuedCount(0), elidedCount(0){
+    initializeOpenGLFunctions();
+    invalidate();
+}
+
+/**
+ * @brief GlStateCache::invalidate
+ *
+ * Forgets the whole shadow. Call it after the state was
+ * changed without going through the cache.
+ */
+void GlStateCache::invalidate() noexcept{
+    // Values no call can set, NaN never compares equal
+    const GLfloat unknown = std::numeric_limits<GLfloat>::quiet_NaN();
+    for(int i = 0; i < 4; ++i){
+        viewportBox[i] = -1;
+        clearColors[i] = unknown;
+    }
+    clearDepthValue = unknown;
+    polygonModeValue = depthFuncValue = 0;
+    depthMaskValue = 0xFF;
+    program = vertexArray = activeUnit = GLuint(-1);
+    capabilities.clear();
+    textures.clear();
+}
+
+/**
+ * @brief GlStateCache::forgetBinding
+ * @param target A texture target like GL_TEXTURE_2D, or
+ * GL_VERTEX_ARRAY_BINDING
+ *
+ * Forgets the binding of target on the active unit, e.g.
+ * after a texture upload bound another texture there, or
+ * the bound vertex array.
+ */
+void GlStateCache::forgetBinding(GLenum target) noexcept{
+    if(target == GL_VERTEX_ARRAY_BINDING)
+        vertexArray = GLuint(-1);
+    else if(GLuint(textures.size()) > activeUnit)
+        textures[activeUnit].remove(target);
+}
+
+/**
+ * @brief GlStateCache::changes
+ * @param same True if the shadow already holds the requested value
+ * @return True if the call has to be issued
+ *
+ * Does the bookkeeping for every cached call.
+ */
+bool GlStateCache::changes(bool same) noexcept{
+    if(same){
+        ++elidedCount;
+        return false;
+    }
+    ++issuedCount;
+    return true;
+}
+
+void GlStateCache::viewport(GLint x, GLint y, GLsizei width, GLsizei height) noexcept{
+    if(!changes(viewportBox[0] == x && viewportBox[1] == y && viewportBox[2] == width && viewportBox[3] == height))
+        return;
+    glViewport(x, y, width, height);
+    viewportBox[0] = x; viewportBox[1] = y; viewportBox[2] = width; viewportBox[3] = height;
+}
+
+void GlStateCache::clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) noexcept{
+    if(!changes(clearColors[0] == red && clearColors[1] == green && clearColors[2] == blue && clearColors[3] == alpha))
+        return;
+    glClearColor(red, green, blue, alpha);
+    clearColors[0] = red; clearColors[1] = green; clearColors[2] = blue; clearColors[3] = alpha;
+}
+
+void GlStateCache::clearDepth(GLdouble depth) noexcept{
+    if(!changes(clearDepthValue == depth))
+        return;
+    glClearDepth(depth);
+    clearDepthValue = depth;
+}
+
+/**
+ * @brief GlStateCache::polygonMode
+ * @param mode Mode for front and back faces; the core profile has no separate ones
+ */
+void GlStateCache::polygonMode(GLenum mode) noexcept{
+    if(!changes(polygonModeValue == mode))
+        return;
+    glPolygonMode(GL_FRONT_AND_BACK, mode);
+    polygonModeValue = mode;
+}
+
+void GlStateCache::setEnabled(GLenum capability, bool enabled) noexcept{
+    auto it = capabilities.find(capability);
+    if(!changes(it != capabilities.end() && *it == enabled))
+        return;
+    if(enabled)
+        glEnable(capability);
+    else
+        glDisable(capability);
+    capabilities.insert(capability, enabled);
+}
+
+void GlStateCache::depthMask(GLboolean flag) noexcept{
+    if(!changes(depthMaskValue == flag))
+        return;
+    glDepthMask(flag);
+    depthMaskValue = flag;
+}
+
+void GlStateCache::depthFunc(GLenum func) noexcept{
+    if(!changes(depthFuncValue == func))
+        return;
+    glDepthFunc(func);
+    depthFuncValue = func;
+}
+
+void GlStateCache::useProgram(GLuint program) noexcept{
+    if(!changes(this->program == program))
+        return;
+    glUseProgram(program);
+    this->program = program;
+}
+
+void GlStateCache::bindVertexArray(GLuint array) noexcept{
+    if(!changes(vertexArray == array))
+        return;
+    glBindVertexArray(array);
+    vertexArray = array;
+}
+
+/**
+ * @brief GlStateCache::bindTexture
+ * @param unit Index of the texture unit, starting at 0
+ * @param target Texture target like GL_TEXTURE_2D
+ * @param texture Texture name
+ *
+ * Binds texture to unit, switching the active unit only
+ * if the binding actually changes.
+ */
+void GlStateCache::bindTexture(GLuint unit, GLenum target, GLuint texture) noexcept{
+    if(GLuint(textures.size()) <= unit)
+        textures.resize(unit + 1);
+    auto &bindings = textures[unit];
+    auto it = bindings.find(target);
+    if(!changes(it != bindings.end() && *it == texture))
+        return;
+    activeTexture(unit);
+    glBindTexture(target, texture);
+    bindings.insert(target, texture);
+}
+
+void GlStateCache::activeTexture(GLuint unit) noexcept{
+    if(!changes(activeUnit == unit))
+        return;
+    glActiveTexture(GL_TEXTURE0 + unit);
+    activeUnit = unit;
+}
+
+/**
+ * @brief GlStateCache::issued
+ * @return Number of GL calls made since the last reset
+ */
+quint64 GlStateCache::issued() const noexcept{
+    return issuedCount;
+}
+
+/**
+ * @brief GlStateCache::elided
+ * @return Number of GL calls skipped since the last reset
+ */
+quint64 GlStateCache::elided() const noexcept{
+    return elidedCount;
+}
+
+void GlStateCache::resetCounters() noexcept{
+    issuedCount = elidedCount = 0;
+}
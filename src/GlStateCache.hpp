@@ -0,0 +1,60 @@
+#ifndef GLSTATECACHE_HPP
+#define GLSTATECACHE_HPP
+
+#include <QHash>
+#include <QVector>
+#include <QOpenGLFunctions_3_3_Core>
+
+/**
+ * @brief The GlStateCache class
+ *
+ * Shadows the parts of the GL state the renderer sets every
+ * frame and skips calls that would not change anything. It
+ * counts the calls it issued and the ones it elided.
+ *
+ * The shadow only stays correct as long as the state is
+ * changed through the cache. Code that changes it behind the
+ * cache's back has to call forgetBinding() or invalidate().
+ * One cache belongs to exactly one context.
+ */
+class GlStateCache : protected QOpenGLFunctions_3_3_Core{
+public:
+    GlStateCache();
+    void invalidate() noexcept;
+    void forgetBinding(GLenum target) noexcept;
+
+    void viewport(GLint x, GLint y, GLsizei width, GLsizei height) noexcept;
+    void clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) noexcept;
+    void clearDepth(GLdouble depth) noexcept;
+    void polygonMode(GLenum mode) noexcept;
+    void setEnabled(GLenum capability, bool enabled) noexcept;
+    void depthMask(GLboolean flag) noexcept;
+    void depthFunc(GLenum func) noexcept;
+    void useProgram(GLuint program) noexcept;
+    void bindVertexArray(GLuint array) noexcept;
+    void bindTexture(GLuint unit, GLenum target, GLuint texture) noexcept;
+
+    quint64 issued() const noexcept;
+    quint64 elided() const noexcept;
+    void resetCounters() noexcept;
+
+private:
+    GlStateCache(const GlStateCache &);
+    GlStateCache& operator=(const GlStateCache& rhs);
+
+    bool changes(bool same) noexcept;
+    void activeTexture(GLuint unit) noexcept;
+
+    GLint viewportBox[4];
+    GLfloat clearColors[4];
+    GLdouble clearDepthValue;
+    GLenum polygonModeValue, depthFuncValue;
+    GLboolean depthMaskValue;
+    GLuint program, vertexArray, activeUnit;
+    QHash<GLenum, bool> capabilities;
+    QVector<QHash<GLenum, GLuint>> textures;
+
+    quint64 issuedCount, elidedCount;
+};
+
+#endif // GLSTATECACHE_HPP
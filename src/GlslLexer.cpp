@@ -0,0 +1,206 @@
+#include "GlslLexer.hpp"
+
+#include <cctype>
+
+/**
+ * @brief GlslLexer::GlslLexer
+ *
+ * Creates a lexer without keywords.
+ */
+GlslLexer::GlslLexer() : children(alphabetSize, 0), terminal(1, false)
+{ }
+
+/**
+ * @brief GlslLexer::GlslLexer
+ * @param keywords Words to report as keywords
+ */
+GlslLexer::GlslLexer(const QStringList &keywords) : GlslLexer(){
+    for(auto &keyword : keywords)
+        addKeyword(keyword);
+}
+
+/**
+ * @brief GlslLexer::addKeyword
+ * @param keyword A word of letters, digits and underscores
+ */
+void GlslLexer::addKeyword(const QString &keyword) noexcept{
+    if(keyword.isEmpty())
+        return;
+    int node = 0;
+    for(auto c : keyword){
+        int index = charIndex(c);
+        if(index < 0)
+            return;
+        int &child = children[node * alphabetSize + index];
+        if(child == 0){
+            child = terminal.size();
+            terminal.append(false);
+            children.resize(children.size() + alphabetSize);
+        }
+        // children may have moved
+        node = children[node * alphabetSize + index];
+    }
+    terminal[node] = true;
+}
+
+/**
+ * @brief GlslLexer::isKeyword
+ * @param text Start of an identifier
+ * @param length Its length
+ * @return True if it is one of the keywords
+ */
+bool GlslLexer::isKeyword(const QChar *text, int length) const noexcept{
+    int node = 0;
+    for(int i = 0; i < length && node >= 0; ++i){
+        int index = charIndex(text[i]);
+        node = index < 0 ? -1 : children[node * alphabetSize + index];
+        if(node == 0)
+            return false;
+    }
+    return node > 0 && terminal[node];
+}
+
+/**
+ * @brief GlslLexer::tokenize
+ * @param text One line
+ * @param state The state the line before ended in
+ * @param tokens Receives the spans to colour, in order
+ * @return The state this line ends in
+ *
+ * Everything that is not reported is plain code. A directive
+ * runs to the end of the line or to a comment in it.
+ */
+GlslLexer::State GlslLexer::tokenize(const QString &text, State state, QVector<Token> &tokens) const noexcept{
+    const QChar *data = text.constData();
+    const int length = text.length();
+    int i = 0;
+
+    if(state == InComment){
+        int end = text.indexOf(QLatin1String("*/"));
+        if(end < 0){
+            tokens.append(Token{0, length, Token::Comment});
+            return InComment;
+        }
+        tokens.append(Token{0, end + 2, Token::Comment});
+        i = end + 2;
+    }
+
+    // Only comments and spaces may precede a directive
+    bool lineStart = true;
+    while(i < length){
+        QChar c = data[i];
+        if(c.isSpace()){
+            ++i;
+            continue;
+        }
+
+        QChar next = i + 1 < length ? data[i + 1] : QChar();
+        if(c == '/' && next == '/'){
+            tokens.append(Token{i, length - i, Token::Comment});
+            return Normal;
+        }
+        if(c == '/' && next == '*'){
+            int end = text.indexOf(QLatin1String("*/"), i + 2);
+            if(end < 0){
+                tokens.append(Token{i, length - i, Token::Comment});
+                return InComment;
+            }
+            tokens.append(Token{i, end + 2 - i, Token::Comment});
+            i = end + 2;
+            continue;
+        }
+
+        int start = i;
+        if(c == '#' && lineStart){
+            while(i < length && !(data[i] == '/' && i + 1 < length && (data[i + 1] == '/' || data[i + 1] == '*')))
+                ++i;
+            tokens.append(Token{start, i - start, Token::Directive});
+        } else if(c == '"'){
+            for(++i; i < length && data[i] != '"'; ++i)
+                if(data[i] == '\\')
+                    ++i;
+            i = qMin(i + 1, length);
+            tokens.append(Token{start, i - start, Token::String});
+        } else if(c.isDigit() || (c == '.' && next.isDigit())){
+            i = number(data, i, length);
+            tokens.append(Token{start, i - start, Token::Number});
+        } else if(isIdentifierStart(c)){
+            while(i < length && charIndex(data[i]) >= 0)
+                ++i;
+            if(i - start > 3 && data[start + 2] == '_' && (text.midRef(start, 2) == QLatin1String("gl")
+                                                          || text.midRef(start, 2) == QLatin1String("GL")))
+                tokens.append(Token{start, i - start, Token::GlIdentifier});
+            else if(isKeyword(data + start, i - start))
+                tokens.append(Token{start, i - start, Token::Keyword});
+        } else
+            ++i;
+        lineStart = false;
+    }
+    return Normal;
+}
+
+/**
+ * @brief GlslLexer::charIndex
+ * @param c A character
+ * @return Its index in the trie, or -1 if identifiers cannot hold it
+ */
+int GlslLexer::charIndex(QChar c) noexcept{
+    ushort u = c.unicode();
+    if(u >= 'a' && u <= 'z')
+        return u - 'a';
+    if(u >= 'A' && u <= 'Z')
+        return 26 + u - 'A';
+    if(u >= '0' && u <= '9')
+        return 52 + u - '0';
+    if(u == '_')
+        return 62;
+    return -1;
+}
+
+/**
+ * @brief GlslLexer::isIdentifierStart
+ * @param c A character
+ * @return True if an identifier may start with c
+ */
+bool GlslLexer::isIdentifierStart(QChar c) noexcept{
+    int index = charIndex(c);
+    return index >= 0 && (index < 52 || index == 62);
+}
+
+/**
+ * @brief GlslLexer::number
+ * @param text A line
+ * @param i Start of a number in it
+ * @param length Length of the line
+ * @return The end of the number
+ *
+ * Reads decimal, octal and hexadecimal integers and floats
+ * with exponent and the u, f and lf suffixes.
+ */
+int GlslLexer::number(const QChar *text, int i, int length) noexcept{
+    auto at = [&](int j){ return j < length ? text[j].toLatin1() : '\0'; };
+    auto digits = [&](){ while(i < length && text[i].isDigit()) ++i; };
+
+    if(at(i) == '0' && (at(i + 1) == 'x' || at(i + 1) == 'X')){
+        i += 2;
+        while(i < length && isxdigit(at(i)))
+            ++i;
+    } else {
+        digits();
+        if(at(i) == '.'){
+            ++i;
+            digits();
+        }
+        if((at(i) == 'e' || at(i) == 'E')
+                && (isdigit(at(i + 1)) || ((at(i + 1) == '+' || at(i + 1) == '-') && isdigit(at(i + 2))))){
+            i += 2;
+            digits();
+        }
+    }
+
+    if(at(i) == 'u' || at(i) == 'U' || at(i) == 'f' || at(i) == 'F')
+        ++i;
+    else if((at(i) == 'l' && at(i + 1) == 'f') || (at(i) == 'L' && at(i + 1) == 'F'))
+        i += 2;
+    return i;
+}
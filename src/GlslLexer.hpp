@@ -0,0 +1,47 @@
+#ifndef GLSLLEXER_HPP
+#define GLSLLEXER_HPP
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief The GlslLexer class
+ *
+ * Splits one line of GLSL into the spans the CodeHighlighter
+ * colours, in a single walk over the characters. Keywords are
+ * looked up in a trie of the characters identifiers may hold,
+ * so the cost of a line does not grow with the keyword count.
+ *
+ * A block comment may span lines: tokenize() takes the state
+ * the previous line ended in and returns the one of this line.
+ */
+class GlslLexer{
+public:
+    enum State{ Normal = 0, InComment = 1 };
+
+    struct Token{
+        enum Kind{ Keyword, Number, Comment, Directive, GlIdentifier, String };
+        int start;
+        int length;
+        Kind kind;
+    };
+
+    GlslLexer();
+    explicit GlslLexer(const QStringList &keywords);
+    void addKeyword(const QString &keyword) noexcept;
+    bool isKeyword(const QChar *text, int length) const noexcept;
+    State tokenize(const QString &text, State state, QVector<Token> &tokens) const noexcept;
+
+private:
+    static const int alphabetSize = 63;
+    static int charIndex(QChar c) noexcept;
+    static bool isIdentifierStart(QChar c) noexcept;
+    static int number(const QChar *text, int i, int length) noexcept;
+
+    // Node n has its children at n * alphabetSize, zero is none
+    QVector<int> children;
+    QVector<bool> terminal;
+};
+
+#endif // GLSLLEXER_HPP
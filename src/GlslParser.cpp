@@ -0,0 +1,560 @@
+#include "GlslParser.hpp"
+
+#include <QRegExp>
+#include <QSet>
+
+/**
+ * @brief GlslParseResult::find
+ * @param name An identifier
+ * @return The symbol that declares name, or null
+ */
+const GlslSymbol *GlslParseResult::find(const QString &name) const noexcept{
+    for(auto &symbol : symbols)
+        if(symbol.name == name && symbol.kind != GlslSymbol::Include)
+            return &symbol;
+    return 0;
+}
+
+/**
+ * @brief GlslParser::GlslParser
+ */
+GlslParser::GlslParser() : parsedCount(0)
+{ }
+
+/**
+ * @brief GlslParser::chunksParsed
+ * @return Number of chunks analysed so far, cached ones excluded
+ */
+quint64 GlslParser::chunksParsed() const noexcept{
+    return parsedCount;
+}
+
+/**
+ * @brief GlslParser::parse
+ * @param source The code of a document
+ * @return Its symbols and syntax errors
+ *
+ * Chunks that did not change since the last call are taken
+ * from the cache; chunks that are gone are dropped from it.
+ */
+GlslParseResult GlslParser::parse(const QString &source) noexcept{
+    GlslParseResult result;
+    QList<ShaderDiagnostic> scanErrors;
+    auto chunks = split(source, scanErrors);
+
+    QHash<QString, ChunkResult> used;
+    for(auto &chunk : chunks){
+        // Whether the chunk is complete changes its errors
+        QString key = (chunk.terminated ? ";" : "") + source.mid(chunk.start, chunk.end - chunk.start);
+        ChunkResult chunkResult;
+        auto cached = cache.constFind(key);
+        if(cached != cache.constEnd())
+            chunkResult = *cached;
+        else {
+            chunkResult = analyze(source.mid(chunk.start, chunk.end - chunk.start), chunk.terminated);
+            ++parsedCount;
+        }
+        used.insert(key, chunkResult);
+
+        // Chunk results count from the start of the chunk
+        for(auto symbol : chunkResult.symbols){
+            if(symbol.line == 1)
+                symbol.column += chunk.column - 1;
+            symbol.line += chunk.line - 1;
+            result.symbols.append(symbol);
+        }
+        for(auto error : chunkResult.errors){
+            if(error.line == 1)
+                error.column += chunk.column - 1;
+            error.line += chunk.line - 1;
+            result.errors.append(error);
+        }
+    }
+    cache.swap(used);
+    result.errors += scanErrors;
+    return result;
+}
+
+/**
+ * @brief GlslParser::split
+ * @param source The code of a document
+ * @param errors Receives comments that do not end
+ * @return The top-level chunks of source
+ *
+ * Skips comments and strings and counts braces. A chunk ends
+ * with a semicolon outside of braces, with the closing brace
+ * of a function body or with the line of a directive.
+ */
+QVector<GlslParser::Chunk> GlslParser::split(const QString &source, QList<ShaderDiagnostic> &errors) noexcept{
+    QVector<Chunk> chunks;
+    const QChar *data = source.constData();
+    const int length = source.length();
+    int line = 1, lineOffset = 0, depth = 0;
+    bool lineStart = true, functionBody = false;
+    QChar last;
+    Chunk chunk{-1, -1, 0, 0, false};
+
+    auto endChunk = [&](int end){
+        chunk.end = end;
+        chunk.terminated = true;
+        chunks.append(chunk);
+        chunk.start = -1;
+    };
+
+    int i = 0;
+    while(i < length){
+        QChar c = data[i];
+        QChar next = i + 1 < length ? data[i + 1] : QChar();
+
+        if(c == '\n'){
+            ++line;
+            lineOffset = ++i;
+            lineStart = true;
+            continue;
+        }
+        if(c.isSpace()){
+            ++i;
+            continue;
+        }
+        if(c == '/' && next == '/'){
+            while(i < length && data[i] != '\n')
+                ++i;
+            continue;
+        }
+        if(c == '/' && next == '*'){
+            int end = source.indexOf(QLatin1String("*/"), i + 2);
+            if(end < 0){
+                errors.append(ShaderDiagnostic{ShaderDiagnostic::Error, QString(), line, i - lineOffset + 1,
+                                               "unterminated comment"});
+                end = length - 2;
+            }
+            for(; i < end + 2; ++i)
+                if(data[i] == '\n'){
+                    ++line;
+                    lineOffset = i + 1;
+                }
+            continue;
+        }
+        if(c == '#' && lineStart){
+            int end = i;
+            while(end < length && data[end] != '\n')
+                ++end;
+            // Directives inside declarations stay part of them
+            if(chunk.start < 0 && depth == 0){
+                chunk = Chunk{i, end, line, i - lineOffset + 1, true};
+                endChunk(end);
+            }
+            i = end;
+            continue;
+        }
+
+        if(chunk.start < 0)
+            chunk = Chunk{i, -1, line, i - lineOffset + 1, false};
+        lineStart = false;
+
+        if(c == '"'){
+            for(++i; i < length && data[i] != '"' && data[i] != '\n'; ++i)
+                if(data[i] == '\\')
+                    ++i;
+            if(i < length && data[i] == '"')
+                ++i;
+            last = '"';
+            continue;
+        }
+
+        if(c == '{'){
+            if(depth == 0)
+                functionBody = last == ')';
+            ++depth;
+        } else if(c == '}'){
+            if(depth == 0)
+                endChunk(i + 1);
+            else if(--depth == 0 && functionBody)
+                endChunk(i + 1);
+        } else if(c == ';' && depth == 0)
+            endChunk(i + 1);
+        last = c;
+        ++i;
+    }
+
+    if(chunk.start >= 0){
+        chunk.end = length;
+        chunks.append(chunk);
+    }
+    return chunks;
+}
+
+/**
+ * @brief GlslParser::analyze
+ * @param text The code of one chunk
+ * @param terminated False if the document ended inside it
+ * @return Its symbols and errors, counted from its start
+ */
+GlslParser::ChunkResult GlslParser::analyze(const QString &text, bool terminated) noexcept{
+    ChunkResult result;
+    if(text.startsWith('#')){
+        directive(text, result);
+        return result;
+    }
+
+    auto tokens = tokenize(text);
+    if(tokens.isEmpty())
+        return result;
+
+    checkBrackets(tokens, result);
+    if(result.errors.isEmpty())
+        checkSemicolons(tokens, result);
+    if(!ShaderDiagnostics::hasErrors(result.errors) && !terminated)
+        result.errors.append(error(tokens.last(), "expected ';' after '" + tokens.last().text + "'"));
+    declaration(tokens, result);
+    return result;
+}
+
+/**
+ * @brief GlslParser::tokenize
+ * @param text The code of one chunk
+ * @return Its tokens without comments and directive lines
+ */
+QVector<GlslParser::Token> GlslParser::tokenize(const QString &text) noexcept{
+    QVector<Token> tokens;
+    const QChar *data = text.constData();
+    const int length = text.length();
+    int line = 1, lineOffset = 0;
+    bool lineStart = true;
+
+    int i = 0;
+    while(i < length){
+        QChar c = data[i];
+        QChar next = i + 1 < length ? data[i + 1] : QChar();
+
+        if(c == '\n'){
+            ++line;
+            lineOffset = ++i;
+            lineStart = true;
+            continue;
+        }
+        if(c.isSpace()){
+            ++i;
+            continue;
+        }
+        if((c == '/' && next == '/') || (c == '#' && lineStart)){
+            while(i < length && data[i] != '\n')
+                ++i;
+            continue;
+        }
+        if(c == '/' && next == '*'){
+            int end = text.indexOf(QLatin1String("*/"), i + 2);
+            end = end < 0 ? length : end + 2;
+            for(; i < end; ++i)
+                if(data[i] == '\n'){
+                    ++line;
+                    lineOffset = i + 1;
+                }
+            continue;
+        }
+
+        lineStart = false;
+        int start = i;
+        Token::Type type;
+        if(c.isLetter() || c == '_'){
+            while(i < length && (data[i].isLetterOrNumber() || data[i] == '_'))
+                ++i;
+            type = Token::Identifier;
+        } else if(c.isDigit() || (c == '.' && next.isDigit())){
+            for(++i; i < length; ++i){
+                QChar d = data[i];
+                bool sign = (d == '+' || d == '-') && (data[i - 1] == 'e' || data[i - 1] == 'E')
+                        && !text.midRef(start, 2).startsWith(QLatin1String("0x"), Qt::CaseInsensitive);
+                if(!d.isLetterOrNumber() && d != '.' && !sign)
+                    break;
+            }
+            type = Token::Number;
+        } else if(c == '"'){
+            for(++i; i < length && data[i] != '"' && data[i] != '\n'; ++i)
+                if(data[i] == '\\')
+                    ++i;
+            i = qMin(i + 1, length);
+            type = Token::String;
+        } else {
+            ++i;
+            type = Token::Punctuation;
+        }
+        tokens.append(Token{type, text.mid(start, i - start), line, start - lineOffset + 1});
+    }
+    return tokens;
+}
+
+/**
+ * @brief GlslParser::directive
+ * @param text A directive line
+ * @param result Receives the symbol it declares, if any
+ */
+void GlslParser::directive(const QString &text, ChunkResult &result) noexcept{
+    QRegExp include("^#\\s*include\\s*[\"<]([^\">]+)[\">]");
+    QRegExp resource("^#\\s*(texture|video)\\s+([A-Za-z_][A-Za-z0-9_]*)\\s+(.+)$");
+    QRegExp define("^#\\s*define\\s+([A-Za-z_][A-Za-z0-9_]*)");
+
+    if(include.indexIn(text) != -1)
+        result.symbols.append(GlslSymbol{GlslSymbol::Include, include.cap(1), include.cap(1),
+                                         1, include.pos(1) + 1});
+    else if(resource.indexIn(text) != -1)
+        result.symbols.append(GlslSymbol{resource.cap(1) == "texture" ? GlslSymbol::Texture : GlslSymbol::Video,
+                                         resource.cap(2), resource.cap(3).trimmed(), 1, resource.pos(2) + 1});
+    else if(define.indexIn(text) != -1)
+        result.symbols.append(GlslSymbol{GlslSymbol::Macro, define.cap(1), QString(), 1, define.pos(1) + 1});
+}
+
+/**
+ * @brief GlslParser::declaration
+ * @param tokens The tokens of one top-level chunk
+ * @param result Receives the symbols it declares
+ *
+ * Handles functions, structs, interface blocks and variables
+ * with their qualifiers. Prototypes declare nothing.
+ */
+void GlslParser::declaration(const QVector<Token> &tokens, ChunkResult &result) noexcept{
+    static const QSet<QString> qualifiers{
+        "uniform", "in", "out", "inout", "const", "attribute", "varying", "buffer", "shared",
+        "flat", "smooth", "noperspective", "centroid", "sample", "patch", "invariant", "precise",
+        "highp", "mediump", "lowp", "coherent", "volatile", "restrict", "readonly", "writeonly"};
+
+    const int count = tokens.size();
+    if(tokens[0].text == "precision")
+        return;
+
+    GlslSymbol::Kind kind = GlslSymbol::Variable;
+    int k = 0;
+    while(k < count){
+        auto &text = tokens[k].text;
+        if(text == "layout" && k + 1 < count && tokens[k + 1].text == "(")
+            k = matching(tokens, k + 1) + 1;
+        else if(qualifiers.contains(text)){
+            if(text == "uniform")
+                kind = GlslSymbol::Uniform;
+            else if(text == "in" || text == "attribute" || text == "varying")
+                kind = GlslSymbol::Input;
+            else if(text == "out")
+                kind = GlslSymbol::Output;
+            else if(text == "const" && kind == GlslSymbol::Variable)
+                kind = GlslSymbol::Constant;
+            ++k;
+        } else
+            break;
+    }
+    if(k >= count || tokens[k].type != Token::Identifier)
+        return;
+
+    if(tokens[k].text == "struct"){
+        int open = k + 1;
+        if(open < count && tokens[open].type == Token::Identifier){
+            result.symbols.append(GlslSymbol{GlslSymbol::Struct, tokens[open].text, "struct",
+                                             tokens[open].line, tokens[open].column});
+            ++open;
+        }
+        if(open < count && tokens[open].text == "{"){
+            int close = matching(tokens, open);
+            declarators(tokens, close, count, kind, result);
+        }
+        return;
+    }
+
+    // Interface block: uniform Name { members } instance;
+    if(k + 1 < count && tokens[k + 1].text == "{"){
+        auto blockKind = kind == GlslSymbol::Uniform ? GlslSymbol::UniformBlock : kind;
+        result.symbols.append(GlslSymbol{blockKind, tokens[k].text, "block", tokens[k].line, tokens[k].column});
+        int close = matching(tokens, k + 1);
+        int member = k + 2;
+        for(int i = member; i < close; ++i){
+            if(tokens[i].text != ";")
+                continue;
+            declarators(tokens, member, i, kind, result);
+            member = i + 1;
+        }
+        if(close + 1 < count)
+            declarators(tokens, close, count, kind, result);
+        return;
+    }
+
+    // Function definition: type name(parameters) { body }
+    for(int i = k + 1; i < count; ++i){
+        auto &text = tokens[i].text;
+        if(text == "=" || text == ";" || text == "{")
+            break;
+        if(text != "(")
+            continue;
+        int close = matching(tokens, i);
+        if(tokens[i - 1].type != Token::Identifier || close + 1 >= count || tokens[close + 1].text != "{")
+            return;
+        QStringList signature;
+        for(int j = k; j <= close; ++j)
+            signature.append(tokens[j].text);
+        auto detail = signature.join(' ').replace(" (", "(").replace("( ", "(").replace(" )", ")").replace(" ,", ",");
+        result.symbols.append(GlslSymbol{GlslSymbol::Function, tokens[i - 1].text, detail,
+                                         tokens[i - 1].line, tokens[i - 1].column});
+        return;
+    }
+
+    declarators(tokens, k, count, kind, result);
+}
+
+/**
+ * @brief GlslParser::declarators
+ * @param tokens The tokens of a chunk
+ * @param from Index of the type, or of the '}' before the names
+ * @param to End of the declaration
+ * @param kind Kind of the declared names
+ * @param result Receives a symbol per name
+ *
+ * Reads "type name[n] = value, name;" and skips qualifiers
+ * in front of the type.
+ */
+void GlslParser::declarators(const QVector<Token> &tokens, int from, int to, GlslSymbol::Kind kind, ChunkResult &result) noexcept{
+    static const QSet<QString> qualifiers{
+        "uniform", "in", "out", "inout", "const", "flat", "smooth", "noperspective", "centroid",
+        "invariant", "precise", "highp", "mediump", "lowp"};
+
+    int i = from;
+    while(i < to && (qualifiers.contains(tokens[i].text)
+                     || (tokens[i].text == "layout" && i + 1 < to && tokens[i + 1].text == "("))){
+        i = tokens[i].text == "layout" ? matching(tokens, i + 1) + 1 : i + 1;
+    }
+    if(i >= to)
+        return;
+    QString type = tokens[i].text == "}" ? QString() : tokens[i].text;
+    bool expectName = true;
+
+    for(++i; i < to; ++i){
+        auto &token = tokens[i];
+        if(expectName && token.type == Token::Identifier){
+            result.symbols.append(GlslSymbol{kind, token.text, type, token.line, token.column});
+            expectName = false;
+        } else if(token.text == "[" || token.text == "(" || token.text == "{")
+            i = matching(tokens, i);
+        else if(token.text == "="){
+            // Skip the initializer up to the next name
+            for(++i; i < to && tokens[i].text != "," && tokens[i].text != ";"; ++i)
+                if(tokens[i].text == "(" || tokens[i].text == "[" || tokens[i].text == "{")
+                    i = matching(tokens, i);
+            --i;
+        } else if(token.text == ",")
+            expectName = true;
+        else if(token.text == ";")
+            return;
+    }
+}
+
+/**
+ * @brief GlslParser::checkBrackets
+ * @param tokens The tokens of a chunk
+ * @param result Receives the first bracket that does not match
+ */
+void GlslParser::checkBrackets(const QVector<Token> &tokens, ChunkResult &result) noexcept{
+    static const QString open = "([{", close = ")]}";
+    QVector<int> stack;
+    for(int i = 0; i < tokens.size(); ++i){
+        auto &token = tokens[i];
+        if(token.type != Token::Punctuation)
+            continue;
+        // Statements end outside of parentheses, except in for
+        if(token.text == ";" && !stack.isEmpty() && tokens[stack.last()].text != "{"
+                && !(stack.last() > 0 && tokens[stack.last() - 1].text == "for")){
+            result.errors.append(error(token, QString("expected '%1' before ';'")
+                                       .arg(close[open.indexOf(tokens[stack.last()].text)])));
+            return;
+        }
+        if(open.contains(token.text)){
+            stack.append(i);
+            continue;
+        }
+        int kind = close.indexOf(token.text);
+        if(kind < 0)
+            continue;
+        if(stack.isEmpty()){
+            result.errors.append(error(token, "unexpected '" + token.text + "'"));
+            return;
+        }
+        auto &opening = tokens[stack.takeLast()];
+        if(open.indexOf(opening.text) != kind){
+            result.errors.append(error(token, QString("expected '%1' before '%2'")
+                                       .arg(close[open.indexOf(opening.text)]).arg(token.text)));
+            return;
+        }
+    }
+    if(!stack.isEmpty())
+        result.errors.append(error(tokens[stack.first()], "unmatched '" + tokens[stack.first()].text + "'"));
+}
+
+/**
+ * @brief GlslParser::checkSemicolons
+ * @param tokens The tokens of a chunk with matching brackets
+ * @param result Receives statements without a semicolon
+ *
+ * Inside braces, a line that ends like a statement and a next
+ * line that starts like one need a semicolon between them.
+ * Conditions of if, for, while and switch, and else and do
+ * are followed by a statement instead. This is a guess from
+ * the layout of the lines, so it only yields warnings.
+ */
+void GlslParser::checkSemicolons(const QVector<Token> &tokens, ChunkResult &result) noexcept{
+    static const QSet<QString> control{"if", "for", "while", "switch"};
+    static const QSet<QString> continued{"else", "do", "return", "case", "default",
+                                         "const", "in", "out", "inout", "uniform", "highp", "mediump", "lowp",
+                                         "flat", "smooth", "noperspective", "centroid", "invariant", "precise"};
+    int braces = 0;
+    // For each open parenthesis, whether it holds a condition
+    QVector<bool> parens;
+    bool closedCondition = false;
+
+    for(int i = 0; i + 1 < tokens.size(); ++i){
+        auto &token = tokens[i];
+        closedCondition = false;
+        if(token.text == "{")
+            ++braces;
+        else if(token.text == "}")
+            --braces;
+        else if(token.text == "(")
+            parens.append(i > 0 && control.contains(tokens[i - 1].text));
+        else if(token.text == ")" && !parens.isEmpty())
+            closedCondition = parens.takeLast();
+
+        auto &next = tokens[i + 1];
+        if(braces < 1 || !parens.isEmpty() || next.line == token.line || next.type != Token::Identifier)
+            continue;
+        bool ends = (token.type == Token::Identifier && !continued.contains(token.text))
+                || token.type == Token::Number || token.text == "]" || (token.text == ")" && !closedCondition);
+        if(ends){
+            auto diagnostic = error(token, "expected ';' after '" + token.text + "'");
+            diagnostic.severity = ShaderDiagnostic::Warning;
+            diagnostic.column += token.text.length();
+            result.errors.append(diagnostic);
+        }
+    }
+}
+
+/**
+ * @brief GlslParser::matching
+ * @param tokens The tokens of a chunk
+ * @param open Index of an opening bracket
+ * @return Index of its closing bracket, or of the last token
+ */
+int GlslParser::matching(const QVector<Token> &tokens, int open) noexcept{
+    int depth = 0;
+    for(int i = open; i < tokens.size(); ++i){
+        auto &text = tokens[i].text;
+        if(text == "(" || text == "[" || text == "{")
+            ++depth;
+        else if((text == ")" || text == "]" || text == "}") && --depth == 0)
+            return i;
+    }
+    return tokens.size() - 1;
+}
+
+/**
+ * @brief GlslParser::error
+ * @param token Where the error is
+ * @param message What it is
+ * @return An error diagnostic at token
+ */
+ShaderDiagnostic GlslParser::error(const Token &token, const QString &message) noexcept{
+    return ShaderDiagnostic{ShaderDiagnostic::Error, QString(), token.line, token.column, message};
+}
@@ -0,0 +1,108 @@
+#ifndef GLSLPARSER_HPP
+#define GLSLPARSER_HPP
+
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QMetaType>
+
+#include "ShaderDiagnostics.hpp"
+
+/**
+ * @brief The GlslSymbol struct
+ *
+ * A name declared at the top level of a shader. Lines and
+ * columns count from one. Members of a uniform block are
+ * uniforms of their own, as shaders use them without the
+ * block name.
+ */
+struct GlslSymbol{
+    enum Kind{ Function, Struct, Uniform, UniformBlock, Input, Output,
+               Constant, Variable, Macro, Include, Texture, Video };
+
+    Kind kind;
+    QString name;
+    // Signature of functions, type of variables, path of files
+    QString detail;
+    int line;
+    int column;
+};
+
+/**
+ * @brief The GlslParseResult struct
+ *
+ * The symbols of a shader in the order of the code, and the
+ * syntax errors found without compiling it. Missing
+ * semicolons are only guessed and come as warnings.
+ */
+struct GlslParseResult{
+    QList<GlslSymbol> symbols;
+    QList<ShaderDiagnostic> errors;
+
+    const GlslSymbol *find(const QString &name) const noexcept;
+};
+
+Q_DECLARE_METATYPE(GlslParseResult)
+
+/**
+ * @brief The GlslParser class
+ *
+ * A small GLSL front end for the editor. It does not check
+ * types, only the structure: brackets that do not match, a
+ * statement that misses its semicolon before the next line,
+ * an unterminated comment or declaration. What it finds
+ * before the driver does is reported right away.
+ *
+ * The code is cut into top-level chunks: a directive, a
+ * declaration up to its semicolon or a function up to its
+ * closing brace. Chunks are analysed once and cached by
+ * their text, so after an edit only the chunks that changed
+ * are parsed again; finding the chunks is a single cheap scan.
+ *
+ * A parser is not thread-safe; use one per document.
+ */
+class GlslParser{
+public:
+    GlslParser();
+    GlslParseResult parse(const QString &source) noexcept;
+    quint64 chunksParsed() const noexcept;
+
+private:
+    struct Token{
+        enum Type{ Identifier, Number, Punctuation, String };
+        Type type;
+        QString text;
+        int line;
+        int column;
+    };
+    struct Chunk{
+        int start;
+        int end;
+        int line;
+        int column;
+        bool terminated;
+    };
+    struct ChunkResult{
+        QList<GlslSymbol> symbols;
+        QList<ShaderDiagnostic> errors;
+    };
+
+    GlslParser(const GlslParser &);
+    GlslParser& operator=(const GlslParser& rhs);
+
+    static QVector<Chunk> split(const QString &source, QList<ShaderDiagnostic> &errors) noexcept;
+    static ChunkResult analyze(const QString &text, bool terminated) noexcept;
+    static QVector<Token> tokenize(const QString &text) noexcept;
+    static void directive(const QString &text, ChunkResult &result) noexcept;
+    static void declaration(const QVector<Token> &tokens, ChunkResult &result) noexcept;
+    static void declarators(const QVector<Token> &tokens, int from, int to, GlslSymbol::Kind kind, ChunkResult &result) noexcept;
+    static void checkBrackets(const QVector<Token> &tokens, ChunkResult &result) noexcept;
+    static void checkSemicolons(const QVector<Token> &tokens, ChunkResult &result) noexcept;
+    static int matching(const QVector<Token> &tokens, int open) noexcept;
+    static ShaderDiagnostic error(const Token &token, const QString &message) noexcept;
+
+    QHash<QString, ChunkResult> cache;
+    quint64 parsedCount;
+};
+
+#endif // GLSLPARSER_HPP
@@ -0,0 +1,80 @@
+#include "GlslParserThread.hpp"
+
+/**
+ * @brief GlslParserThread::GlslParserThread
+ * @param parent Parent object
+ */
+GlslParserThread::GlslParserThread(QObject *parent) :
+    QThread(parent), pendingRevision(0), pending(false), stopping(false)
+{
+    // Results are delivered to the GUI thread
+    qRegisterMetaType<GlslParseResult>("GlslParseResult");
+}
+
+/**
+ * @brief GlslParserThread::~GlslParserThread
+ *
+ * Waits for a parse that is running.
+ */
+GlslParserThread::~GlslParserThread(){
+    stop();
+}
+
+/**
+ * @brief GlslParserThread::request
+ * @param source Code to parse
+ * @param revision Number the result is tagged with
+ *
+ * Starts the thread if needed and returns immediately.
+ */
+void GlslParserThread::request(const QString &source, int revision) noexcept{
+    QMutexLocker lock(&mutex);
+    if(stopping)
+        return;
+    pendingSource = source;
+    pendingRevision = revision;
+    pending = true;
+    changed.wakeAll();
+    lock.unlock();
+    if(!isRunning())
+        start(QThread::LowPriority);
+}
+
+/**
+ * @brief GlslParserThread::stop
+ *
+ * Drops what is waiting and waits until the thread quit.
+ */
+void GlslParserThread::stop() noexcept{
+    mutex.lock();
+    stopping = true;
+    pending = false;
+    changed.wakeAll();
+    mutex.unlock();
+    wait();
+}
+
+/**
+ * @brief GlslParserThread::run
+ *
+ * Parses the latest request, then sleeps until the next.
+ */
+void GlslParserThread::run() noexcept{
+    GlslParser parser;
+    QMutexLocker lock(&mutex);
+    while(!stopping){
+        if(!pending){
+            changed.wait(&mutex);
+            continue;
+        }
+        QString source = pendingSource;
+        int revision = pendingRevision;
+        pending = false;
+        pendingSource.clear();
+
+        lock.unlock();
+        auto result = parser.parse(source);
+        Q_EMIT parsed(revision, result);
+        lock.relock();
+    }
+}
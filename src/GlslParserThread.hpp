@@ -0,0 +1,44 @@
+#ifndef GLSLPARSERTHREAD_HPP
+#define GLSLPARSERTHREAD_HPP
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include "GlslParser.hpp"
+
+/**
+ * @brief The GlslParserThread class
+ *
+ * Parses the code of one document off the GUI thread. Only the
+ * latest request counts: code that arrives while a parse runs
+ * replaces what was waiting, and each result carries the
+ * revision it was made for, so the editor drops stale ones.
+ * The parser and its chunk cache belong to this thread.
+ */
+class GlslParserThread : public QThread{
+    Q_OBJECT
+public:
+    explicit GlslParserThread(QObject *parent = 0);
+    ~GlslParserThread();
+    void request(const QString &source, int revision) noexcept;
+    void stop() noexcept;
+
+Q_SIGNALS:
+    void parsed(int revision, GlslParseResult result);
+
+protected:
+    void run() noexcept Q_DECL_OVERRIDE;
+
+private:
+    GlslParserThread(const GlslParserThread &);
+    GlslParserThread& operator=(const GlslParserThread& rhs);
+
+    QMutex mutex;
+    QWaitCondition changed;
+    QString pendingSource;
+    int pendingRevision;
+    bool pending, stopping;
+};
+
+#endif // GLSLPARSERTHREAD_HPP
@@ -4,6 +4,8 @@
 #include <QObject>
 #include <QVariant>
 
+#include "../ShaderDiagnostics.hpp"
+
 namespace Instances{
 /**
  * @brief The IInstance class
@@ -22,14 +24,14 @@ public:
     virtual void reportError(const QString &) = 0;
     virtual void reportWarning(const QString &) = 0;
     virtual void codeStopped() = 0;
-    virtual void highlightErroredVertexLine(int) = 0;
-    virtual void highlightErroredFragmentLine(int) = 0;
+    virtual void showVertexDiagnostics(const QList<ShaderDiagnostic> &) = 0;
+    virtual void showFragmentDiagnostics(const QList<ShaderDiagnostic> &) = 0;
     virtual QString vertexSourceCode() const = 0;
     virtual QString fragmentSourceCode() const = 0;
     virtual QString title() const = 0;
 
 Q_SIGNALS:
-    void runCode(IInstance *);
+    void runCode(IInstance *, bool live);
     void stopCode(IInstance *);
 
     void closing(IInstance *);
@@ -77,25 +77,25 @@ void WindowInstance::reportWarning(const QString &text)
 }
 
 /**
- * @brief WindowInstance::highlightErroredVertexLine
- * @param lineno
+ * @brief WindowInstance::showVertexDiagnostics
+ * @param diagnostics
  *
- * Highlight line number lineno as errored.
+ * Marks the lines of the diagnostics in the vertex code.
  */
-void WindowInstance::highlightErroredVertexLine(int lineno)
+void WindowInstance::showVertexDiagnostics(const QList<ShaderDiagnostic> &diagnostics)
 {
-    window->highlightErroredVertexLine(lineno);
+    window->showVertexDiagnostics(diagnostics);
 }
 
 /**
- * @brief WindowInstance::highlightErroredFragmentLine
- * @param lineno
+ * @brief WindowInstance::showFragmentDiagnostics
+ * @param diagnostics
  *
- * Highlight line number lineno as errored.
+ * Marks the lines of the diagnostics in the fragment code.
  */
-void WindowInstance::highlightErroredFragmentLine(int lineno)
+void WindowInstance::showFragmentDiagnostics(const QList<ShaderDiagnostic> &diagnostics)
 {
-    window->highlightErroredFragmentLine(lineno);
+    window->showFragmentDiagnostics(diagnostics);
 }
 
 /**
@@ -199,12 +199,13 @@ void WindowInstance::gotDestroying(QObject*)
 
 /**
  * @brief WindowInstance::gotRunCode
+ * @param live True if the run follows an edit in live mode
  *
  * Signals that the editor requested a run.
  */
-void WindowInstance::gotRunCode(EditorWindow *)
+void WindowInstance::gotRunCode(EditorWindow *, bool live)
 {
-    Q_EMIT runCode(this);
+    Q_EMIT runCode(this, live);
 }
 
 /**
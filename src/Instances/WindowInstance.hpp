@@ -23,8 +23,8 @@ public:
     virtual bool close();
     virtual void reportError(const QString &message);
     virtual void reportWarning(const QString &);
-    virtual void highlightErroredVertexLine(int);
-    virtual void highlightErroredFragmentLine(int);
+    virtual void showVertexDiagnostics(const QList<ShaderDiagnostic> &);
+    virtual void showFragmentDiagnostics(const QList<ShaderDiagnostic> &);
     virtual void codeStopped();
 
 private:
@@ -39,7 +39,7 @@ public Q_SLOTS:
     void gotDestroying(QObject*);
     void gotClosing(EditorWindow *);
     void gotCloseAll(EditorWindow *);
-    void gotRunCode(EditorWindow *);
+    void gotRunCode(EditorWindow *, bool live);
     void gotStopCode(EditorWindow *);
     void gotOpenHelp(EditorWindow *);
     void gotOpenSettings(EditorWindow *);
@@ -6,7 +6,10 @@
 #include <iostream>
 #include <sstream>
 
+#include <QThreadPool>
+
 #include "Model3D.hpp"
+#include "GlStateCache.hpp"
 
 using namespace std;
 
@@ -34,6 +37,24 @@ bool Model3D::init() noexcept{
 }
 
 bool Model3D::loadModel(const std::string &path, bool smooth) noexcept{
+    Mesh mesh;
+    if(!parse(path, smooth, mesh))
+        return false;
+    upload(mesh);
+    return true;
+}
+
+std::shared_ptr<PendingMesh> Model3D::request(const std::string &path, bool smooth) noexcept{
+    auto mesh = std::make_shared<PendingMesh>(path);
+    QThreadPool::globalInstance()->start(new MeshDecoder(mesh, smooth));
+    return mesh;
+}
+
+void Model3D::upload(const Mesh &mesh) noexcept{
+    pushData(mesh.vertices, mesh.uvs, mesh.normals, mesh.indices);
+}
+
+bool Model3D::parse(const std::string &path, bool smooth, Mesh &mesh) noexcept{
 //    cout << "Loading model: " << path << endl;
     ifstream file(path);
     if(!file){
@@ -109,8 +130,8 @@ bool Model3D::loadModel(const std::string &path, bool smooth) noexcept{
     file.close();
 
 
-    vector<float> vertices, uvs, normals;
-    vector<unsigned> vertex_indices;
+    vector<float> &vertices = mesh.vertices, &uvs = mesh.uvs, &normals = mesh.normals;
+    vector<unsigned> &vertex_indices = mesh.indices;
     // QVector2D uvEdge[] = { QVector2D(0,0), QVector2D(0,1), QVector2D(1,1) };
     // QVector2D uvEdge[3];
     // unsigned reused = 0;
@@ -168,7 +189,6 @@ bool Model3D::loadModel(const std::string &path, bool smooth) noexcept{
                 normals[i + edge] = normal[edge];
         }
 //    cout << "reused: " << reused << endl;
-    pushData(vertices, uvs, normals, vertex_indices);
 
     return true;
 }
@@ -203,11 +223,12 @@ void Model3D::pushData(const std::vector<GLfloat> &vertices, const std::vector<G
     vao->release();
 }
 
-void Model3D::draw() noexcept{
+// The vertex array is bound through the cache and stays bound
+void Model3D::draw(GlStateCache &state) noexcept{
     if(!vao)
         return;
 
-    vao->bind();
+    state.bindVertexArray(vao->objectId());
 
 
 // Vertex
@@ -253,6 +274,28 @@ void Model3D::draw() noexcept{
     glDisableVertexAttribArray(0);
     if(uvBuffer     > 0) glDisableVertexAttribArray(1);
     if(normalBuffer > 0) glDisableVertexAttribArray(2);
+}
 
-    vao->release();
+PendingMesh::PendingMesh(const std::string &path) : path(path), state(Pending)
+{ }
+
+bool PendingMesh::isReady() const noexcept{
+    return state.loadAcquire() != Pending;
+}
+
+bool PendingMesh::isValid() const noexcept{
+    return state.loadAcquire() == Ready;
+}
+
+const Model3D::Mesh &PendingMesh::mesh() const noexcept{
+    return data;
+}
+
+MeshDecoder::MeshDecoder(std::shared_ptr<PendingMesh> mesh, bool smooth) : mesh(mesh), smooth(smooth)
+{ }
+
+void MeshDecoder::run() noexcept{
+    // The mesh is published by the release of the state
+    bool ok = Model3D::parse(mesh->path, smooth, mesh->data);
+    mesh->state.storeRelease(ok ? PendingMesh::Ready : PendingMesh::Failed);
 }
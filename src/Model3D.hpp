@@ -2,22 +2,38 @@
 #define Model3Dobj_HPP
 
 #include <string>
+#include <vector>
+#include <memory>
 
 #include <QOpenGLFunctions>
 #include <QOpenGLVertexArrayObject>
 #include <QVector2D>
 #include <QVector3D>
+#include <QRunnable>
+#include <QAtomicInt>
 
 #include <QDebug>
 
+class PendingMesh;
+class GlStateCache;
+
 class Model3D : protected QOpenGLFunctions{
 public:
+    struct Mesh{
+        std::vector<float> vertices, uvs, normals;
+        std::vector<unsigned> indices;
+    };
+
     Model3D();
     ~Model3D();
 
+    static bool parse(const std::string &path, bool smooth, Mesh &mesh) noexcept;
+    static std::shared_ptr<PendingMesh> request(const std::string &path, bool smooth = true) noexcept;
+
     bool init() noexcept;
     bool loadModel(const std::string &path, bool smooth = true) noexcept;
-    void draw() noexcept;
+    void upload(const Mesh &mesh) noexcept;
+    void draw(GlStateCache &state) noexcept;
 
 private:
     void pushData(const std::vector<float> &vertices, const std::vector<float> &uvs,
@@ -32,4 +48,43 @@ private:
         indexBuffer;
 };
 
+/**
+ * @brief The PendingMesh class
+ *
+ * A model file that is parsed by a worker of the global
+ * thread pool. The render thread keeps drawing the model it
+ * has and uploads the mesh once it is ready.
+ */
+class PendingMesh{
+public:
+    explicit PendingMesh(const std::string &path);
+    bool isReady() const noexcept;
+    bool isValid() const noexcept;
+    const Model3D::Mesh &mesh() const noexcept;
+
+    const std::string path;
+
+private:
+    friend class MeshDecoder;
+    enum State{ Pending, Ready, Failed };
+
+    Model3D::Mesh data;
+    QAtomicInt state;
+};
+
+/**
+ * @brief The MeshDecoder class
+ *
+ * A runnable that parses the file of a PendingMesh.
+ */
+class MeshDecoder : public QRunnable{
+public:
+    MeshDecoder(std::shared_ptr<PendingMesh> mesh, bool smooth);
+    void run() noexcept Q_DECL_OVERRIDE;
+
+private:
+    std::shared_ptr<PendingMesh> mesh;
+    bool smooth;
+};
+
 #endif
@@ -0,0 +1,182 @@
+#include "RenderThread.hpp"
+
+#include <limits>
+
+/**
+ * @brief RenderThread::RenderThread
+ * @param parent Parent object
+ */
+RenderThread::RenderThread(QObject *parent) :
+    QThread(parent), next(0), stopping(false)
+{
+    clock.start();
+}
+
+/**
+ * @brief RenderThread::~RenderThread
+ *
+ * Stops the loop, which releases the GL resources of all
+ * renderers that are still attached.
+ */
+RenderThread::~RenderThread(){
+    stop();
+}
+
+/**
+ * @brief RenderThread::add
+ * @param renderer A renderer whose context is not created yet
+ *
+ * Starts drawing frames for renderer. Its context is
+ * created on this thread with the first frame. A parked
+ * renderer is due immediately.
+ */
+void RenderThread::add(Renderer *renderer) noexcept{
+    QMutexLocker lock(&mutex);
+    parked.removeOne(renderer);
+    for(auto &window : windows)
+        if(window.renderer == renderer)
+            return;
+    windows.append({renderer, clock.elapsed()});
+    changed.wakeAll();
+}
+
+/**
+ * @brief RenderThread::park
+ * @param renderer A renderer that was added before
+ *
+ * Stops drawing frames for renderer without releasing
+ * anything. A frame that is being drawn just completes.
+ */
+void RenderThread::park(Renderer *renderer) noexcept{
+    QMutexLocker lock(&mutex);
+    for(int i = 0; i < windows.size(); ++i){
+        if(windows[i].renderer != renderer)
+            continue;
+        windows.removeAt(i);
+        if(next > i)
+            --next;
+        parked.append(renderer);
+        return;
+    }
+}
+
+/**
+ * @brief RenderThread::remove
+ * @param renderer A renderer that was added before
+ *
+ * Raises the stop flag of renderer and returns immediately.
+ * The loop releases its GL resources before the next frame
+ * it would have drawn and emits released(). The thread is
+ * started for that if it is not running, as the context of
+ * renderer can only be made current on it.
+ */
+void RenderThread::remove(Renderer *renderer) noexcept{
+    renderer->requestStop();
+    QMutexLocker lock(&mutex);
+    // Parked renderers are released by the loop like all others
+    parked.removeOne(renderer);
+    bool listed = false;
+    for(auto &window : windows)
+        listed = listed || window.renderer == renderer;
+    if(!listed)
+        windows.append({renderer, 0});
+    changed.wakeAll();
+    lock.unlock();
+    if(!isRunning())
+        start();
+}
+
+/**
+ * @brief RenderThread::stop
+ *
+ * Raises the stop flag of the loop and waits until it
+ * released all renderers and the thread quit.
+ */
+void RenderThread::stop() noexcept{
+    mutex.lock();
+    stopping = true;
+    changed.wakeAll();
+    mutex.unlock();
+    wait();
+}
+
+/**
+ * @brief RenderThread::release
+ * @param renderer A renderer that is not drawn anymore
+ *
+ * Frees its GL resources in its own context and tells the owner.
+ */
+void RenderThread::release(Renderer *renderer) noexcept{
+    renderer->releaseGl();
+    Q_EMIT released(renderer);
+}
+
+/**
+ * @brief RenderThread::run
+ *
+ * Releases the renderers that were asked to stop, then draws
+ * the next window that is due, starting after the one drawn
+ * last, and sleeps until the earliest one is due if none is.
+ */
+void RenderThread::run() noexcept{
+    QMutexLocker lock(&mutex);
+    while(!stopping){
+        int stopped = -1;
+        for(int i = 0; stopped < 0 && i < windows.size(); ++i)
+            if(windows[i].renderer->isStopping())
+                stopped = i;
+        if(stopped >= 0){
+            auto renderer = windows.takeAt(stopped).renderer;
+            if(next > stopped)
+                --next;
+            lock.unlock();
+            release(renderer);
+            lock.relock();
+            continue;
+        }
+
+        if(windows.isEmpty()){
+            changed.wait(&mutex);
+            continue;
+        }
+
+        qint64 now = clock.elapsed();
+        qint64 sleep = std::numeric_limits<qint64>::max();
+        int chosen = -1;
+        for(int i = 0; chosen < 0 && i < windows.size(); ++i){
+            int index = (next + i) % windows.size();
+            if(windows[index].due <= now)
+                chosen = index;
+            else
+                sleep = qMin(sleep, windows[index].due - now);
+        }
+        if(chosen < 0){
+            changed.wait(&mutex, sleep);
+            continue;
+        }
+
+        // A window that fell behind does not try to catch up
+        auto &window = windows[chosen];
+        auto renderer = window.renderer;
+        window.due += renderer->frameInterval();
+        if(window.due <= now)
+            window.due = now + renderer->frameInterval();
+        next = chosen + 1;
+
+        // The GUI thread may park the window meanwhile, but it only
+        // deletes a renderer after this thread released it, so
+        // renderer stays valid without the lock
+        lock.unlock();
+        renderer->renderFrame();
+        lock.relock();
+    }
+
+    auto remaining = parked;
+    for(auto &window : windows)
+        remaining.append(window.renderer);
+    windows.clear();
+    parked.clear();
+    lock.unlock();
+    for(auto renderer : remaining)
+        release(renderer);
+}
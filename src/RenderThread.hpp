@@ -0,0 +1,66 @@
+#ifndef RENDERTHREAD_HPP
+#define RENDERTHREAD_HPP
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QList>
+
+#include "Renderer.hpp"
+
+/**
+ * @brief The RenderThread class
+ *
+ * The one thread that does all GL work of the application.
+ * It owns the contexts of every renderer that was added and
+ * draws their frames round-robin, each window no more often
+ * than its frame interval. The windows themselves stay on the
+ * GUI thread, which only hands them input and new code.
+ *
+ * Nothing is ever killed: removing a renderer only raises its
+ * stop flag. The loop releases its GL resources in its own
+ * context between two frames and then emits released(), after
+ * which the window may be deleted. The GUI thread never waits
+ * for the render thread, except in stop().
+ *
+ * A parked renderer is not drawn but keeps its context and
+ * everything in it, so adding it again shows its next frame
+ * right away.
+ */
+class RenderThread : public QThread{
+    Q_OBJECT
+public:
+    explicit RenderThread(QObject *parent = 0);
+    ~RenderThread();
+    void add(Renderer *renderer) noexcept;
+    void park(Renderer *renderer) noexcept;
+    void remove(Renderer *renderer) noexcept;
+    void stop() noexcept;
+
+Q_SIGNALS:
+    void released(Renderer *);
+
+protected:
+    void run() noexcept Q_DECL_OVERRIDE;
+
+private:
+    void release(Renderer *renderer) noexcept;
+    RenderThread(const RenderThread &);
+    RenderThread& operator=(const RenderThread& rhs);
+
+    struct Window{
+        Renderer *renderer;
+        qint64 due;
+    };
+
+    QMutex mutex;
+    QWaitCondition changed;
+    QList<Window> windows;
+    QList<Renderer *> parked;
+    int next;
+    bool stopping;
+    QElapsedTimer clock;
+};
+
+#endif // RENDERTHREAD_HPP
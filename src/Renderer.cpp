@@ -1,5 +1,7 @@
 #include "Renderer.hpp"
 
+#include <algorithm>
+
 
 static GLfloat vertices[] = {
     1, 1,0,  1,-1,0, -1,1,0,
@@ -33,21 +35,21 @@ Renderer::Renderer(const QString &vertexShader, const QString &fragmentShader, Q
     QWindow(parent),
     clearColor(Qt::black),
     context(0), device(0),
-    time(0),
-    pendingUpdate(false),
-    vao(0), uvBuffer(0), audioLeftTexture(0), audioRightTexture(0),
-    vertexAttr(0), uvAttr(0), timeUniform(0),
-    mID(0), vID(0), pID(0),
-    shaderProgram(0),
+    vao(0), vertexBuffer(0), uvBuffer(0), audioTextures(),
+    vertexAttr(0), uvAttr(0),
+    shaderProgram(0), uniforms(0), state(0), audioUsed(),
     vertexSource(vertexShader), fragmentSource(fragmentShader),
-    textureRegEx("(^|\n|\r)\\s*#texture\\s+([A-Za-z_][A-Za-z0-9_]*)\\s+([^\n\r]+)")
+    model(0), watcher(new FileWatcher(this)), audio(0), m_logger(0),
+    pendingVertex(vertexShader), pendingFragment(fragmentShader),
+    codePending(false), modelPending(false), clockPending(false), scrubPending(false),
+    pendingPaused(false), pendingScrub(0), pendingStep(0),
+    exposed(false),
+    textureRegEx("(^|\n|\r)\\s*#texture\\s+([A-Za-z_][A-Za-z0-9_]*)\\s+([^\n\r]+)"),
+    videoRegEx("(^|\n|\r)\\s*#video\\s+([A-Za-z_][A-Za-z0-9_]*)\\s+([^\n\r]+)")
 {
     setTitle("ShaderSandbox Renderer");
 
-    m_logger = new QOpenGLDebugLogger( this );
-
-    connect(m_logger, &QOpenGLDebugLogger::messageLogged,
-            this, &Renderer::onMessageLogged, Qt::DirectConnection);
+    connect(watcher, &FileWatcher::changed, this, &Renderer::assetsChanged);
 
     setSurfaceType(QWindow::OpenGLSurface);
 
@@ -58,8 +60,14 @@ Renderer::Renderer(const QString &vertexShader, const QString &fragmentShader, Q
     format.setProfile(QSurfaceFormat::CoreProfile);
     format.setOption(QSurfaceFormat::DebugContext);
     format.setDepthBufferSize(24);
+    // The render thread paces the frames; a blocking swap would
+    // hold up every other window it draws.
+    format.setSwapInterval(0);
     setFormat(format);
 
+    qreal refreshRate = screen() ? screen()->refreshRate() : 60;
+    interval = qMax(1, qRound(1000 / (refreshRate > 0 ? refreshRate : 60)));
+
     cameraPosition.setY(-1);
     cameraPosition.setZ(-2);
     cameraRotation = 0;
@@ -67,39 +75,111 @@ Renderer::Renderer(const QString &vertexShader, const QString &fragmentShader, Q
     V.rotate(cameraPitch, 1, 0, 0);
     V.translate(cameraPosition);
     P.perspective(45.0f, 4.0f / 3.0f, 0.1f, 100.0f);
-
-    time = new QTime();
-    time->start();
-
-    audio = new AudioInputProcessor(this);
-    connect(audio, &AudioInputProcessor::processData,
-            this,  &Renderer::updateAudioData);
-    audio->start();
 }
 
 /**
  * @brief Renderer::~Renderer
  *
- * Free resources
+ * Free resources. The GL resources have to be released by
+ * the render thread before, see releaseGl().
  */
 Renderer::~Renderer(){
-    if(context)
-        context->makeCurrent(this);
-    if(shaderProgram){
-        shaderProgram->bind();
-        for(auto *texture : textures){
-            texture->destroy();
-            delete texture;
-        }
-        delete shaderProgram;
-    }
+    Q_ASSERT(!context);
+}
+
+/**
+ * @brief Renderer::releaseGl
+ *
+ * Frees all GL resources and the context. Must be called
+ * on the render thread once it stopped drawing this window.
+ */
+void Renderer::releaseGl() noexcept{
+    if(!context)
+        return;
+    context->makeCurrent(this);
+    textures.clear();
+    residentTextures.clear();
+    videos.clear();
+    residentVideos.clear();
+    delete shaderProgram;
+    shaderProgram = 0;
+    delete uniforms;
+    uniforms = 0;
+    delete state;
+    state = 0;
+    delete model;
+    model = 0;
+    pendingMesh.reset();
+    glDeleteBuffers(1, &vertexBuffer);
     glDeleteBuffers(1, &uvBuffer);
-    glDeleteTextures(1, &audioLeftTexture);
-    glDeleteTextures(1, &audioRightTexture);
-    delete time;
+    glDeleteTextures(audioUnits, audioTextures);
+    vertexBuffer = uvBuffer = 0;
+    std::fill(audioTextures, audioTextures + audioUnits, 0);
+    audioBlock.reset();
     delete vao;
+    vao = 0;
     delete device;
+    device = 0;
     delete m_logger;
+    m_logger = 0;
+    context->doneCurrent();
+    delete context;
+    context = 0;
+}
+
+/**
+ * @brief Renderer::requestStop
+ *
+ * Asks the render thread to stop drawing this window and to
+ * release its GL resources. May be called from any thread.
+ */
+void Renderer::requestStop() noexcept{
+    stopRequested.storeRelease(1);
+}
+
+/**
+ * @brief Renderer::isStopping
+ * @return True once requestStop() was called
+ */
+bool Renderer::isStopping() const noexcept{
+    return stopRequested.loadAcquire();
+}
+
+/**
+ * @brief Renderer::setParked
+ * @param parked True when the renderer goes into the pool,
+ * false when it is reused
+ *
+ * Hides the window while parked. A reused renderer starts its
+ * time at zero again, like a new one.
+ */
+void Renderer::setParked(bool parked) noexcept{
+    if(parked){
+        hide();
+        return;
+    }
+    pendingMutex.lock();
+        clockPending = true;
+    pendingMutex.unlock();
+    show();
+}
+
+/**
+ * @brief Renderer::setAudioCapture
+ * @param capture Capture whose blocks are shown, or null for none
+ *
+ * Must be set before the renderer is added to the render thread.
+ */
+void Renderer::setAudioCapture(const AudioCapture *capture) noexcept{
+    audio = capture;
+}
+
+/**
+ * @brief Renderer::frameInterval
+ * @return Milliseconds between two frames of this window
+ */
+int Renderer::frameInterval() const noexcept{
+    return interval;
 }
 
 /**
@@ -109,14 +189,18 @@ Renderer::~Renderer(){
  * Allocates grafic memory and initialize the shader program
  */
 bool Renderer::init(){
-    model.init();
+    model = new Model3D();
+    model->init();
     if(modelFile != "")
-        model.loadModel(modelFile.toStdString());
+        model->loadModel(modelFile.toStdString());
+
+    delete state;
+    state = new GlStateCache();
 
     delete vao;
-    vao = new QOpenGLVertexArrayObject(this);
+    vao = new QOpenGLVertexArrayObject();
     vao->create();
-    vao->bind();
+    state->bindVertexArray(vao->objectId());
 
     glDeleteBuffers(1, &vertexBuffer);
     glGenBuffers(1, &vertexBuffer);
@@ -128,23 +212,19 @@ bool Renderer::init(){
     glBindBuffer(GL_ARRAY_BUFFER, uvBuffer);
     glBufferData(GL_ARRAY_BUFFER, sizeof(uvs), uvs, GL_STATIC_DRAW);
 
-    glDeleteTextures(1, &audioLeftTexture);
-    glGenTextures(1, &audioLeftTexture);
-    glBindTexture(GL_TEXTURE_1D, audioLeftTexture);
-    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-
-    glDeleteTextures(1, &audioRightTexture);
-    glGenTextures(1, &audioRightTexture);
-    glBindTexture(GL_TEXTURE_1D, audioRightTexture);
-    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-
-    bool result = initShaders(vertexSource, fragmentSource);
+    glDeleteTextures(audioUnits, audioTextures);
+    glGenTextures(audioUnits, audioTextures);
+    for(int i = 0; i < audioUnits; ++i){
+        state->bindTexture(i, GL_TEXTURE_1D, audioTextures[i]);
+        glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    }
+    audioBlock.reset();
 
-    vao->release();
+    delete uniforms;
+    uniforms = new UniformTable();
 
-    return result;
+    return initShaders(vertexSource, fragmentSource);
 }
 
 
@@ -153,12 +233,37 @@ bool Renderer::init(){
  * @param fragmentShader Code to compile as shader
  * @return True on success, otherwise false
  *
- * Initialze and compile the shader program
+ * Initialze and compile the shader program. Includes are
+ * expanded first; quoted ones are also looked up next to
+ * the model.
  */
 bool Renderer::initShaders(QString vertexShader, QString fragmentShader){
+    const QString vertexInput = vertexShader, fragmentInput = fragmentShader;
     QList<QPair<QString, QString>> images;
     QDir modelDir = QFileInfo(modelFile).dir();
 
+    auto vertexExpansion = preprocessor.process(vertexShader, includeDirectory(), "_vertexTweak");
+    auto fragmentExpansion = preprocessor.process(fragmentShader, includeDirectory(), "_fragmentTweak");
+    for(auto expansion : {&vertexExpansion, &fragmentExpansion}){
+        if(expansion->ok())
+            continue;
+        if(shaderProgram == 0){
+            if(vertexInput == defaultVertexShader && fragmentInput == defaultFragmentShader)
+                qWarning() << tr("Failed to compile default shader.");
+            else
+                initShaders(defaultVertexShader, defaultFragmentShader);
+        }
+        auto location = expansion->errorLocation;
+        QList<ShaderDiagnostic> diagnostics{{ShaderDiagnostic::Error, location.file, location.line, -1, expansion->error}};
+        if(expansion == &vertexExpansion)
+            Q_EMIT vertexDiagnostics(diagnostics);
+        else
+            Q_EMIT fragmentDiagnostics(diagnostics);
+        return false;
+    }
+    vertexShader = vertexExpansion.source;
+    fragmentShader = fragmentExpansion.source;
+
     int pos = 0;
     while((pos = textureRegEx.indexIn(fragmentShader, pos)) != -1){
         QString imageName = textureRegEx.cap(2).trimmed();
@@ -173,12 +278,13 @@ bool Renderer::initShaders(QString vertexShader, QString fragmentShader){
         if(!textureImage.isFile()){
             qDebug() << "Texture image does not exsit: " << imagePath;
             if(shaderProgram == 0){
-                if(vertexShader == defaultVertexShader && fragmentShader == defaultFragmentShader)
+                if(vertexInput == defaultVertexShader && fragmentInput == defaultFragmentShader)
                     qWarning() << tr("Failed to compile default shader.");
                 else
                     initShaders(defaultVertexShader, defaultFragmentShader);
             }
-            Q_EMIT fragmentError("Image file does not exist: " + imagePath, fragmentShader.mid(0, pos).count('\n'));
+            auto location = fragmentExpansion.locateLine(fragmentShader.left(pos + textureRegEx.cap(1).length()).count('\n') + 1);
+            Q_EMIT fragmentDiagnostics({{ShaderDiagnostic::Error, location.file, location.line, -1, "Image file does not exist: " + imagePath}});
             return false;
         }
 
@@ -189,8 +295,46 @@ bool Renderer::initShaders(QString vertexShader, QString fragmentShader){
         fragmentShader.insert(pos, textureDefinition);
         pos += textureDefinition.length();
     }
+
+    // #video name pattern [fps], where pattern is a directory or
+    // a wildcard matching the frames of an image sequence
+    QList<QPair<QString, QString>> sequences;
+    QList<QStringList> sequenceFiles;
+    pos = 0;
+    while((pos = videoRegEx.indexIn(fragmentShader, pos)) != -1){
+        QString videoName = videoRegEx.cap(2).trimmed();
+        QString videoPath = videoRegEx.cap(3).trimmed();
+        QString fps = "30";
+        QRegExp fpsRegEx("\\s+([0-9]+(\\.[0-9]+)?)$");
+        if(fpsRegEx.indexIn(videoPath) != -1){
+            fps = fpsRegEx.cap(1);
+            videoPath.truncate(fpsRegEx.pos());
+        }
+
+        auto files = VideoTexture::frameFiles(modelDir.exists() ? modelDir.filePath(videoPath) : videoPath);
+        if(files.isEmpty()){
+            qDebug() << "Video frames do not exist: " << videoPath;
+            if(shaderProgram == 0){
+                if(vertexInput == defaultVertexShader && fragmentInput == defaultFragmentShader)
+                    qWarning() << tr("Failed to compile default shader.");
+                else
+                    initShaders(defaultVertexShader, defaultFragmentShader);
+            }
+            auto location = fragmentExpansion.locateLine(fragmentShader.left(pos + videoRegEx.cap(1).length()).count('\n') + 1);
+            Q_EMIT fragmentDiagnostics({{ShaderDiagnostic::Error, location.file, location.line, -1, "Video frames do not exist: " + videoPath}});
+            return false;
+        }
+
+        sequences.append(QPair<QString, QString>(videoName, fps));
+        sequenceFiles.append(files);
+
+        QString videoDefinition(videoRegEx.cap(1) + "uniform sampler2D " + videoName + ";");
+        fragmentShader.remove(pos, videoRegEx.matchedLength());
+        fragmentShader.insert(pos, videoDefinition);
+        pos += videoDefinition.length();
+    }
 	
-    QOpenGLShaderProgram *newShaderProgram = new QOpenGLShaderProgram(this);
+    QOpenGLShaderProgram *newShaderProgram = new QOpenGLShaderProgram();
     bool vertexOk = newShaderProgram->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexShader);
     bool fragmentOk = vertexOk && newShaderProgram->addShaderFromSourceCode(QOpenGLShader::Fragment,fragmentShader);
     bool linkOk = fragmentOk && newShaderProgram->link();
@@ -199,24 +343,16 @@ bool Renderer::initShaders(QString vertexShader, QString fragmentShader){
         QString error = newShaderProgram->log();
         delete newShaderProgram;
 
+        // The log of a failed compile is the one of that stage,
+        // every error in it is reported at once
         if(vertexOk && fragmentOk)
             Q_EMIT errored(error);
-        else{
-            //mac  :<line>:
-            //mesa :<line>(<errorcode>):
-            QRegExp errorline(":([0-9]+)(\\([0-9]+\\))?:");
-            if(errorline.indexIn(error) > -1){
-                QString text = errorline.cap(1);
-                int line = text.toInt();
-                if (line >= 3) line -= 3;
-                if(!vertexOk)
-                    Q_EMIT vertexError(error, line);
-                else
-                    Q_EMIT fragmentError(error, line);
-            }
-        }
+        else if(!vertexOk)
+            Q_EMIT vertexDiagnostics(ShaderDiagnostics::parse(error, vertexExpansion));
+        else
+            Q_EMIT fragmentDiagnostics(ShaderDiagnostics::parse(error, fragmentExpansion));
 
-        if(shaderProgram == 0 && (vertexShader != defaultFragmentShader || fragmentShader != defaultFragmentShader)){
+        if(shaderProgram == 0 && (vertexInput != defaultVertexShader || fragmentInput != defaultFragmentShader)){
             initShaders(defaultVertexShader, defaultFragmentShader);
         } else {
             qWarning() << tr("Failed to compile default shader.");
@@ -225,60 +361,93 @@ bool Renderer::initShaders(QString vertexShader, QString fragmentShader){
         return false;
     }
 
-    QList<QOpenGLTexture*> newTextures;
+    // Warnings of the compile; empty lists clear earlier reports.
+    // The fallback to the default shader keeps what it replaced.
+    auto stages = newShaderProgram->shaders();
+    if(stages.size() == 2 && (vertexInput != defaultVertexShader || fragmentInput != defaultFragmentShader)){
+        Q_EMIT vertexDiagnostics(ShaderDiagnostics::parse(stages[0]->log(), vertexExpansion));
+        Q_EMIT fragmentDiagnostics(ShaderDiagnostics::parse(stages[1]->log(), fragmentExpansion));
+    }
+
+    // Decoding happens on the workers of the texture cache; textures
+    // that are already resident are reused as long as the file is unchanged,
+    // and an image referenced twice shares one texture.
+    QList<std::shared_ptr<StreamingTexture>> newTextures;
+    QHash<QString, std::shared_ptr<StreamingTexture>> newResidentTextures;
     for(auto image: images){
+        auto key = TextureCache::keyFor(QFileInfo(image.second));
+        auto texture = newResidentTextures.value(key);
+        if(!texture)
+            texture = residentTextures.value(key);
+        if(!texture)
+            texture = std::make_shared<StreamingTexture>(TextureCache::instance()->request(image.second));
+        newResidentTextures.insert(key, texture);
+        newTextures.append(texture);
+    }
 
-        QOpenGLTexture* texture = new QOpenGLTexture(QImage(image.second));
+    QList<std::shared_ptr<VideoTexture>> newVideos;
+    QHash<QString, std::shared_ptr<VideoTexture>> newResidentVideos;
+    for(int i = 0; i < sequences.length(); ++i){
+        auto key = sequenceFiles[i].join("\n") + "@" + sequences[i].second;
+        auto video = residentVideos.value(key);
+        if(!video)
+            video = std::make_shared<VideoTexture>(sequenceFiles[i], sequences[i].second.toDouble(), *state,
+                                                   audioUnits + newTextures.length() + i);
+        newResidentVideos.insert(key, video);
+        newVideos.append(video);
+    }
 
-        texture->setMinificationFilter(QOpenGLTexture::LinearMipMapLinear);
-        texture->setMagnificationFilter(QOpenGLTexture::Linear);
+    includeFiles = vertexExpansion.files.mid(1) + fragmentExpansion.files.mid(1);
 
-        //qDebug() << imageName << " from " << imagePath << ": " << texture->textureId() << " (" << texture << ")";
+    delete shaderProgram;
+    textures = newTextures;
+    residentTextures = newResidentTextures;
+    videos = newVideos;
+    residentVideos = newResidentVideos;
+    shaderProgram = newShaderProgram;
+    // Deleted textures and programs may hand their names to new ones
+    state->invalidate();
+    state->useProgram(shaderProgram->programId());
+    state->bindVertexArray(vao->objectId());
 
-        newTextures.append(texture);
-    }
-
-    shaderProgramMutex.lock();
+    vertexAttr = shaderProgram->attributeLocation("position");
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    shaderProgram->setAttributeBuffer(vertexAttr, GL_FLOAT, 0, 3);
+    shaderProgram->enableAttributeArray(vertexAttr);
 
-        if(shaderProgram){
-            shaderProgram->bind();
-            for(auto *texture : textures){
-                texture->destroy();
-                delete texture;
-            }
-            delete shaderProgram;
-        }
-        textures = newTextures;
-        shaderProgram = newShaderProgram;
-        shaderProgram->bind();
-
-        vertexAttr = shaderProgram->attributeLocation("position");
-        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-        shaderProgram->setAttributeBuffer(vertexAttr, GL_FLOAT, 0, 3);
-        shaderProgram->enableAttributeArray(vertexAttr);
-
-        uvAttr = shaderProgram->attributeLocation("texCoord");
-        glBindBuffer(GL_ARRAY_BUFFER, uvBuffer);
-        shaderProgram->setAttributeBuffer("texCoord", GL_FLOAT, 0, 2);
-        shaderProgram->enableAttributeArray(uvAttr);
-
-        vID = shaderProgram->uniformLocation("V");
-        pID = shaderProgram->uniformLocation("P");
-        mID = shaderProgram->uniformLocation("M");
-
-        timeUniform = shaderProgram->uniformLocation("time");
-        mouseUniform = shaderProgram->uniformLocation("mouse");
-        rationUniform = shaderProgram->uniformLocation("ration");
-
-        shaderProgram->setUniformValue("audioLeft", GLint(0));
-        shaderProgram->setUniformValue("audioRight", GLint(1));
-        const int end = images.length();
-        for(int i = 0; i < end; ++i)
-            shaderProgram->setUniformValue(images[i].first.toLocal8Bit().data(), GLint(i + 2));
-
-        vertexSource = vertexShader;
-        fragmentSource = fragmentShader;
-    shaderProgramMutex.unlock();
+    uvAttr = shaderProgram->attributeLocation("texCoord");
+    glBindBuffer(GL_ARRAY_BUFFER, uvBuffer);
+    shaderProgram->setAttributeBuffer("texCoord", GL_FLOAT, 0, 2);
+    shaderProgram->enableAttributeArray(uvAttr);
+
+    // Reflect once per link; samplers the program does not use
+    // are neither assigned a unit nor bound while rendering.
+    uniforms->reflect(shaderProgram->programId());
+    auto bindSampler = [this](const QString &name, GLint unit){
+        GLint location = uniforms->location(name);
+        if(location >= 0)
+            shaderProgram->setUniformValue(location, unit);
+        return location >= 0;
+    };
+
+    audioUsed[0] = bindSampler("audioLeft", 0) | bindSampler("audioLeftData", 0);
+    audioUsed[1] = bindSampler("audioRight", 1) | bindSampler("audioRightData", 1);
+    audioUsed[2] = bindSampler("audioLeftSpectrum", 2);
+    audioUsed[3] = bindSampler("audioRightSpectrum", 3);
+    const int end = images.length();
+    texturesUsed.resize(end + sequences.length());
+    for(int i = 0; i < end; ++i)
+        texturesUsed[i] = bindSampler(images[i].first, GLint(audioUnits + i));
+    for(int i = 0; i < sequences.length(); ++i)
+        texturesUsed[end + i] = bindSampler(sequences[i].first, GLint(audioUnits + end + i));
+
+    vertexSource = vertexInput;
+    fragmentSource = fragmentInput;
+    compiledVertex = vertexExpansion.source;
+    compiledFragment = fragmentExpansion.source;
+    applyTweaks(vertexExpansion, fragmentExpansion);
+    // Samplers the old program did not use hold stale data
+    audioBlock.reset();
 
 //    qDebug() << "vertexAttr" << vertexAttr;
 //    qDebug() << "uvAttr" << uvAttr;
@@ -290,69 +459,229 @@ bool Renderer::initShaders(QString vertexShader, QString fragmentShader){
     return true;
 }
 
-
-
 /**
- * @brief Renderer::render
+ * @brief Renderer::retweak
+ * @param vertexShader New vertex shader code
+ * @param fragmentShader New fragment shader code
+ * @return True if the program runs the code already
  *
- * Initialize output device, execute the shader and display the result
+ * Code that expands to the code of the program differs at
+ * most in the literals of #pragma tweak regions; only their
+ * uniforms are set then, nothing is compiled.
  */
-void Renderer::render(){
-    if(!device)
-        device = new QOpenGLPaintDevice();
+bool Renderer::retweak(const QString &vertexShader, const QString &fragmentShader) noexcept{
+    if(!shaderProgram)
+        return false;
+    auto vertexExpansion = preprocessor.process(vertexShader, includeDirectory(), "_vertexTweak");
+    auto fragmentExpansion = preprocessor.process(fragmentShader, includeDirectory(), "_fragmentTweak");
+    if(!vertexExpansion.ok() || !fragmentExpansion.ok()
+            || vertexExpansion.source != compiledVertex || fragmentExpansion.source != compiledFragment)
+        return false;
 
-    device->setSize(size());
+    state->useProgram(shaderProgram->programId());
+    applyTweaks(vertexExpansion, fragmentExpansion);
+    vertexSource = vertexShader;
+    fragmentSource = fragmentShader;
+    return true;
+}
 
-//    qDebug() << QLatin1String(reinterpret_cast<const char*>(glGetString(GL_VERSION))) << " " << QLatin1String(reinterpret_cast<const char*>(glGetString(GL_SHADING_LANGUAGE_VERSION)));
-    const qreal retinaScale = devicePixelRatio();
-    glViewport(0, 0, width() * retinaScale, height() * retinaScale);
+/**
+ * @brief Renderer::applyTweaks
+ * @param vertexExpansion Expanded vertex shader code
+ * @param fragmentExpansion Expanded fragment shader code
+ *
+ * Sets the uniforms of lifted literals the program uses. The
+ * program has to be in use.
+ */
+void Renderer::applyTweaks(const ShaderPreprocessor::Result &vertexExpansion,
+                           const ShaderPreprocessor::Result &fragmentExpansion) noexcept{
+    for(auto expansion : {&vertexExpansion, &fragmentExpansion})
+        for(auto &tweak : expansion->tweaks){
+            GLint location = uniforms->location(tweak.name);
+            if(location < 0)
+                continue;
+            if(tweak.type == ShaderPreprocessor::Tweak::Float)
+                shaderProgram->setUniformValue(location, GLfloat(tweak.value));
+            else
+                shaderProgram->setUniformValue(location, GLint(tweak.value));
+        }
+}
 
-    QPoint mouse = this->mapFromGlobal(QCursor::pos());
-    QVector2D mousePosition((float)mouse.x() / (float)this->width(),
-                            (float)mouse.y() / (float)this->height());
-    float ration = ((this->height() == 0) ? 1 : (float)this->width() / (float)this->height());
+/**
+ * @brief Renderer::includeDirectory
+ * @return Directory quoted includes are relative to
+ *
+ * That is the directory of the model, if one is loaded.
+ */
+QString Renderer::includeDirectory() const noexcept{
+    return modelFile.isEmpty() ? QString() : QFileInfo(modelFile).absolutePath();
+}
 
-    handleInput();
+/**
+ * @brief Renderer::watchAssets
+ *
+ * Called by the render thread whenever the program or the
+ * model changed. Hands the files they were loaded from to
+ * the watcher, which lives on the GUI thread.
+ */
+void Renderer::watchAssets() noexcept{
+    QStringList files = includeFiles;
+    for(auto texture : textures)
+        files.append(texture->source()->path);
+    if(!modelFile.isEmpty())
+        files.append(QFileInfo(modelFile).absoluteFilePath());
+    files.removeDuplicates();
+
+    QMutexLocker lock(&pendingMutex);
+    if(files == watchedFiles)
+        return;
+    watchedFiles = files;
+    lock.unlock();
+    QMetaObject::invokeMethod(this, "updateWatcher", Qt::QueuedConnection);
+}
 
-    shaderProgramMutex.lock();
-        shaderProgram->bind();
-        glClearColor(0, 0, 0.3, 1);
+/**
+ * @brief Renderer::updateWatcher
+ *
+ * Watches the files the render thread last reported.
+ */
+void Renderer::updateWatcher(){
+    QMutexLocker lock(&pendingMutex);
+    QStringList files = watchedFiles;
+    lock.unlock();
+    watcher->setFiles(files);
+}
 
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+/**
+ * @brief Renderer::assetsChanged
+ * @param files Files that changed on disk
+ *
+ * Queues the files for the next frame.
+ */
+void Renderer::assetsChanged(const QStringList &files){
+    QMutexLocker lock(&pendingMutex);
+    pendingAssets.unite(files.toSet());
+}
 
-        glDisable(GL_CULL_FACE);
-        glDisable(GL_SCISSOR_TEST);
-        glDisable(GL_STENCIL_TEST);
-//        glDisable(GL_ALPHA_TEST);
+/**
+ * @brief Renderer::reloadAssets
+ * @param files Files that changed on disk
+ *
+ * Called by the render thread. Textures keep their storage
+ * and the program, the model is parsed in the background and
+ * a changed include compiles the current code again.
+ */
+void Renderer::reloadAssets(const QSet<QString> &files) noexcept{
+    if(!modelFile.isEmpty() && files.contains(QFileInfo(modelFile).absoluteFilePath()))
+        pendingMesh = Model3D::request(modelFile.toStdString(), false);
+
+    // Keyed by the new modification time, merged after the loop
+    QHash<QString, std::shared_ptr<StreamingTexture>> reloaded;
+    for(auto it = residentTextures.begin(); it != residentTextures.end();){
+        auto texture = it.value();
+        QString path = texture->source()->path;
+        if(!files.contains(path)){
+            ++it;
+            continue;
+        }
+        texture->reload(TextureCache::instance()->request(path));
+        it = residentTextures.erase(it);
+        reloaded.insert(TextureCache::keyFor(QFileInfo(path)), texture);
+    }
+    for(auto it = reloaded.constBegin(); it != reloaded.constEnd(); ++it)
+        residentTextures.insert(it.key(), it.value());
 
-        glEnable(GL_DEPTH_TEST);
-        glDepthMask(GL_TRUE);
-        glClearDepth(1);
-        glDepthFunc(GL_LESS);
+    for(auto file : includeFiles)
+        if(files.contains(file)){
+            initShaders(vertexSource, fragmentSource);
+            break;
+        }
+}
 
 
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        vao->bind();
+/**
+ * @brief Renderer::render
+ *
+ * Initialize output device, execute the shader and display the result
+ */
+void Renderer::render(){
+//    qDebug() << QLatin1String(reinterpret_cast<const char*>(glGetString(GL_VERSION))) << " " << QLatin1String(reinterpret_cast<const char*>(glGetString(GL_SHADING_LANGUAGE_VERSION)));
+    // Window geometry and input are written by the GUI thread
+    pendingMutex.lock();
+        QSize surface = surfaceSize;
+        QVector2D mouse = mousePosition;
+        M = pendingM;
+        handleInput();
+    pendingMutex.unlock();
 
-        glUniformMatrix4fv(pID, 1, GL_FALSE, P.data());
-        glUniformMatrix4fv(vID, 1, GL_FALSE, V.data());
-        glUniformMatrix4fv(mID, 1, GL_FALSE, M.data());
+    if(!device)
+        device = new QOpenGLPaintDevice();
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_1D, audioLeftTexture);
+    device->setSize(surface);
 
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_1D, audioRightTexture);
+    state->viewport(0, 0, surface.width(), surface.height());
+    float ration = ((surface.height() == 0) ? 1 : (float)surface.width() / (float)surface.height());
 
-        for(int i = 0; i < textures.length(); ++i){
-            glActiveTexture(GL_TEXTURE2 + i);
-            textures[i]->bind();
-        }
+    // Uploads bind the texture on the active unit behind the cache's back
+    qint64 budget = textureUploadBudget;
+    for(auto &texture : textures){
+        if(texture->isComplete())
+            continue;
+        budget -= texture->upload(budget);
+        state->forgetBinding(GL_TEXTURE_2D);
+    }
 
-        shaderProgram->setUniformValue(mouseUniform, mousePosition);
-        shaderProgram->setUniformValue(rationUniform, ration);
-        shaderProgram->setUniformValue(timeUniform, GLfloat(time->elapsed()));
+    state->useProgram(shaderProgram->programId());
+    state->clearColor(0, 0, 0.3, 1);
+
+    state->polygonMode(GL_FILL);
+
+    state->setEnabled(GL_CULL_FACE, false);
+    state->setEnabled(GL_SCISSOR_TEST, false);
+    state->setEnabled(GL_STENCIL_TEST, false);
+
+    state->setEnabled(GL_DEPTH_TEST, true);
+    state->depthMask(GL_TRUE);
+    state->clearDepth(1);
+    state->depthFunc(GL_LESS);
+
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    uniforms->set(UniformTable::ProjectionMatrix, P);
+    uniforms->set(UniformTable::ViewMatrix, V);
+    uniforms->set(UniformTable::ModelMatrix, M);
+    uniforms->set(UniformTable::Mouse, mouse);
+    uniforms->set(UniformTable::Ration, ration);
+    uniforms->set(UniformTable::Time, GLfloat(clock.msecs()));
+    uniforms->set(UniformTable::TimeSeconds, GLfloat(clock.seconds()));
+    uniforms->set(UniformTable::TimeDelta, GLfloat(clock.delta()));
+    uniforms->set(UniformTable::Frame, GLint(clock.frame()));
+    // Extracted once per block on the audio thread
+    AudioFeatures features = audioBlock ? audioBlock->features : AudioFeatures{0, 0, 0, 0, 0};
+    uniforms->set(UniformTable::AudioLevel, features.level);
+    uniforms->set(UniformTable::AudioPeak, features.peak);
+    uniforms->set(UniformTable::AudioOnset, features.onset);
+    uniforms->set(UniformTable::Beat, features.beat);
+    uniforms->set(UniformTable::Bpm, features.bpm);
+    uniforms->flush();
+
+    for(int i = 0; i < audioUnits; ++i)
+        if(audioUsed[i])
+            state->bindTexture(i, GL_TEXTURE_1D, audioTextures[i]);
+
+    for(int i = 0; i < textures.length(); ++i)
+        if(texturesUsed[i])
+            state->bindTexture(audioUnits + i, GL_TEXTURE_2D, textures[i]->textureId());
+
+    for(int i = 0; i < videos.length(); ++i){
+        if(!texturesUsed[textures.length() + i])
+            continue;
+        GLuint unit = audioUnits + textures.length() + i;
+        videos[i]->update(*state, unit, qint64(clock.msecs()));
+        state->bindTexture(unit, GL_TEXTURE_2D, videos[i]->textureId());
+    }
 
 //        glDrawArrays(GL_TRIANGLES, 0, 6);
 //        MV  = V * M,
@@ -365,16 +694,12 @@ void Renderer::render(){
 //        glUniformMatrix4fv(mvpID, 1, GL_FALSE, MVP.data());
 
 
-        model.draw();
-
-        vao->release();
-        shaderProgram->release();
-    shaderProgramMutex.unlock();
+    model->draw(*state);
 }
 
 void Renderer::handleInput(){
-    float timeDelta = time->elapsed() - lastTime;
-    lastTime = time->elapsed();
+    // Moving the camera also works while the time is paused
+    float timeDelta = float(clock.realDelta());
 
     bool changed = false;
     bool alt = pressedKeys.contains(Qt::Key_Alt);
@@ -452,54 +777,103 @@ void Renderer::handleInput(){
 }
 
 /**
- * @brief Renderer::renderLater
+ * @brief Renderer::renderFrame
  *
- * Enqueue an update event to event queue
+ * Called by the render thread. Creates the context with the
+ * first frame, applies what the GUI thread queued since the
+ * last frame and draws one frame if the window is exposed.
  */
-void Renderer::renderLater(){
-    if(!pendingUpdate){
-        QCoreApplication::postEvent(this, new QEvent(QEvent::UpdateRequest));
-        pendingUpdate = true;
-    }
-}
-
-/**
- * @brief Renderer::renderNow
- *
- * Use the compiled shader to render on the widget
- */
-void Renderer::renderNow(){
-    pendingUpdate = false;
-
-    if(!isExposed())
+void Renderer::renderFrame() noexcept{
+    if(isStopping())
         return;
 
+    pendingMutex.lock();
+        if(!exposed){
+            pendingMutex.unlock();
+            return;
+        }
+        bool codeChanged = codePending, modelChanged = modelPending;
+        QString vertexShader = pendingVertex, fragmentShader = pendingFragment;
+        if(modelChanged)
+            modelFile = pendingModel;
+        if(clockPending)
+            clock.restart();
+        if(scrubPending)
+            clock.scrub(pendingScrub);
+        clock.setPaused(pendingPaused);
+        clock.setFixedStep(pendingStep);
+        bool pathsChanged = pendingIncludePaths != preprocessor.searchPaths();
+        preprocessor.setSearchPaths(pendingIncludePaths);
+        codePending = modelPending = clockPending = scrubPending = false;
+        QSet<QString> changedAssets = pendingAssets;
+        pendingAssets.clear();
+    pendingMutex.unlock();
+
     if(context)
         context->makeCurrent(this);
     else {
-        context = new QOpenGLContext(this);
+        context = new QOpenGLContext();
         context->setFormat(requestedFormat());
         context->create();
         context->makeCurrent(this);
 
+        m_logger = new QOpenGLDebugLogger();
+        connect(m_logger, &QOpenGLDebugLogger::messageLogged,
+                this, &Renderer::onMessageLogged, Qt::DirectConnection);
         if (m_logger->initialize()){
             m_logger->startLogging(QOpenGLDebugLogger::SynchronousLogging);
             m_logger->enableMessages();
         }
         initializeOpenGLFunctions();
-        init();
+        // Images are decoded to formats the context can sample
+        TextureCache::instance()->setExtensions(context->extensions());
+
+        // init() loads the model and compiles the current code anyway
+        if(codeChanged){
+            vertexSource = vertexShader;
+            fragmentSource = fragmentShader;
+            codeChanged = false;
+        }
+        modelChanged = false;
+        Q_EMIT compiled(init());
+    }
+
+    // Parsing a large model would stall every renderer
+    if(modelChanged)
+        pendingMesh = Model3D::request(modelFile.toStdString(), false);
+    if(pendingMesh && pendingMesh->isReady()){
+        // The upload binds and releases the vertex array of the model
+        if(pendingMesh->isValid() && pendingMesh->path == modelFile.toStdString()){
+            model->upload(pendingMesh->mesh());
+            state->forgetBinding(GL_VERTEX_ARRAY_BINDING);
+        }
+        pendingMesh.reset();
     }
 
+    // Edits of tweaked literals only set uniforms
+    if(codeChanged && retweak(vertexShader, fragmentShader)){
+        codeChanged = false;
+        Q_EMIT compiled(true);
+    }
+    if(codeChanged)
+        Q_EMIT compiled(initShaders(vertexShader, fragmentShader));
+    else if(pathsChanged && shaderProgram)
+        initShaders(vertexSource, fragmentSource);
 
     if(!shaderProgram)
         initShaders(vertexSource, fragmentSource);
 
+    if(!changedAssets.isEmpty())
+        reloadAssets(changedAssets);
+    watchAssets();
+
+    clock.tick();
+    uploadAudio();
+
     if(shaderProgram)
         render();
 
     context->swapBuffers(this);
-
-    renderLater();
 }
 
 /**
@@ -507,33 +881,52 @@ void Renderer::renderNow(){
  * @param event The event that should be proccessed
  * @return True if the event was successful proccessed, otherwise false
  *
- * Called if a new event is poped from the event-queue to render on update event
- * and Q_EMIT doneSignal on close event.
+ * Called if a new event is poped from the event-queue to record input for
+ * the render thread and Q_EMIT doneSignal on close event.
  */
 bool Renderer::event(QEvent *event){
     QMouseEvent *mouse;
+    QMutexLocker lock(&pendingMutex);
 
     switch(event->type()){
-    case QEvent::UpdateRequest:
-        QCoreApplication::postEvent(this, new QEvent(QEvent::UpdateRequest));
-        renderNow();
-        return true;
     case QEvent::Close:
+        lock.unlock();
         Q_EMIT doneSignal(tr("User closed renderer"));
         return true;
-    case QEvent::KeyPress:
-        pressedKeys.insert(((QKeyEvent*)event)->key());
+    case QEvent::KeyPress: {
+        int key = ((QKeyEvent*)event)->key();
+        bool repeated = ((QKeyEvent*)event)->isAutoRepeat();
+        double step = pendingStep;
+        if(key == Qt::Key_P && !repeated)
+            pendingPaused = !pendingPaused;
+        pressedKeys.insert(key);
+        lock.unlock();
+        if(key == Qt::Key_Home && !repeated)
+            scrub(0);
+        // Steps every frame as if at 60 fps, e.g. for recording
+        if(key == Qt::Key_F && !repeated)
+            setFixedStep(step > 0 ? 0 : 1000.0 / 60);
         return QWindow::event(event);
+    }
     case QEvent::KeyRelease:
         pressedKeys.remove((((QKeyEvent*)event)->key()));
+        lock.unlock();
         return QWindow::event(event);
     case QEvent::MouseMove:
         mouse = (QMouseEvent*)event;
         if(mouse->buttons() & Qt::LeftButton)  mouseDragLeft  += mouse->pos() - lastMousePosition;
         if(mouse->buttons() & Qt::RightButton) mouseDragRight += mouse->pos() - lastMousePosition;
         lastMousePosition = mouse->pos();
+        mousePosition = QVector2D((float)mouse->pos().x() / (float)qMax(1, width()),
+                                  (float)mouse->pos().y() / (float)qMax(1, height()));
+        lock.unlock();
+        return QWindow::event(event);
+    case QEvent::Resize:
+        lock.unlock();
+        updateSurface();
         return QWindow::event(event);
     default:
+        lock.unlock();
         return QWindow::event(event);
     }
 }
@@ -541,110 +934,111 @@ bool Renderer::event(QEvent *event){
 /**
  * @brief Renderer::exposeEvent
  *
- * Called if the window is ready to start rendering
+ * Called if the window is ready to start rendering or
+ * hidden; the render thread only draws exposed windows.
  */
 void Renderer::exposeEvent(QExposeEvent *){
-    if(isExposed())
-        renderNow();
+    updateSurface();
+}
+
+/**
+ * @brief Renderer::updateSurface
+ *
+ * Hands the size and visibility of the window to the render thread.
+ */
+void Renderer::updateSurface(){
+    QMutexLocker lock(&pendingMutex);
+    surfaceSize = size() * devicePixelRatio();
+    exposed = isExposed();
 }
 
 /**
  * @brief Renderer::updateCode
- * @param filename Text for the title
- * @param code New shader program code
- * @return True on success, otherwise false.
+ * @param vertCode New vertex shader code
+ * @param fragCode New fragment shader code
  *
- * Set new title and compile new code for the shader program
+ * Queue new code for the shader program. It is compiled with
+ * the next frame; errors are reported through the error signals
+ * and the result through compiled(). Code that is already
+ * running is not compiled again, code that failed is.
  */
-bool Renderer::updateCode(const QString &vertCode, const QString &fragCode){
-    if(!initShaders(vertCode, fragCode))
-        return false;
+void Renderer::updateCode(const QString &vertCode, const QString &fragCode){
+    pendingMutex.lock();
+        pendingVertex = vertCode;
+        pendingFragment = fragCode;
+        codePending = true;
+    pendingMutex.unlock();
     show();
-    return true;
 }
 
 /**
- * @brief Renderer::updateAudioData
- * @param data New audio data
+ * @brief Renderer::uploadAudio
  *
- * Copy the new sound-data to the graphics memory for visualisation
+ * Uploads the block of the audio capture for the current time
+ * straight from the block, if it is not the one shown. Textures
+ * the program does not sample are left alone.
  */
-void Renderer::updateAudioData(QByteArray data){
-    if(!shaderProgram)
+void Renderer::uploadAudio() noexcept{
+    if(!audio)
         return;
-    GLenum type, internalType;
-    Q_UNUSED(internalType);
-    char typeSize;
-    switch(audio->format().sampleType() + audio->format().sampleSize()){
-        case  8: case 10:
-            type = GL_UNSIGNED_BYTE;
-            internalType = GL_R8UI;
-            typeSize = 1;
-            break;
-        case  9:
-            type = GL_BYTE;
-            internalType = GL_R8I;
-            typeSize = 1;
-            break;
-        case 16: case 18:
-            type = GL_UNSIGNED_SHORT;
-            internalType = GL_R16UI;
-            typeSize = 2;
-            break;
-        case 17:
-            type = GL_SHORT;
-            internalType = GL_R16I;
-            typeSize = 2;
-            break;
-        case 32: case 34:
-            type = GL_UNSIGNED_INT;
-            internalType = GL_R32UI;
-            typeSize = 4;
-            break;
-        case 33:
-            type = GL_INT;
-            internalType = GL_R32I;
-            typeSize = 4;
-            break;
-        case 35:
-            type = GL_FLOAT;
-            internalType = GL_R32F;
-            typeSize = 4;
-            break;
-        default: return;
-    }
-    char *left, *right;
-    int count = data.size();
-    if(audio->format().channelCount() == 2){
-        count /= 2;
-        left  = new char[count];
-        right = new char[count];
-        for(int i = 0; i < count; i += typeSize){
-            for(int j = 0; j < typeSize; ++j){
-                left [i+j] = data[i*2+j];
-                right[i+j] = data[i*2+j+typeSize];
-            }
-        }
-    } else {
-        left = right = data.data();
+    auto block = audio->blockAt(qint64(clock.msecs()));
+    if(!block || block == audioBlock)
+        return;
+    audioBlock = block;
+
+    const QVector<float> *channels[audioUnits] = {
+        &block->left, &block->right, &block->leftSpectrum, &block->rightSpectrum
+    };
+    for(int i = 0; i < audioUnits; ++i){
+        if(!audioUsed[i])
+            continue;
+        state->bindTexture(i, GL_TEXTURE_1D, audioTextures[i]);
+        glTexImage1D(GL_TEXTURE_1D, 0, GL_R32F, channels[i]->size(), 0, GL_RED, GL_FLOAT, channels[i]->constData());
     }
+    audio->uploaded(*block);
+}
 
+/**
+ * @brief Renderer::setPaused
+ * @param paused True to hold the time the shader sees
+ *
+ * Takes effect with the next frame, like the P key.
+ */
+void Renderer::setPaused(bool paused){
+    QMutexLocker lock(&pendingMutex);
+    pendingPaused = paused;
+}
 
-    shaderProgramMutex.lock();
-        shaderProgram->bind();
-
-        glBindTexture(GL_TEXTURE_1D, audioLeftTexture);
-        glTexImage1D(GL_TEXTURE_1D, 0, GL_R32F, count / typeSize, 0, GL_RED, type, left);
+/**
+ * @brief Renderer::scrub
+ * @param msecs Time the next frame shows
+ */
+void Renderer::scrub(double msecs){
+    QMutexLocker lock(&pendingMutex);
+    pendingScrub = msecs;
+    scrubPending = true;
+}
 
-        glBindTexture(GL_TEXTURE_1D, audioRightTexture);
-        glTexImage1D(GL_TEXTURE_1D, 0, GL_R32F, count / typeSize, 0, GL_RED, type, right);
+/**
+ * @brief Renderer::setFixedStep
+ * @param msecs Milliseconds the time advances per frame,
+ * or zero to follow the real time
+ */
+void Renderer::setFixedStep(double msecs){
+    QMutexLocker lock(&pendingMutex);
+    pendingStep = msecs;
+}
 
-        shaderProgram->release();
-    shaderProgramMutex.unlock();
-    if(left != data.data())
-        delete[] left;
-    if(right != data.data())
-        delete[] right;
+/**
+ * @brief Renderer::setIncludePaths
+ * @param paths Directories to look up #include files in
+ *
+ * The code is compiled again with the next frame if the
+ * paths changed.
+ */
+void Renderer::setIncludePaths(const QStringList &paths){
+    QMutexLocker lock(&pendingMutex);
+    pendingIncludePaths = paths;
 }
 
 /**
@@ -663,36 +1057,26 @@ void Renderer::onMessageLogged(QOpenGLDebugMessage message){
  * @param offset Model position in 3D-Space
  * @param scaling Model scaling in 3D-Space
  * @param rotation Model rotation in 3D-Space
- * @return True on success, otherwise false.
+ * @return True, the model itself is loaded with the next frame.
  */
 bool Renderer::loadModel(const QString &file, const QVector3D &offset, const QVector3D &scaling, const QVector3D &rotation){
-//    if(file == modelFile)
-//        return true;
-
-    if(file != modelFile &&  context && context->isValid()){
-        shaderProgramMutex.lock();
-            shaderProgram->bind();
-            bool ok = model.loadModel(file.toStdString(), false);
-            shaderProgram->release();
-        shaderProgramMutex.unlock();
-
-        if(!ok)
-            return false;
-    }
-
     setTitle("ShaderSandbox | " + file);
 
-    modelFile = file;
-    modelOffset = offset;
-    modelScaling = scaling;
-    modelRotation = rotation;
-
-    M = QMatrix4x4();
-    M.rotate(rotation.x(), QVector3D(1, 0, 0));
-    M.rotate(rotation.y(), QVector3D(0, 1, 0));
-    M.rotate(rotation.z(), QVector3D(0, 0, 1));
-    M.scale(scaling);
-    M.translate(offset);
+    QMatrix4x4 matrix;
+    matrix.rotate(rotation.x(), QVector3D(1, 0, 0));
+    matrix.rotate(rotation.y(), QVector3D(0, 1, 0));
+    matrix.rotate(rotation.z(), QVector3D(0, 0, 1));
+    matrix.scale(scaling);
+    matrix.translate(offset);
+
+    // The model itself is loaded by the render thread with the next frame
+    pendingMutex.lock();
+        if(file != pendingModel){
+            pendingModel = file;
+            modelPending = true;
+        }
+        pendingM = matrix;
+    pendingMutex.unlock();
 //    uploadMVP();
 
     return true;
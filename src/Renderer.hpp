@@ -2,26 +2,47 @@
 #define RENDERER_HPP
 
 #include <QWindow>
+#include <QScreen>
 #include <QOpenGLPaintDevice>
 #include <QOpenGLFunctions>
 #include <QOpenGLVertexArrayObject>
 #include <QOpenGLDebugLogger>
 #include <QOpenGLTexture>
-#include <QTime>
 #include <QOpenGLShader>
 #include <QCoreApplication>
 #include <QDir>
 #include <QMutex>
 #include <QKeyEvent>
 
-#include "AudioInputProcessor.hpp"
+#include "AudioCapture.hpp"
 #include "Model3D.hpp"
+#include "TextureCache.hpp"
+#include "VideoTexture.hpp"
+#include "UniformTable.hpp"
+#include "GlStateCache.hpp"
+#include "FrameClock.hpp"
+#include "ShaderPreprocessor.hpp"
+#include "ShaderDiagnostics.hpp"
+#include "FileWatcher.hpp"
 
 /**
  * @brief The Renderer class
  *
  * A subclass of QWindow and QOPenGLFunctions that implements
  * a GLSL fragment shader renderer.
+ *
+ * The window lives on the GUI thread, but its context and all
+ * GL work belong to the RenderThread, which calls renderFrame()
+ * and releaseGl(). The slots only queue code, models and input
+ * under pendingMutex for the next frame. Audio is not queued at
+ * all: each frame takes the latest block of the shared
+ * AudioCapture, if one was set. Stopping is cooperative through
+ * requestStop().
+ *
+ * Include files, texture images and the model are watched on
+ * disk. A changed include recompiles the program, a changed
+ * image is refilled in place and a changed model is parsed
+ * on a worker while the old one is still drawn.
  */
 class Renderer : public QWindow, protected QOpenGLFunctions
 {
@@ -30,20 +51,33 @@ public:
     explicit Renderer(QWindow *parent = 0);
     explicit Renderer(const QString &vertexShader, const QString &fragmentShader, QWindow *parent = 0);
     ~Renderer();
+    void renderFrame() noexcept;
+    void releaseGl() noexcept;
+    int frameInterval() const noexcept;
+    void requestStop() noexcept;
+    bool isStopping() const noexcept;
+    void setParked(bool parked) noexcept;
+    void setAudioCapture(const AudioCapture *capture) noexcept;
 
 Q_SIGNALS:
     void doneSignal(QString);
     void errored(QString);
-    void vertexError(QString, int);
-    void fragmentError(QString, int);
+    void compiled(bool);
+    void vertexDiagnostics(QList<ShaderDiagnostic>);
+    void fragmentDiagnostics(QList<ShaderDiagnostic>);
 
 public Q_SLOTS:
-    void renderNow();
-    void renderLater();
-    bool updateCode(const QString &, const QString &);
-    void updateAudioData(QByteArray);
+    void updateCode(const QString &, const QString &);
     void onMessageLogged(QOpenGLDebugMessage message);
     bool loadModel(const QString &file, const QVector3D &offset, const QVector3D &scaling, const QVector3D &rotation);
+    void setPaused(bool paused);
+    void scrub(double msecs);
+    void setFixedStep(double msecs);
+    void setIncludePaths(const QStringList &paths);
+
+private Q_SLOTS:
+    void updateWatcher();
+    void assetsChanged(const QStringList &files);
 
 protected:
     virtual bool event(QEvent *);
@@ -54,38 +88,74 @@ private:
     void render();
     void handleInput();
     bool initShaders(QString, QString);
+    bool retweak(const QString &, const QString &) noexcept;
+    void applyTweaks(const ShaderPreprocessor::Result &, const ShaderPreprocessor::Result &) noexcept;
+    QString includeDirectory() const noexcept;
+    void watchAssets() noexcept;
+    void reloadAssets(const QSet<QString> &files) noexcept;
+    void updateSurface();
+    void uploadAudio() noexcept;
     QColor clearColor;
     QOpenGLContext *context;
     QOpenGLPaintDevice *device;
-    QTime *time;
-    bool pendingUpdate;
+    FrameClock clock;
+    int interval;
+    QAtomicInt stopRequested;
 
     QOpenGLVertexArrayObject *vao;
-    GLuint vertexBuffer, uvBuffer, audioLeftTexture, audioRightTexture;
-    GLint vertexAttr, uvAttr,
-        timeUniform, mouseUniform, rationUniform, samplerLeft, samplerRight,
-        mID, vID, pID;
+    // Samples and spectrum of both channels on units 0 to 3,
+    // #texture images and #video sequences follow
+    static const int audioUnits = 4;
+    GLuint vertexBuffer, uvBuffer, audioTextures[audioUnits];
+    GLint vertexAttr, uvAttr;
     QOpenGLShaderProgram *shaderProgram;
-    QMutex shaderProgramMutex;
+    UniformTable *uniforms;
+    GlStateCache *state;
+    bool audioUsed[audioUnits];
+    QVector<bool> texturesUsed;
     QString vertexSource, fragmentSource;
-    QList<QOpenGLTexture*> textures;
+    // Expanded code of the program, with literals lifted
+    QString compiledVertex, compiledFragment;
+    ShaderPreprocessor preprocessor;
+    QList<std::shared_ptr<StreamingTexture>> textures;
+    QHash<QString, std::shared_ptr<StreamingTexture>> residentTextures;
+    qint64 textureUploadBudget = 8 * 1024 * 1024;
+    QList<std::shared_ptr<VideoTexture>> videos;
+    QHash<QString, std::shared_ptr<VideoTexture>> residentVideos;
     QString modelFile;
-    QVector3D modelOffset, modelScaling, modelRotation;
-    Model3D model;
+    Model3D *model;
+    std::shared_ptr<PendingMesh> pendingMesh;
+    // Files the current program was expanded from
+    QStringList includeFiles;
+    FileWatcher *watcher;
     QMatrix4x4 P, V, M;
 
-    AudioInputProcessor *audio;
+    const AudioCapture *audio;
+    std::shared_ptr<const AudioBlock> audioBlock;
 
     QOpenGLDebugLogger* m_logger;
 
-    QVector3D cameraPosition;
-    float cameraRotation, cameraPitch;
-
-    QRegExp textureRegEx;
+    // Written by the GUI thread, taken by the render thread
+    QMutex pendingMutex;
+    QString pendingVertex, pendingFragment, pendingModel;
+    QStringList pendingIncludePaths;
+    QStringList watchedFiles;
+    QSet<QString> pendingAssets;
+    bool codePending, modelPending, clockPending, scrubPending;
+    bool pendingPaused;
+    double pendingScrub, pendingStep;
+    QMatrix4x4 pendingM;
+    QSize surfaceSize;
+    bool exposed;
+    QVector2D mousePosition;
     QSet<int> pressedKeys;
     QPoint lastMousePosition;
     QPoint mouseDragLeft, mouseDragRight;
-    float lastTime;
+
+    QVector3D cameraPosition;
+    float cameraRotation, cameraPitch;
+
+    QRegExp textureRegEx, videoRegEx;
     float keyMovementSpeed = 0.005;
     float keyRotationSpeed = 0.2;
     float mouseRotationSpeed = 0.2;
@@ -4,6 +4,15 @@
 const QString SettingsBackend::globalName = "ShaderSandbox";
 const QString SettingsBackend::globalDir = "Live Code Editor";
 
+/**
+ * @brief SettingsBackend::groupFor
+ * @param id
+ * @return the application name the settings of a child are stored under
+ */
+QString SettingsBackend::groupFor(const int id) noexcept{
+    return globalDir + "/" + QString::number(id);
+}
+
 /**
  * @brief SettingsBackend::getSettingsFor
  * @param key
@@ -18,8 +27,9 @@ const QString SettingsBackend::globalDir = "Live Code Editor";
 QVariant SettingsBackend::getSettingsFor(const QString key,
                                          const QVariant defaultOption,
                                          const int id) noexcept{
-    QString relevantSubdir(globalDir + "/" + QString::number(id));
-    QSettings set(globalName, relevantSubdir);
+    if(auto store = SettingsStore::active())
+        return store->value(groupFor(id), key, defaultOption);
+    QSettings set(globalName, groupFor(id));
     return set.value(key, defaultOption);
 }
 
@@ -33,6 +43,8 @@ QVariant SettingsBackend::getSettingsFor(const QString key,
  * settings for the key or returns defaultOption.
  */
 QVariant SettingsBackend::getSettingsFor(const QString key, const QVariant &defaultOption) noexcept{
+    if(auto store = SettingsStore::active())
+        return store->value(globalDir, key, defaultOption);
     return QSettings(globalName, globalDir).value(key, defaultOption);
 }
 
@@ -45,9 +57,10 @@ QVariant SettingsBackend::getSettingsFor(const QString key, const QVariant &defa
  * translates it to a QHash that is returned.
  */
 QHash<QString, QVariant> SettingsBackend::getSettings(const int id) noexcept{
+    if(auto store = SettingsStore::active())
+        return store->values(groupFor(id));
     QHash<QString, QVariant> settings;
-    QString relevantSubdir(globalDir + "/" + QString::number(id));
-    QSettings set(globalName, relevantSubdir);
+    QSettings set(globalName, groupFor(id));
     for(auto &key : set.childKeys())
         settings.insert(key, set.value(key));
     return settings;
@@ -61,6 +74,10 @@ QHash<QString, QVariant> SettingsBackend::getSettings(const int id) noexcept{
  * Adds an entry to the global settings.
  */
 void SettingsBackend::addSettings(const QString key, const QVariant value) noexcept{
+    if(auto store = SettingsStore::active()){
+        store->setValue(globalDir, key, value);
+        return;
+    }
     QSettings settings(globalName, globalDir);
     settings.setValue(key, value);
 }
@@ -76,14 +93,20 @@ void SettingsBackend::addSettings(const QString key, const QVariant value) noexc
  * Saves the settings of a instance.
  */
 void SettingsBackend::saveSettingsFor(const int id, const QString &key, const QVariant &value) noexcept{
-    QString relevantSubdir(globalDir + "/" + QString::number(id));
-    QSettings set(globalName, relevantSubdir);
+    if(auto store = SettingsStore::active()){
+        store->setValue(groupFor(id), key, value);
+        return;
+    }
+    QSettings set(globalName, groupFor(id));
     set.setValue(key, value);
 }
 
 void SettingsBackend::saveSettingsFor(const int id, const QHash<QString, QVariant> &settings) noexcept{
-    QString relevantSubdir(globalDir + "/" + QString::number(id));
-    QSettings set(globalName, relevantSubdir);
+    if(auto store = SettingsStore::active()){
+        store->setValues(groupFor(id), settings);
+        return;
+    }
+    QSettings set(globalName, groupFor(id));
     for(auto &key : settings.keys())
         set.setValue(key, settings[key]);
 }
@@ -95,7 +118,10 @@ void SettingsBackend::saveSettingsFor(const int id, const QHash<QString, QVarian
  * Removes the settings of a child.
  */
 void SettingsBackend::removeSettings(const int id) noexcept{
-    QString relevantSubdir(globalDir + "/" + QString::number(id));
-    QSettings set(globalName, relevantSubdir);
+    if(auto store = SettingsStore::active()){
+        store->remove(groupFor(id));
+        return;
+    }
+    QSettings set(globalName, groupFor(id));
     set.clear();
 }
@@ -3,11 +3,16 @@
 
 #include <QSettings>
 
+#include "SettingsStore.hpp"
+
 /**
  * @brief The SettingsBackend class
  *
  * A settings backend. Reads from and writes to the
- * platform independent persistent settings.
+ * platform independent persistent settings. While a
+ * SettingsStore is active, that is while the Backend runs,
+ * everything goes through its cache; otherwise the settings
+ * are read and written right away.
  */
 class SettingsBackend{
 public:
@@ -18,9 +23,12 @@ public:
     static void saveSettingsFor(const int id, const QString &key, const QVariant &value) noexcept;
     static void saveSettingsFor(const int id, const QHash<QString, QVariant> &) noexcept;
     static void removeSettings(const int) noexcept;
+
+    static const QString globalName;
 private:
-    static const QString globalName,
-                         globalDir;
+    static QString groupFor(const int id) noexcept;
+
+    static const QString globalDir;
 };
 
 #endif // SETTINGSBACKEND_HPP
@@ -0,0 +1,228 @@
+#include "SettingsStore.hpp"
+
+#include <QSettings>
+#include <QThread>
+#include <QDebug>
+
+SettingsStore *SettingsStore::activeStore = 0;
+
+/**
+ * @brief SettingsStore::SettingsStore
+ * @param organization Organization name of the settings
+ * @param parent Parent object
+ *
+ * The new store is the active one from now on.
+ */
+SettingsStore::SettingsStore(const QString &organization, QObject *parent) :
+    QObject(parent), organization(organization), flushCount(0)
+{
+    timer.setSingleShot(true);
+    timer.setInterval(flushDelay);
+    connect(&timer, &QTimer::timeout, this, &SettingsStore::flush);
+    writer.setMaxThreadCount(1);
+    activeStore = this;
+}
+
+/**
+ * @brief SettingsStore::~SettingsStore
+ *
+ * Writes what is dirty and waits until it is on disk.
+ */
+SettingsStore::~SettingsStore(){
+    if(activeStore == this)
+        activeStore = 0;
+    sync();
+}
+
+/**
+ * @brief SettingsStore::active
+ * @return The store of the application, or null if there is none
+ */
+SettingsStore *SettingsStore::active() noexcept{
+    return activeStore;
+}
+
+/**
+ * @brief SettingsStore::value
+ * @param group The settings file
+ * @param key The key of the value
+ * @param defaultValue What to return if the key is not set
+ * @return The value of the key
+ */
+QVariant SettingsStore::value(const QString &group, const QString &key, const QVariant &defaultValue) noexcept{
+    QMutexLocker lock(&mutex);
+    return load(group).value(key, defaultValue);
+}
+
+/**
+ * @brief SettingsStore::values
+ * @param group The settings file
+ * @return All keys of the group and their values
+ */
+QHash<QString, QVariant> SettingsStore::values(const QString &group) noexcept{
+    QMutexLocker lock(&mutex);
+    return load(group);
+}
+
+/**
+ * @brief SettingsStore::setValue
+ * @param group The settings file
+ * @param key The key of the value
+ * @param value The new value
+ */
+void SettingsStore::setValue(const QString &group, const QString &key, const QVariant &value) noexcept{
+    QMutexLocker lock(&mutex);
+    auto &values = load(group);
+    auto it = values.find(key);
+    if(it != values.end() && it.value() == value)
+        return;
+    values.insert(key, value);
+    changed(group);
+}
+
+/**
+ * @brief SettingsStore::setValues
+ * @param group The settings file
+ * @param values Keys and their new values
+ *
+ * Keys that are not given keep their values.
+ */
+void SettingsStore::setValues(const QString &group, const QHash<QString, QVariant> &values) noexcept{
+    QMutexLocker lock(&mutex);
+    auto &current = load(group);
+    bool modified = false;
+    for(auto it = values.begin(); it != values.end(); ++it){
+        auto old = current.find(it.key());
+        if(old != current.end() && old.value() == it.value())
+            continue;
+        current.insert(it.key(), it.value());
+        modified = true;
+    }
+    if(modified)
+        changed(group);
+}
+
+/**
+ * @brief SettingsStore::remove
+ * @param group The settings file
+ *
+ * Removes all keys of the group.
+ */
+void SettingsStore::remove(const QString &group) noexcept{
+    QMutexLocker lock(&mutex);
+    auto &values = load(group);
+    if(values.isEmpty())
+        return;
+    values.clear();
+    changed(group);
+}
+
+/**
+ * @brief SettingsStore::flush
+ *
+ * Hands the dirty groups to the writer and returns(SLOT).
+ */
+void SettingsStore::flush() noexcept{
+    QMutexLocker lock(&mutex);
+    if(dirty.isEmpty())
+        return;
+    QHash<QString, QHash<QString, QVariant>> batch;
+    for(auto &group : dirty)
+        batch.insert(group, groups.value(group));
+    dirty.clear();
+    ++flushCount;
+    lock.unlock();
+    writer.start(new SettingsWriter(organization, batch));
+}
+
+/**
+ * @brief SettingsStore::sync
+ *
+ * Flushes right away and waits until all batches are written.
+ */
+void SettingsStore::sync() noexcept{
+    flush();
+    writer.waitForDone();
+}
+
+/**
+ * @brief SettingsStore::flushes
+ * @return Number of batches handed to the writer so far
+ */
+quint64 SettingsStore::flushes() const noexcept{
+    QMutexLocker lock(&mutex);
+    return flushCount;
+}
+
+/**
+ * @brief SettingsStore::schedule
+ *
+ * Starts the delay again, so a burst of writes is flushed
+ * at its end(SLOT).
+ */
+void SettingsStore::schedule() noexcept{
+    timer.start();
+}
+
+/**
+ * @brief SettingsStore::load
+ * @param group The settings file
+ * @return The cached values of the group
+ *
+ * Reads the group on first use. Must be called with the
+ * mutex locked.
+ */
+QHash<QString, QVariant> &SettingsStore::load(const QString &group) noexcept{
+    auto it = groups.find(group);
+    if(it != groups.end())
+        return it.value();
+
+    QHash<QString, QVariant> values;
+    QSettings settings(organization, group);
+    for(auto &key : settings.allKeys())
+        values.insert(key, settings.value(key));
+    return groups.insert(group, values).value();
+}
+
+/**
+ * @brief SettingsStore::changed
+ * @param group A group whose values changed
+ *
+ * Must be called with the mutex locked. The timer belongs to
+ * the thread of the store, other threads queue the start.
+ */
+void SettingsStore::changed(const QString &group) noexcept{
+    dirty.insert(group);
+    if(QThread::currentThread() == thread())
+        timer.start();
+    else
+        QMetaObject::invokeMethod(this, "schedule", Qt::QueuedConnection);
+}
+
+/**
+ * @brief SettingsWriter::SettingsWriter
+ * @param organization Organization name of the settings
+ * @param batch Groups and all the values they have
+ */
+SettingsWriter::SettingsWriter(const QString &organization, const QHash<QString, QHash<QString, QVariant>> &batch) :
+    organization(organization), batch(batch)
+{ }
+
+/**
+ * @brief SettingsWriter::run
+ *
+ * Replaces the content of each group. QSettings keeps the
+ * changes in memory until the sync, which writes the file
+ * once.
+ */
+void SettingsWriter::run() noexcept{
+    for(auto it = batch.begin(); it != batch.end(); ++it){
+        QSettings settings(organization, it.key());
+        settings.clear();
+        for(auto value = it.value().begin(); value != it.value().end(); ++value)
+            settings.setValue(value.key(), value.value());
+        settings.sync();
+        if(settings.status() != QSettings::NoError)
+            qWarning() << "Failed to write settings" << settings.fileName();
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef SETTINGSSTORE_HPP
+#define SETTINGSSTORE_HPP
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QTimer>
+#include <QThreadPool>
+#include <QVariant>
+#include <QRunnable>
+
+/**
+ * @brief The SettingsStore class
+ *
+ * Keeps the persistent settings in memory. A group is the
+ * application name of a QSettings file of the organization;
+ * it is read once, on first use, and reads are served from
+ * memory from then on. Writes only change the memory and
+ * mark the group dirty. A moment after the last write all
+ * dirty groups are handed to a writer thread as one batch,
+ * where each is written with a single sync, so a burst of
+ * changes costs one write per file, off the GUI thread.
+ * Writing a value a group already has does not mark it.
+ *
+ * The store of the running application is owned by the
+ * Backend and becomes the active one; SettingsBackend goes
+ * through it. Destroying the store writes what is dirty and
+ * waits for it. The store may be used from any thread.
+ */
+class SettingsStore : public QObject{
+    Q_OBJECT
+public:
+    static const int flushDelay = 500;
+
+    explicit SettingsStore(const QString &organization, QObject *parent = 0);
+    ~SettingsStore();
+    static SettingsStore *active() noexcept;
+
+    QVariant value(const QString &group, const QString &key, const QVariant &defaultValue) noexcept;
+    QHash<QString, QVariant> values(const QString &group) noexcept;
+    void setValue(const QString &group, const QString &key, const QVariant &value) noexcept;
+    void setValues(const QString &group, const QHash<QString, QVariant> &values) noexcept;
+    void remove(const QString &group) noexcept;
+    void sync() noexcept;
+    quint64 flushes() const noexcept;
+
+public Q_SLOTS:
+    void flush() noexcept;
+
+private Q_SLOTS:
+    void schedule() noexcept;
+
+private:
+    SettingsStore(const SettingsStore &);
+    SettingsStore& operator=(const SettingsStore& rhs);
+
+    QHash<QString, QVariant> &load(const QString &group) noexcept;
+    void changed(const QString &group) noexcept;
+
+    static SettingsStore *activeStore;
+
+    const QString organization;
+    mutable QMutex mutex;
+    QHash<QString, QHash<QString, QVariant>> groups;
+    QSet<QString> dirty;
+    QTimer timer;
+    // A single thread, so batches are written in order
+    QThreadPool writer;
+    quint64 flushCount;
+};
+
+/**
+ * @brief The SettingsWriter class
+ *
+ * A runnable that writes a batch of groups.
+ */
+class SettingsWriter : public QRunnable{
+public:
+    SettingsWriter(const QString &organization, const QHash<QString, QHash<QString, QVariant>> &batch);
+    void run() noexcept Q_DECL_OVERRIDE;
+
+private:
+    const QString organization;
+    const QHash<QString, QHash<QString, QVariant>> batch;
+};
+
+#endif // SETTINGSSTORE_HPP
@@ -171,6 +171,8 @@ BehaviourTab::BehaviourTab(QHash<QString, QVariant> *Settings, QWidget* parent)
  */
 BehaviourTab::~BehaviourTab(){
     delete startup;
+    delete textures;
+    delete shaders;
 }
 
 /**
@@ -193,8 +195,28 @@ void BehaviourTab::addLayout() noexcept{
     startupLayout->addSpacing(10);
     startup->setLayout(startupLayout);
 
+    textures = new QGroupBox(tr("Textures"));
+    compressCheck = new QCheckBox(tr("Compress Textures On Load"));
+    compressCheck->setChecked(settings->value("CompressTextures").toBool());
+    connect(compressCheck, &QCheckBox::toggled, this, &BehaviourTab::compressSlot);
+
+    texturesLayout = new QVBoxLayout;
+    texturesLayout->addWidget(compressCheck);
+    textures->setLayout(texturesLayout);
+
+    shaders = new QGroupBox(tr("Shader Includes"));
+    includeEdit = new QLineEdit(settings->value("ShaderIncludePaths").toString());
+    includeEdit->setPlaceholderText(tr("Directories, separated by ;"));
+    connect(includeEdit, &QLineEdit::textEdited, this, &BehaviourTab::includeSlot);
+
+    shadersLayout = new QVBoxLayout;
+    shadersLayout->addWidget(includeEdit);
+    shaders->setLayout(shadersLayout);
+
     mainLayout = new QVBoxLayout;
     mainLayout->addWidget(startup);
+    mainLayout->addWidget(textures);
+    mainLayout->addWidget(shaders);
     mainLayout->addSpacing(12);
     mainLayout->addStretch(1);
     setLayout(mainLayout);
@@ -225,3 +247,186 @@ void BehaviourTab::sizeSlot(bool toggled) noexcept{
     settings->insert("RememberSize", toggled);
     Q_EMIT contentChanged();
 }
+
+/**
+ * @brief BehaviourTab::compressSlot
+ * @param toggled
+ *
+ * SLOT that reacts to the toggled() SIGNAL of
+ * compressCheck. Writes change to Hashlist and Q_EMITs
+ * a contentChanged signal.
+ */
+void BehaviourTab::compressSlot(bool toggled) noexcept{
+    settings->insert("CompressTextures", toggled);
+    Q_EMIT contentChanged();
+}
+
+/**
+ * @brief BehaviourTab::includeSlot
+ * @param text
+ *
+ * SLOT that reacts to the textEdited() SIGNAL of
+ * includeEdit. Writes change to Hashlist and Q_EMITs
+ * a contentChanged signal.
+ */
+void BehaviourTab::includeSlot(const QString &text) noexcept{
+    settings->insert("ShaderIncludePaths", text);
+    Q_EMIT contentChanged();
+}
+
+/**
+ * @brief AudioTab::AudioTab
+ *
+ * Constructor of the AudioTab class.
+ * Calls addLayout() and polls the status of audio, if given.
+ */
+AudioTab::AudioTab(QHash<QString, QVariant> *Settings, const AudioCapture *audio, QWidget* parent) :
+    SettingsTab(Settings, parent), audio(audio){
+    addLayout();
+    statusTimer = new QTimer(this);
+    connect(statusTimer, &QTimer::timeout, this, &AudioTab::updateStatus);
+    statusTimer->start(250);
+    updateStatus();
+}
+
+/**
+ * @brief AudioTab::~AudioTab
+ *
+ * Destructor of the AudioTab class.
+ * Deletes the GUI elements.
+ */
+AudioTab::~AudioTab(){
+    delete capture;
+    delete latency;
+}
+
+/**
+ * @brief AudioTab::addChoice
+ *
+ * Adds an entry to box and selects it if it is the current one.
+ */
+void AudioTab::addChoice(QComboBox *box, const QString &text, const QVariant &value, const QVariant &current) noexcept{
+    box->addItem(text, value);
+    if(value == current)
+        box->setCurrentIndex(box->count() - 1);
+}
+
+/**
+ * @brief AudioTab::addLayout
+ *
+ * Creates the audio tab UI and makes it interactive.
+ */
+void AudioTab::addLayout() noexcept{
+    capture = new QGroupBox(tr("Capture"));
+
+    deviceBox = new QComboBox;
+    addChoice(deviceBox, tr("Default"), QString(), settings->value("AudioDevice"));
+    for(auto &device : QAudioDeviceInfo::availableDevices(QAudio::AudioInput))
+        addChoice(deviceBox, device.deviceName(), device.deviceName(), settings->value("AudioDevice"));
+
+    rateBox = new QComboBox;
+    for(int rate : {8000, 11025, 22050, 44100, 48000, 96000})
+        addChoice(rateBox, tr("%1 Hz").arg(rate), rate, settings->value("AudioSampleRate"));
+
+    channelBox = new QComboBox;
+    addChoice(channelBox, tr("Mono"), 1, settings->value("AudioChannels"));
+    addChoice(channelBox, tr("Stereo"), 2, settings->value("AudioChannels"));
+
+    bufferBox = new QComboBox;
+    addChoice(bufferBox, tr("Default"), 0, settings->value("AudioBufferFrames"));
+    for(int frames : {64, 128, 256, 512, 1024, 2048, 4096})
+        addChoice(bufferBox, tr("%1 frames").arg(frames), frames, settings->value("AudioBufferFrames"));
+
+    // old style connect because of overloaded function
+    for(auto box : {deviceBox, rateBox, channelBox, bufferBox})
+        connect(box, SIGNAL(currentIndexChanged(int)),
+                this, SLOT(captureSettings(int)));
+
+    fileEdit = new QLineEdit(settings->value("AudioFile").toString());
+    fileEdit->setPlaceholderText(tr("None, capture from the device"));
+    fileButton = new QPushButton(tr("Browse..."));
+    connect(fileEdit, &QLineEdit::textChanged, this, [this](){ captureSettings(0); });
+    connect(fileButton, &QPushButton::clicked, this, &AudioTab::chooseFile);
+
+    fileLayout = new QHBoxLayout;
+    fileLayout->addWidget(fileEdit, 1);
+    fileLayout->addWidget(fileButton);
+
+    captureLayout = new QFormLayout;
+    captureLayout->addRow(tr("Device:"), deviceBox);
+    captureLayout->addRow(tr("Sample Rate:"), rateBox);
+    captureLayout->addRow(tr("Channels:"), channelBox);
+    captureLayout->addRow(tr("Buffer Size:"), bufferBox);
+    captureLayout->addRow(tr("File:"), fileLayout);
+    capture->setLayout(captureLayout);
+
+    latency = new QGroupBox(tr("Latency"));
+    formatLabel = new QLabel;
+    latencyLabel = new QLabel;
+
+    latencyLayout = new QVBoxLayout;
+    latencyLayout->addWidget(formatLabel);
+    latencyLayout->addWidget(latencyLabel);
+    latency->setLayout(latencyLayout);
+
+    mainLayout = new QVBoxLayout;
+    mainLayout->addWidget(capture);
+    mainLayout->addWidget(latency);
+    mainLayout->addSpacing(12);
+    mainLayout->addStretch(1);
+    setLayout(mainLayout);
+}
+
+/**
+ * @brief AudioTab::captureSettings
+ *
+ * SLOT that reacts to the currentIndexChanged SIGNAL
+ * of the capture drop down lists. Writes all of them to
+ * the Hashlist and Q_EMITs a contentChanged signal.
+ */
+void AudioTab::captureSettings(int) noexcept{
+    settings->insert("AudioDevice", deviceBox->currentData());
+    settings->insert("AudioSampleRate", rateBox->currentData());
+    settings->insert("AudioChannels", channelBox->currentData());
+    settings->insert("AudioBufferFrames", bufferBox->currentData());
+    settings->insert("AudioFile", fileEdit->text().trimmed());
+    Q_EMIT contentChanged();
+}
+
+/**
+ * @brief AudioTab::chooseFile
+ *
+ * SLOT that reacts to the clicked SIGNAL of fileButton.
+ * Lets the user pick a WAV or raw file to play instead
+ * of capturing from the device.
+ */
+void AudioTab::chooseFile() noexcept{
+    auto file = QFileDialog::getOpenFileName(this, tr("Audio File"), fileEdit->text(),
+                                             tr("Audio Files (*.wav *.raw *.pcm);;All Files (*)"));
+    if(!file.isEmpty())
+        fileEdit->setText(file);
+}
+
+/**
+ * @brief AudioTab::updateStatus
+ *
+ * SLOT that reacts to the timeout SIGNAL of statusTimer.
+ * Shows the current format and latency of the capture.
+ */
+void AudioTab::updateStatus() noexcept{
+    if(!audio){
+        formatLabel->setText(tr("No audio capture is running."));
+        latencyLabel->clear();
+        return;
+    }
+    auto status = audio->status();
+    formatLabel->setText(tr("%1: %2 Hz, %3 channels, period %4 frames, buffer %5 frames")
+                         .arg(status.device).arg(status.sampleRate).arg(status.channels)
+                         .arg(status.periodFrames).arg(status.bufferFrames));
+    if(status.averageLatency > 0)
+        latencyLabel->setText(tr("Capture to texture: %1 ms average, %2 ms worst")
+                              .arg(status.averageLatency, 0, 'f', 1)
+                              .arg(status.worstLatency, 0, 'f', 1));
+    else
+        latencyLabel->setText(tr("Capture to texture: no audio texture uploaded yet"));
+}
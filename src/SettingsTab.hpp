@@ -11,6 +11,12 @@
 #include <QButtonGroup>
 #include <QMessageBox>
 #include <QStyleFactory>
+#include <QFormLayout>
+#include <QLineEdit>
+#include <QFileDialog>
+#include <QTimer>
+
+#include "AudioCapture.hpp"
 
 /**
  * @brief The SettingsTab class
@@ -82,6 +88,8 @@ public:
 private Q_SLOTS:
     void openSlot(bool) noexcept;
     void sizeSlot(bool) noexcept;
+    void compressSlot(bool) noexcept;
+    void includeSlot(const QString &) noexcept;
 private:
     void addLayout() noexcept;
 
@@ -89,7 +97,52 @@ private:
     QCheckBox* openCheck;
     QCheckBox* sizeCheck;
     QVBoxLayout* startupLayout;
+    QGroupBox* textures;
+    QCheckBox* compressCheck;
+    QVBoxLayout* texturesLayout;
+    QGroupBox* shaders;
+    QLineEdit* includeEdit;
+    QVBoxLayout* shadersLayout;
+    QVBoxLayout* mainLayout;
+};
+
+/**
+ * @brief The AudioTab class
+ *
+ * A subclass of SettingsTab that implements one of the tabs
+ * of the SettingsWindow in which the audio capture can be
+ * configured. Shows the format the device actually runs with
+ * and the measured capture to texture latency while open.
+ */
+class AudioTab : public SettingsTab{
+Q_OBJECT
+public:
+    AudioTab(QHash<QString, QVariant> *Settings, const AudioCapture *audio = 0, QWidget* parent = 0);
+    ~AudioTab();
+private Q_SLOTS:
+    void captureSettings(int) noexcept;
+    void chooseFile() noexcept;
+    void updateStatus() noexcept;
+private:
+    void addLayout() noexcept;
+    static void addChoice(QComboBox *box, const QString &text, const QVariant &value, const QVariant &current) noexcept;
+
+    const AudioCapture *audio;
+    QGroupBox* capture;
+    QComboBox* deviceBox;
+    QComboBox* rateBox;
+    QComboBox* channelBox;
+    QComboBox* bufferBox;
+    QLineEdit* fileEdit;
+    QPushButton* fileButton;
+    QHBoxLayout* fileLayout;
+    QFormLayout* captureLayout;
+    QGroupBox* latency;
+    QLabel* formatLabel;
+    QLabel* latencyLabel;
+    QVBoxLayout* latencyLayout;
     QVBoxLayout* mainLayout;
+    QTimer* statusTimer;
 };
 
 #endif // SETTINGTABS
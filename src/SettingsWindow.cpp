@@ -4,20 +4,32 @@
  * @brief SettingsWindow::SettingsWindow
  *
  * The constructor of the settings window.
- * Sets up the SIGNALS, UI and the tabs.
+ * Sets up the SIGNALS, UI and the tabs. The audio tab shows
+ * the status of audio, if given.
  */
-SettingsWindow::SettingsWindow(int subDirNum){
+SettingsWindow::SettingsWindow(int subDirNum, const AudioCapture *audio){
     subDir = subDirNum;
     settingsDict = SettingsBackend::getSettings(subDirNum);
+    settingsDict.insert("CompressTextures", SettingsBackend::getSettingsFor("CompressTextures", false));
+    settingsDict.insert("ShaderIncludePaths", SettingsBackend::getSettingsFor("ShaderIncludePaths", QString()));
+    auto audioSettings = AudioSettings::load();
+    settingsDict.insert("AudioDevice", audioSettings.device);
+    settingsDict.insert("AudioSampleRate", audioSettings.sampleRate);
+    settingsDict.insert("AudioChannels", audioSettings.channels);
+    settingsDict.insert("AudioBufferFrames", audioSettings.bufferFrames);
+    settingsDict.insert("AudioFile", audioSettings.file);
 
     tabs = new QTabWidget;
     layout = new LayoutTab(&settingsDict, this);
     behaviour = new BehaviourTab(&settingsDict, this);
+    audioTab = new AudioTab(&settingsDict, audio, this);
     changed = false;
     tabs->addTab(layout, "Layout");
     connect(layout, &LayoutTab::contentChanged, this, &SettingsWindow::changedTrue);
     tabs->addTab(behaviour, "Behaviour");
     connect(behaviour, &BehaviourTab::contentChanged, this, &SettingsWindow::changedTrue);
+    tabs->addTab(audioTab, "Audio");
+    connect(audioTab, &AudioTab::contentChanged, this, &SettingsWindow::changedTrue);
 
     auto horizontal = new QHBoxLayout;
     horizontal->addWidget(tabs, 1);
@@ -54,6 +66,7 @@ SettingsWindow::SettingsWindow(int subDirNum){
 SettingsWindow::~SettingsWindow(){
     delete layout;
     delete behaviour;
+    delete audioTab;
     delete tabs;
 }
 
@@ -71,12 +84,32 @@ void SettingsWindow::apply() noexcept{
         SettingsBackend::addSettings("Design", settingsDict["Design"]);
         SettingsBackend::addSettings("OpenFiles", settingsDict["OpenFiles"]);
 
-        settingsDict.remove("Design");
-        settingsDict.remove("OpenFiles");
-
-        SettingsBackend::saveSettingsFor(subDir, settingsDict);
+        auto compress = settingsDict["CompressTextures"].toBool();
+        TextureCache::instance()->setCompression(compress);
+        SettingsBackend::addSettings("CompressTextures", compress);
+        SettingsBackend::addSettings("ShaderIncludePaths", settingsDict["ShaderIncludePaths"]);
+
+        AudioSettings audio{settingsDict["AudioDevice"].toString(),
+                            settingsDict["AudioSampleRate"].toInt(),
+                            settingsDict["AudioChannels"].toInt(),
+                            settingsDict["AudioBufferFrames"].toInt(),
+                            settingsDict["AudioFile"].toString()};
+        auto previous = AudioSettings::load();
+        auto audioChanged = audio.device != previous.device || audio.sampleRate != previous.sampleRate
+                         || audio.channels != previous.channels || audio.bufferFrames != previous.bufferFrames
+                         || audio.file != previous.file;
+        audio.save();
+
+        auto perInstance = settingsDict;
+        for(auto key : {"Design", "OpenFiles", "CompressTextures", "ShaderIncludePaths",
+                        "AudioDevice", "AudioSampleRate", "AudioChannels", "AudioBufferFrames", "AudioFile"})
+            perInstance.remove(key);
+
+        SettingsBackend::saveSettingsFor(subDir, perInstance);
 
         changed = false;
+        if(audioChanged)
+            Q_EMIT audioSettingsChanged();
     }
 }
 
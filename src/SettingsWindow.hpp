@@ -5,6 +5,7 @@
 
 #include "SettingsTab.hpp"
 #include "SettingsBackend.hpp"
+#include "TextureCache.hpp"
 
 /**
  * @brief The SettingsWindow class
@@ -18,9 +19,12 @@ class SettingsWindow : public QDialog{
 Q_OBJECT
 
 public:
-    SettingsWindow(int);
+    SettingsWindow(int, const AudioCapture *audio = 0);
     ~SettingsWindow();
 
+Q_SIGNALS:
+    void audioSettingsChanged();
+
 private Q_SLOTS:
    void apply() noexcept;
    void applyClose() noexcept;
@@ -34,6 +38,7 @@ private:
     QTabWidget *tabs;
     LayoutTab *layout;
     BehaviourTab *behaviour;
+    AudioTab *audioTab;
     QHash<QString,QVariant> settingsDict;
     int subDir;
 };
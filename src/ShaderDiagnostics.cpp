@@ -0,0 +1,114 @@
+#include "ShaderDiagnostics.hpp"
+
+#include <QRegExp>
+
+/**
+ * @brief ShaderDiagnostic::text
+ * @return The diagnostic as one line, like compilers print it
+ */
+QString ShaderDiagnostic::text() const noexcept{
+    QString location = file;
+    if(line > 0)
+        location += (file.isEmpty() ? "" : ":") + QString::number(line);
+    if(line > 0 && column > 0)
+        location += ":" + QString::number(column);
+    QString kind = severity == Error ? "error" : "warning";
+    return location.isEmpty() ? kind + ": " + message
+                              : location + ": " + kind + ": " + message;
+}
+
+/**
+ * @brief ShaderDiagnostics::parse
+ * @param log Info log of the driver
+ * @param expansion The preprocessor result that was compiled
+ * @return All errors and warnings in the order of the log
+ *
+ * Lines of the log without a known format are dropped, unless
+ * none has one; then the whole log is a single error.
+ */
+QList<ShaderDiagnostic> ShaderDiagnostics::parse(const QString &log, const ShaderPreprocessor::Result &expansion) noexcept{
+    // <string>:<line>(<column>): error: message
+    QRegExp mesa("^\\s*(\\d+):(\\d+)\\((\\d+)\\)\\s*:\\s*(error|warning)\\s*:?\\s*(.*)$", Qt::CaseInsensitive);
+    // <string>(<line>) : error C0000: message
+    QRegExp nvidia("^\\s*(\\d+)\\((\\d+)\\)\\s*:\\s*(error|warning)\\s*(C\\d+)?\\s*:?\\s*(.*)$", Qt::CaseInsensitive);
+    // ERROR: <string>:<line>: message
+    QRegExp amd("^\\s*(error|warning)\\s*:\\s*(\\d+):(\\d+)\\s*:\\s*(.*)$", Qt::CaseInsensitive);
+    // error: message, e.g. of the linker
+    QRegExp plain("^\\s*(error|warning)\\s*:\\s*(.*)$", Qt::CaseInsensitive);
+    // ERROR: 2 compilation errors.  No code generated.
+    QRegExp summary("^\\s*error\\s*:\\s*\\d+\\s+compilation errors", Qt::CaseInsensitive);
+
+    QList<ShaderDiagnostic> diagnostics;
+    for(auto &logLine : log.split('\n', QString::SkipEmptyParts)){
+        ShaderDiagnostic diagnostic{ShaderDiagnostic::Error, QString(), -1, -1, QString()};
+        int sourceString = -1, line = -1;
+
+        if(mesa.indexIn(logLine) != -1){
+            sourceString = mesa.cap(1).toInt();
+            line = mesa.cap(2).toInt();
+            diagnostic.column = mesa.cap(3).toInt();
+            diagnostic.severity = severity(mesa.cap(4));
+            diagnostic.message = mesa.cap(5).trimmed();
+        } else if(nvidia.indexIn(logLine) != -1){
+            sourceString = nvidia.cap(1).toInt();
+            line = nvidia.cap(2).toInt();
+            diagnostic.severity = severity(nvidia.cap(3));
+            diagnostic.message = nvidia.cap(5).trimmed();
+            if(!nvidia.cap(4).isEmpty())
+                diagnostic.message = nvidia.cap(4) + ": " + diagnostic.message;
+        } else if(amd.indexIn(logLine) != -1){
+            diagnostic.severity = severity(amd.cap(1));
+            sourceString = amd.cap(2).toInt();
+            line = amd.cap(3).toInt();
+            diagnostic.message = amd.cap(4).trimmed();
+        } else if(summary.indexIn(logLine) == -1 && plain.indexIn(logLine) != -1){
+            diagnostic.severity = severity(plain.cap(1));
+            diagnostic.message = plain.cap(2).trimmed();
+        } else
+            continue;
+
+        if(line >= 0){
+            auto location = expansion.locate(sourceString, line);
+            diagnostic.file = location.file;
+            diagnostic.line = location.line;
+        }
+        diagnostics.append(diagnostic);
+    }
+
+    if(diagnostics.isEmpty() && !log.trimmed().isEmpty())
+        diagnostics.append(ShaderDiagnostic{ShaderDiagnostic::Error, QString(), -1, -1, log.trimmed()});
+    return diagnostics;
+}
+
+/**
+ * @brief ShaderDiagnostics::format
+ * @param diagnostics
+ * @return One line per diagnostic
+ */
+QString ShaderDiagnostics::format(const QList<ShaderDiagnostic> &diagnostics) noexcept{
+    QStringList lines;
+    for(auto &diagnostic : diagnostics)
+        lines.append(diagnostic.text());
+    return lines.join('\n');
+}
+
+/**
+ * @brief ShaderDiagnostics::hasErrors
+ * @param diagnostics
+ * @return True if any of diagnostics is an error
+ */
+bool ShaderDiagnostics::hasErrors(const QList<ShaderDiagnostic> &diagnostics) noexcept{
+    for(auto &diagnostic : diagnostics)
+        if(diagnostic.severity == ShaderDiagnostic::Error)
+            return true;
+    return false;
+}
+
+/**
+ * @brief ShaderDiagnostics::severity
+ * @param word "error" or "warning" in any case
+ * @return The severity it names
+ */
+ShaderDiagnostic::Severity ShaderDiagnostics::severity(const QString &word) noexcept{
+    return word.compare("warning", Qt::CaseInsensitive) == 0 ? ShaderDiagnostic::Warning : ShaderDiagnostic::Error;
+}
@@ -0,0 +1,51 @@
+#ifndef SHADERDIAGNOSTICS_HPP
+#define SHADERDIAGNOSTICS_HPP
+
+#include <QList>
+#include <QMetaType>
+
+#include "ShaderPreprocessor.hpp"
+
+/**
+ * @brief The ShaderDiagnostic struct
+ *
+ * One error or warning of a shader compile or link. An empty
+ * file is the code from the editor, a line below one means the
+ * report has no location.
+ */
+struct ShaderDiagnostic{
+    enum Severity{ Error, Warning };
+
+    Severity severity;
+    QString file;
+    int line;
+    int column;
+    QString message;
+
+    QString text() const noexcept;
+};
+
+Q_DECLARE_METATYPE(ShaderDiagnostic)
+
+/**
+ * @brief The ShaderDiagnostics class
+ *
+ * Turns the info log of a shader compile or link into a list
+ * of diagnostics. Understands the log formats of Mesa
+ * ("0:12(5): error: ..."), NVIDIA ("0(12) : error C0000: ...")
+ * and AMD, Intel on Windows and macOS ("ERROR: 0:12: ...").
+ * The source string and line the driver reports are mapped
+ * back through the expansion of the preprocessor, so they
+ * point into the file they came from.
+ */
+class ShaderDiagnostics{
+public:
+    static QList<ShaderDiagnostic> parse(const QString &log, const ShaderPreprocessor::Result &expansion) noexcept;
+    static QString format(const QList<ShaderDiagnostic> &diagnostics) noexcept;
+    static bool hasErrors(const QList<ShaderDiagnostic> &diagnostics) noexcept;
+
+private:
+    static ShaderDiagnostic::Severity severity(const QString &word) noexcept;
+};
+
+#endif // SHADERDIAGNOSTICS_HPP
@@ -0,0 +1,131 @@
+#include "ShaderFile.hpp"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QTextCodec>
+#include <limits>
+
+/**
+ * @brief ShaderFile::Content::Content
+ *
+ * Empty UTF-8 text with newlines, as new files are written.
+ */
+ShaderFile::Content::Content() : codec("UTF-8"), bom(false), crlf(false)
+{ }
+
+/**
+ * @brief ShaderFile::Content::ok
+ * @return True if the file could be read
+ */
+bool ShaderFile::Content::ok() const noexcept{
+    return error.isEmpty();
+}
+
+/**
+ * @brief ShaderFile::read
+ * @param path Path of the file, may be a resource
+ * @return The decoded text, or an error
+ *
+ * Files that cannot be mapped, like compressed resources,
+ * are read into memory instead.
+ */
+ShaderFile::Content ShaderFile::read(const QString &path) noexcept{
+    QFile file(path);
+    if(!file.open(QFile::ReadOnly)){
+        Content content;
+        content.error = file.errorString();
+        return content;
+    }
+    qint64 size = file.size();
+    if(size > std::numeric_limits<int>::max()){
+        Content content;
+        content.error = QObject::tr("The file is too large");
+        return content;
+    }
+
+    // The mapping is released when the file is closed
+    const uchar *mapped = size > 0 ? file.map(0, size) : 0;
+    if(mapped)
+        return decode(reinterpret_cast<const char*>(mapped), int(size));
+    QByteArray data = file.readAll();
+    if(file.error() != QFile::NoError){
+        Content content;
+        content.error = file.errorString();
+        return content;
+    }
+    return decode(data.constData(), data.size());
+}
+
+/**
+ * @brief ShaderFile::decode
+ * @param data The bytes of a file
+ * @param size Number of bytes
+ * @return The text and the encoding it was stored in
+ */
+ShaderFile::Content ShaderFile::decode(const char *data, int size) noexcept{
+    Content content;
+    QTextCodec *codec = QTextCodec::codecForUtfText(QByteArray::fromRawData(data, qMin(size, 4)), 0);
+    content.bom = codec != 0;
+    if(codec)
+        content.text = codec->toUnicode(data, size);
+    else {
+        QTextCodec::ConverterState state;
+        codec = QTextCodec::codecForName("UTF-8");
+        content.text = codec->toUnicode(data, size, &state);
+        if(state.invalidChars || state.remainingChars){
+            codec = QTextCodec::codecForName("ISO-8859-1");
+            content.text = codec->toUnicode(data, size);
+        }
+    }
+    content.codec = codec->name();
+    if(content.text.startsWith(QChar(QChar::ByteOrderMark)))
+        content.text.remove(0, 1);
+
+    content.crlf = content.text.contains("\r\n");
+    if(content.crlf)
+        content.text.replace("\r\n", "\n");
+    return content;
+}
+
+/**
+ * @brief ShaderFile::write
+ * @param path Path of the file
+ * @param content Text and encoding to write
+ * @return An error message, empty on success
+ */
+QString ShaderFile::write(const QString &path, const Content &content) noexcept{
+    QByteArray data = encode(content);
+    QSaveFile file(path);
+    if(!file.open(QFile::WriteOnly))
+        return file.errorString();
+    if(file.write(data) != data.size()){
+        file.cancelWriting();
+        return file.errorString();
+    }
+    if(!file.commit())
+        return file.errorString();
+    return QString();
+}
+
+/**
+ * @brief ShaderFile::encode
+ * @param content Text and encoding to write
+ * @return The bytes of the file
+ *
+ * Text the encoding of the file cannot hold, like symbols
+ * typed into a Latin-1 file, is written as UTF-8.
+ */
+QByteArray ShaderFile::encode(const Content &content) noexcept{
+    QTextCodec *codec = QTextCodec::codecForName(content.codec);
+    if(!codec || !codec->canEncode(content.text))
+        codec = QTextCodec::codecForName("UTF-8");
+
+    QString text = content.text;
+    if(content.crlf)
+        text.replace("\n", "\r\n");
+    if(content.bom)
+        text.prepend(QChar(QChar::ByteOrderMark));
+    // The mark is part of the text, the codec must not add another
+    QTextCodec::ConverterState state(QTextCodec::IgnoreHeader);
+    return codec->fromUnicode(text.constData(), text.size(), &state);
+}
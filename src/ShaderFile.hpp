@@ -0,0 +1,47 @@
+#ifndef SHADERFILE_HPP
+#define SHADERFILE_HPP
+
+#include <QString>
+#include <QByteArray>
+#include <QMetaType>
+
+/**
+ * @brief The ShaderFile class
+ *
+ * Reads and writes the files of the editor without a
+ * QTextStream. Files are mapped into memory and decoded in
+ * one pass. The encoding is taken from a byte order mark;
+ * without one, a file that is valid UTF-8 is read as UTF-8
+ * and anything else as Latin-1. Windows line endings become
+ * plain newlines. All of that is remembered in the Content,
+ * so writing it back gives the file the user started with.
+ *
+ * Writing goes through a QSaveFile: the new text replaces
+ * the file only once it is completely written, so a failed
+ * save never leaves a truncated shader behind.
+ *
+ * The functions do not touch the GUI and may be called from
+ * any thread.
+ */
+class ShaderFile{
+public:
+    struct Content{
+        QString text;
+        QByteArray codec;
+        bool bom;
+        bool crlf;
+        QString error;
+
+        Content();
+        bool ok() const noexcept;
+    };
+
+    static Content read(const QString &path) noexcept;
+    static Content decode(const char *data, int size) noexcept;
+    static QString write(const QString &path, const Content &content) noexcept;
+    static QByteArray encode(const Content &content) noexcept;
+};
+
+Q_DECLARE_METATYPE(ShaderFile::Content)
+
+#endif // SHADERFILE_HPP
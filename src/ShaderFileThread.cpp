@@ -0,0 +1,109 @@
+#include "ShaderFileThread.hpp"
+
+/**
+ * @brief ShaderFileThread::ShaderFileThread
+ * @param parent Parent object
+ */
+ShaderFileThread::ShaderFileThread(QObject *parent) :
+    QThread(parent), tickets(0), stopping(false)
+{
+    // Results are delivered to the GUI thread
+    qRegisterMetaType<ShaderFile::Content>("ShaderFile::Content");
+}
+
+/**
+ * @brief ShaderFileThread::~ShaderFileThread
+ *
+ * Waits until the waiting saves are written.
+ */
+ShaderFileThread::~ShaderFileThread(){
+    stop();
+}
+
+/**
+ * @brief ShaderFileThread::load
+ * @param path Path of the file to read
+ * @return The ticket loaded() reports the file with
+ */
+int ShaderFileThread::load(const QString &path) noexcept{
+    return queue(Job{0, false, path, ShaderFile::Content(), QList<int>()});
+}
+
+/**
+ * @brief ShaderFileThread::save
+ * @param path Path of the file to write
+ * @param content Text and encoding to write
+ * @return The ticket saved() reports the file with
+ */
+int ShaderFileThread::save(const QString &path, const ShaderFile::Content &content) noexcept{
+    return queue(Job{0, true, path, content, QList<int>()});
+}
+
+/**
+ * @brief ShaderFileThread::queue
+ * @param job The job to run
+ * @return Its ticket, zero if the thread is stopping
+ *
+ * Starts the thread if needed and returns immediately.
+ */
+int ShaderFileThread::queue(const Job &job) noexcept{
+    QMutexLocker lock(&mutex);
+    if(stopping)
+        return 0;
+    jobs.append(job);
+    if(job.save)
+        for(int i = 0; i < jobs.size() - 1; ++i)
+            if(jobs[i].save && jobs[i].path == job.path){
+                jobs.last().superseded << jobs[i].superseded << jobs[i].ticket;
+                jobs.removeAt(i--);
+            }
+    jobs.last().ticket = ++tickets;
+    changed.wakeAll();
+    lock.unlock();
+    if(!isRunning())
+        start();
+    return tickets;
+}
+
+/**
+ * @brief ShaderFileThread::stop
+ *
+ * Drops the waiting loads and waits until the thread quit.
+ */
+void ShaderFileThread::stop() noexcept{
+    mutex.lock();
+    stopping = true;
+    for(int i = 0; i < jobs.size(); ++i)
+        if(!jobs[i].save)
+            jobs.removeAt(i--);
+    changed.wakeAll();
+    mutex.unlock();
+    wait();
+}
+
+/**
+ * @brief ShaderFileThread::run
+ *
+ * Runs the waiting jobs one after the other, then sleeps
+ * until the next.
+ */
+void ShaderFileThread::run() noexcept{
+    QMutexLocker lock(&mutex);
+    while(!stopping || !jobs.isEmpty()){
+        if(jobs.isEmpty()){
+            changed.wait(&mutex);
+            continue;
+        }
+        Job job = jobs.takeFirst();
+
+        lock.unlock();
+        if(job.save){
+            auto error = ShaderFile::write(job.path, job.content);
+            for(auto ticket : job.superseded)
+                Q_EMIT saved(ticket, job.path, error);
+            Q_EMIT saved(job.ticket, job.path, error);
+        } else
+            Q_EMIT loaded(job.ticket, job.path, ShaderFile::read(job.path));
+        lock.relock();
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef SHADERFILETHREAD_HPP
+#define SHADERFILETHREAD_HPP
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include "ShaderFile.hpp"
+
+/**
+ * @brief The ShaderFileThread class
+ *
+ * Loads and saves the files of an editor window off the GUI
+ * thread, so neither a huge file nor a slow disk blocks
+ * typing. Jobs run in the order they were queued and every
+ * job has a ticket the result is reported with. A save that
+ * is still waiting when the same file is saved again is
+ * replaced by the newer one; its ticket is reported with the
+ * result of the newer save. Stopping drops waiting loads,
+ * but finishes waiting saves.
+ */
+class ShaderFileThread : public QThread{
+    Q_OBJECT
+public:
+    explicit ShaderFileThread(QObject *parent = 0);
+    ~ShaderFileThread();
+    int load(const QString &path) noexcept;
+    int save(const QString &path, const ShaderFile::Content &content) noexcept;
+    void stop() noexcept;
+
+Q_SIGNALS:
+    void loaded(int ticket, QString path, ShaderFile::Content content);
+    void saved(int ticket, QString path, QString error);
+
+protected:
+    void run() noexcept Q_DECL_OVERRIDE;
+
+private:
+    struct Job{
+        int ticket;
+        bool save;
+        QString path;
+        ShaderFile::Content content;
+        // Tickets of the saves this one replaced
+        QList<int> superseded;
+    };
+
+    ShaderFileThread(const ShaderFileThread &);
+    ShaderFileThread& operator=(const ShaderFileThread& rhs);
+
+    int queue(const Job &job) noexcept;
+
+    QMutex mutex;
+    QWaitCondition changed;
+    QList<Job> jobs;
+    int tickets;
+    bool stopping;
+};
+
+#endif // SHADERFILETHREAD_HPP
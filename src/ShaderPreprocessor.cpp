@@ -0,0 +1,395 @@
+#include "ShaderPreprocessor.hpp"
+
+#include <QCryptographicHash>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+
+const QString ShaderPreprocessor::builtinIncludePath = ":/rc/include";
+
+static const int cacheLimit = 64;
+
+/**
+ * @brief ShaderPreprocessor::Result::ok
+ * @return True if all includes were found
+ */
+bool ShaderPreprocessor::Result::ok() const noexcept{
+    return error.isEmpty();
+}
+
+/**
+ * @brief ShaderPreprocessor::Result::locate
+ * @param sourceString Source string number reported by the driver
+ * @param line Line reported by the driver
+ * @return The file and line the report is about
+ */
+SourceLocation ShaderPreprocessor::Result::locate(int sourceString, int line) const noexcept{
+    if(sourceString < 0 || sourceString >= files.size())
+        return SourceLocation{QString(), line};
+    return SourceLocation{files[sourceString], line};
+}
+
+/**
+ * @brief ShaderPreprocessor::Result::locateLine
+ * @param line Line of source, counted from one
+ * @return The file and line it came from
+ */
+SourceLocation ShaderPreprocessor::Result::locateLine(int line) const noexcept{
+    if(line < 1 || line > lines.size())
+        return SourceLocation{QString(), line};
+    auto &origin = lines[line - 1];
+    return locate(origin.first, origin.second);
+}
+
+/**
+ * @brief ShaderPreprocessor::ShaderPreprocessor
+ */
+ShaderPreprocessor::ShaderPreprocessor() :
+    includeRegEx("^\\s*#\\s*include\\s*(\"([^\"]+)\"|<([^>]+)>)\\s*(//.*)?$"),
+    versionRegEx("^\\s*#\\s*version\\b"),
+    tweakRegEx("^\\s*#\\s*pragma\\s+tweak\\s+(on|off)\\b"),
+    lineRegEx("^\\s*#\\s*line\\s+([0-9]+)(\\s+([0-9]+))?\\b"),
+    readCount(0)
+{ }
+
+/**
+ * @brief ShaderPreprocessor::setSearchPaths
+ * @param paths Directories to look up includes in, in order
+ */
+void ShaderPreprocessor::setSearchPaths(const QStringList &paths) noexcept{
+    if(paths == this->paths)
+        return;
+    this->paths = paths;
+    cache.clear();
+}
+
+/**
+ * @brief ShaderPreprocessor::searchPaths
+ * @return Directories includes are looked up in
+ */
+QStringList ShaderPreprocessor::searchPaths() const noexcept{
+    return paths;
+}
+
+/**
+ * @brief ShaderPreprocessor::reads
+ * @return Number of files read from disk so far
+ */
+quint64 ShaderPreprocessor::reads() const noexcept{
+    return readCount;
+}
+
+/**
+ * @brief ShaderPreprocessor::process
+ * @param source Code from the editor
+ * @param directory Directory quoted includes of source are relative to
+ * @param tweakPrefix Names of lifted literals start with it; it has to
+ *        differ for the stages of one program
+ * @return The expanded code, or an error with its location
+ */
+ShaderPreprocessor::Result ShaderPreprocessor::process(const QString &source, const QString &directory,
+                                                       const QString &tweakPrefix) noexcept{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(source.toUtf8());
+    hash.addData(directory.toUtf8());
+    hash.addData(tweakPrefix.toUtf8());
+    auto key = hash.result();
+
+    auto cached = cache.find(key);
+    if(cached != cache.end()){
+        bool valid = true;
+        for(auto &stamp : cached->stamps)
+            valid = valid && unchanged(stamp.first, stamp.second);
+        if(valid)
+            return cached->result;
+    }
+
+    Result result;
+    result.files.append(QString());
+    if(expand(source, 0, directory, result))
+        lift(result, tweakPrefix);
+    mapLines(result);
+
+    if(result.ok()){
+        Entry entry{result, {}};
+        for(int i = 1; i < result.files.size(); ++i)
+            entry.stamps.append(qMakePair(result.files[i], files.value(result.files[i])));
+        if(cache.size() >= cacheLimit)
+            cache.clear();
+        cache.insert(key, entry);
+    }
+    return result;
+}
+
+/**
+ * @brief ShaderPreprocessor::expand
+ * @param text Code of one file
+ * @param index Its source string number
+ * @param directory Directory of the file
+ * @param result Receives the expanded code and the files
+ * @return False on an include that was not found
+ */
+bool ShaderPreprocessor::expand(const QString &text, int index, const QString &directory, Result &result) noexcept{
+    auto lines = text.split('\n');
+    for(int i = 0; i < lines.size(); ++i){
+        if(includeRegEx.indexIn(lines[i]) == -1){
+            result.source += lines[i];
+            if(i + 1 < lines.size())
+                result.source += '\n';
+            if(index == 0 && i + 1 < lines.size() && versionRegEx.indexIn(lines[i]) != -1)
+                result.source += QString("#line %1 0\n").arg(i + 2);
+            continue;
+        }
+
+        bool quoted = !includeRegEx.cap(2).isEmpty();
+        QString name = quoted ? includeRegEx.cap(2) : includeRegEx.cap(3);
+        QString path = resolve(name, quoted, directory);
+        const File *file = path.isEmpty() ? 0 : load(path);
+        if(!file){
+            result.error = QString("Include file not found: %1").arg(name);
+            result.errorLocation = SourceLocation{result.files[index], i + 1};
+            return false;
+        }
+
+        // Included once; the directive stays as an empty line
+        if(result.files.contains(path)){
+            result.source += '\n';
+            continue;
+        }
+
+        // Loading nested files may move file in the hash
+        QString content = file->content;
+        int child = result.files.size();
+        result.files.append(path);
+        result.source += QString("#line 1 %1\n").arg(child);
+        if(!expand(content, child, QFileInfo(path).absolutePath(), result))
+            return false;
+        if(!result.source.endsWith('\n'))
+            result.source += '\n';
+        result.source += QString("#line %1 %2\n").arg(i + 2).arg(index);
+    }
+    return true;
+}
+
+/**
+ * @brief ShaderPreprocessor::mapLines
+ * @param result An expansion
+ *
+ * Records where each line of the expanded code came from. A
+ * #line directive sets the line and source string of the line
+ * after it, the directive itself keeps the location it has.
+ */
+void ShaderPreprocessor::mapLines(Result &result) const noexcept{
+    int sourceString = 0, line = 1;
+    auto lines = result.source.split('\n');
+    result.lines.clear();
+    result.lines.reserve(lines.size());
+    for(auto &text : lines){
+        result.lines.append(qMakePair(sourceString, line));
+        if(lineRegEx.indexIn(text) != -1){
+            line = lineRegEx.cap(1).toInt();
+            if(!lineRegEx.cap(3).isEmpty())
+                sourceString = lineRegEx.cap(3).toInt();
+        } else
+            ++line;
+    }
+}
+
+/**
+ * @brief ShaderPreprocessor::lift
+ * @param result An expansion without errors
+ * @param prefix Names of the uniforms start with it
+ *
+ * Replaces the literals of #pragma tweak regions with uniforms
+ * and declares those after the #version line, which may follow
+ * comments and empty lines. Lines stay where they are: the
+ * declarations are followed by a #line directive.
+ */
+void ShaderPreprocessor::lift(Result &result, const QString &prefix) noexcept{
+    auto lines = result.source.split('\n');
+    bool region = false, comment = false, layout = false;
+    // Literals are kept up to skipTo, in brackets and in layout()
+    QChar skipTo;
+    int brackets = 0, layoutDepth = 0;
+
+    for(auto &line : lines){
+        if(tweakRegEx.indexIn(line) != -1){
+            region = tweakRegEx.cap(1) == "on";
+            comment = false;
+            continue;
+        }
+        if(!region || (!comment && line.trimmed().startsWith('#')))
+            continue;
+
+        QString out;
+        const QChar *data = line.constData();
+        const int length = line.length();
+        int i = 0;
+        while(i < length){
+            QChar c = data[i];
+            QChar next = i + 1 < length ? data[i + 1] : QChar();
+            int start = i;
+            if(comment){
+                int end = line.indexOf(QLatin1String("*/"), i);
+                comment = end < 0;
+                i = comment ? length : end + 2;
+            } else if(c == '/' && next == '/')
+                i = length;
+            else if(c == '/' && next == '*'){
+                comment = true;
+                i += 2;
+            } else if(c.isLetter() || c == '_'){
+                while(i < length && (data[i].isLetterOrNumber() || data[i] == '_'))
+                    ++i;
+                QString word = line.mid(start, i - start);
+                if(word == "const")
+                    skipTo = ';';
+                else if(word == "case")
+                    skipTo = ':';
+                layout = word == "layout";
+                out += word;
+                continue;
+            } else if(c.isDigit() || (c == '.' && next.isDigit())){
+                for(++i; i < length; ++i){
+                    QChar d = data[i];
+                    bool sign = (d == '+' || d == '-') && (data[i - 1] == 'e' || data[i - 1] == 'E')
+                            && !line.midRef(start, 2).startsWith(QLatin1String("0x"), Qt::CaseInsensitive);
+                    if(!d.isLetterOrNumber() && d != '.' && !sign)
+                        break;
+                }
+                Tweak tweak;
+                if(skipTo.isNull() && brackets == 0 && layoutDepth == 0
+                        && literal(line.mid(start, i - start), tweak)){
+                    tweak.name = prefix + QString::number(result.tweaks.size());
+                    result.tweaks.append(tweak);
+                    out += tweak.name;
+                    continue;
+                }
+            } else {
+                if(c == skipTo)
+                    skipTo = QChar();
+                else if(c == '[')
+                    ++brackets;
+                else if(c == ']')
+                    brackets = qMax(0, brackets - 1);
+                else if(c == '(' && (layout || layoutDepth > 0))
+                    ++layoutDepth;
+                else if(c == ')' && layoutDepth > 0)
+                    --layoutDepth;
+                if(!c.isSpace())
+                    layout = false;
+                ++i;
+            }
+            out += line.midRef(start, i - start);
+        }
+        line = out;
+    }
+    if(result.tweaks.isEmpty())
+        return;
+
+    QStringList declarations;
+    for(auto &tweak : result.tweaks)
+        declarations.append(QString("uniform %1 %2;").arg(tweak.type == Tweak::Float ? "float" : "int").arg(tweak.name));
+    // expand() put a #line directive after the #version line
+    int version = -1;
+    bool leadingComment = false;
+    for(int i = 0; i < lines.size() && version < 0; ++i){
+        auto text = lines[i].trimmed();
+        if(leadingComment)
+            leadingComment = !text.contains(QLatin1String("*/"));
+        else if(versionRegEx.indexIn(lines[i]) != -1)
+            version = i;
+        else if(text.startsWith(QLatin1String("/*")))
+            leadingComment = !text.contains(QLatin1String("*/"));
+        else if(!text.isEmpty() && !text.startsWith(QLatin1String("//")))
+            break;
+    }
+    if(version >= 0)
+        lines.insert(version + 1, declarations.join('\n'));
+    else
+        lines.insert(0, declarations.join('\n') + "\n#line 1 0");
+    result.source = lines.join('\n');
+}
+
+/**
+ * @brief ShaderPreprocessor::literal
+ * @param token A number
+ * @param tweak Receives its type and value
+ * @return False for literals that are not lifted
+ */
+bool ShaderPreprocessor::literal(const QString &token, Tweak &tweak) noexcept{
+    bool ok;
+    bool hex = token.startsWith(QLatin1String("0x"), Qt::CaseInsensitive);
+    if(token.endsWith(QLatin1String("lf"), Qt::CaseInsensitive) || token.endsWith('u') || token.endsWith('U'))
+        return false;
+    if(!hex && (token.contains('.') || token.contains('e') || token.contains('E')
+                || token.endsWith('f') || token.endsWith('F'))){
+        QString number = token;
+        if(number.endsWith('f') || number.endsWith('F'))
+            number.chop(1);
+        tweak.type = Tweak::Float;
+        tweak.value = number.toDouble(&ok);
+        return ok;
+    }
+    // Octal and hexadecimal like in C
+    qlonglong value = token.toLongLong(&ok, 0);
+    tweak.type = Tweak::Int;
+    tweak.value = value;
+    return ok && value <= 0x7fffffff;
+}
+
+/**
+ * @brief ShaderPreprocessor::resolve
+ * @param name Name in the directive
+ * @param quoted True for "name", false for <name>
+ * @param directory Directory of the including file
+ * @return Absolute path of the file, or an empty string
+ */
+QString ShaderPreprocessor::resolve(const QString &name, bool quoted, const QString &directory) const noexcept{
+    QStringList candidates;
+    if(QFileInfo(name).isAbsolute())
+        candidates.append(name);
+    else {
+        if(quoted && !directory.isEmpty())
+            candidates.append(QDir(directory).filePath(name));
+        for(auto &path : paths)
+            candidates.append(QDir(path).filePath(name));
+        candidates.append(QDir(builtinIncludePath).filePath(name));
+    }
+
+    for(auto &candidate : candidates){
+        QFileInfo info(candidate);
+        if(info.isFile())
+            return info.absoluteFilePath();
+    }
+    return QString();
+}
+
+/**
+ * @brief ShaderPreprocessor::load
+ * @param path Absolute path of a file
+ * @return The file, read again only if it changed, or null
+ */
+const ShaderPreprocessor::File *ShaderPreprocessor::load(const QString &path) noexcept{
+    auto known = files.find(path);
+    if(known != files.end() && unchanged(path, *known))
+        return &*known;
+
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return 0;
+    QFileInfo info(path);
+    ++readCount;
+    return &*files.insert(path, File{info.lastModified(), info.size(), QString::fromUtf8(file.readAll())});
+}
+
+/**
+ * @brief ShaderPreprocessor::unchanged
+ * @param path Absolute path of a file
+ * @param stamp What was known about the file
+ * @return True if modification time and size are still the same
+ */
+bool ShaderPreprocessor::unchanged(const QString &path, const File &stamp) noexcept{
+    QFileInfo info(path);
+    return info.exists() && info.lastModified() == stamp.modified && info.size() == stamp.size;
+}
@@ -0,0 +1,123 @@
+#ifndef SHADERPREPROCESSOR_HPP
+#define SHADERPREPROCESSOR_HPP
+
+#include <QHash>
+#include <QDateTime>
+#include <QStringList>
+#include <QRegExp>
+#include <QVector>
+#include <QPair>
+
+/**
+ * @brief The SourceLocation struct
+ *
+ * A line in one of the files a shader was built from. An
+ * empty file is the code from the editor.
+ */
+struct SourceLocation{
+    QString file;
+    int line;
+};
+
+/**
+ * @brief The ShaderPreprocessor class
+ *
+ * Expands #include "file" and #include <file> directives in
+ * shader code. Quoted names are looked up next to the including
+ * file first, then like bracketed ones in the search paths and
+ * finally in the built-in include directory. Every file is
+ * included once per shader, so helper files need no guards.
+ *
+ * Each included file becomes its own GLSL source string: the
+ * expansion is framed by #line directives, so the driver
+ * reports errors as source string and line of the original
+ * file, which Result::locate() turns back into a location.
+ * Result::locateLine() does the same for a line of the
+ * expanded code, following the #line directives like the
+ * driver does.
+ * The #version line of the main code is followed by a #line
+ * as well, as lines inserted after it by Qt would otherwise
+ * shift all line numbers.
+ *
+ * Number literals between #pragma tweak on and #pragma tweak
+ * off are lifted into uniforms that are declared after the
+ * #version line. Code that differs only in those numbers
+ * expands to the same source, so a renderer can set the
+ * values of Result::tweaks instead of compiling again.
+ * Literals that need a constant expression are left alone:
+ * those of const declarations, array sizes, layout qualifiers,
+ * case labels and directives. Unsigned and double literals
+ * are left alone as well.
+ *
+ * Results are cached by the hash of the code. A cached result
+ * is used as long as none of its files changed on disk, and
+ * files are only read again when they did.
+ *
+ * A preprocessor is not thread-safe; use one per thread.
+ */
+class ShaderPreprocessor{
+public:
+    struct Tweak{
+        enum Type{ Float, Int };
+
+        QString name;
+        Type type;
+        double value;
+    };
+
+    struct Result{
+        QString source;
+        // Index is the source string number, 0 is the main code
+        QStringList files;
+        // Source string and line of each line of source
+        QVector<QPair<int, int>> lines;
+        // Uniforms lifted from #pragma tweak regions
+        QVector<Tweak> tweaks;
+        QString error;
+        SourceLocation errorLocation;
+
+        bool ok() const noexcept;
+        SourceLocation locate(int sourceString, int line) const noexcept;
+        SourceLocation locateLine(int line) const noexcept;
+    };
+
+    static const QString builtinIncludePath;
+
+    ShaderPreprocessor();
+    void setSearchPaths(const QStringList &paths) noexcept;
+    QStringList searchPaths() const noexcept;
+    Result process(const QString &source, const QString &directory = QString(),
+                   const QString &tweakPrefix = "_tweak") noexcept;
+    quint64 reads() const noexcept;
+
+private:
+    struct File{
+        QDateTime modified;
+        qint64 size;
+        QString content;
+    };
+    struct Entry{
+        Result result;
+        QList<QPair<QString, File>> stamps;
+    };
+
+    ShaderPreprocessor(const ShaderPreprocessor &);
+    ShaderPreprocessor& operator=(const ShaderPreprocessor& rhs);
+
+    bool expand(const QString &text, int index, const QString &directory, Result &result) noexcept;
+    void mapLines(Result &result) const noexcept;
+    void lift(Result &result, const QString &prefix) noexcept;
+    static bool literal(const QString &token, Tweak &tweak) noexcept;
+    QString resolve(const QString &name, bool quoted, const QString &directory) const noexcept;
+    const File *load(const QString &path) noexcept;
+    static bool unchanged(const QString &path, const File &stamp) noexcept;
+
+    QStringList paths;
+    QRegExp includeRegEx, versionRegEx, tweakRegEx;
+    mutable QRegExp lineRegEx;
+    QHash<QString, File> files;
+    QHash<QByteArray, Entry> cache;
+    quint64 readCount;
+};
+
+#endif // SHADERPREPROCESSOR_HPP
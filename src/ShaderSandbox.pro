@@ -40,13 +40,33 @@ HEADERS += Instances/IInstance.hpp \
     CodeEditor.hpp \
     CodeHighlighter.hpp \
     EditorWindow.hpp \
-    LiveThread.hpp \
     Renderer.hpp \
     SettingsBackend.hpp \
     SettingsTab.hpp \
     SettingsWindow.hpp \ 
     ObjectLoaderDialog.hpp \
-    Model3D.hpp
+    Model3D.hpp \
+    TextureCache.hpp \
+    TextureCodec.hpp \
+    VideoTexture.hpp \
+    UniformTable.hpp \
+    GlStateCache.hpp \
+    RenderThread.hpp \
+    AudioCapture.hpp \
+    AudioFile.hpp \
+    AudioAnalyzer.hpp \
+    FrameClock.hpp \
+    ShaderPreprocessor.hpp \
+    ShaderDiagnostics.hpp \
+    GlslLexer.hpp \
+    GlslParser.hpp \
+    GlslParserThread.hpp \
+    ShaderValidator.hpp \
+    ShaderValidatorThread.hpp \
+    FileWatcher.hpp \
+    ShaderFile.hpp \
+    ShaderFileThread.hpp \
+    SettingsStore.hpp
 
 SOURCES += Instances/WindowInstance.cpp \
     AudioInputProcessor.cpp \
@@ -61,7 +81,28 @@ SOURCES += Instances/WindowInstance.cpp \
     SettingsTab.cpp \
     SettingsWindow.cpp \
     ObjectLoaderDialog.cpp \
-    Model3D.cpp
+    Model3D.cpp \
+    TextureCache.cpp \
+    TextureCodec.cpp \
+    VideoTexture.cpp \
+    UniformTable.cpp \
+    GlStateCache.cpp \
+    RenderThread.cpp \
+    AudioCapture.cpp \
+    AudioFile.cpp \
+    AudioAnalyzer.cpp \
+    FrameClock.cpp \
+    ShaderPreprocessor.cpp \
+    ShaderDiagnostics.cpp \
+    GlslLexer.cpp \
+    GlslParser.cpp \
+    GlslParserThread.cpp \
+    ShaderValidator.cpp \
+    ShaderValidatorThread.cpp \
+    FileWatcher.cpp \
+    ShaderFile.cpp \
+    ShaderFileThread.cpp \
+    SettingsStore.cpp
 
 
 valgrind-check.depends = check
@@ -0,0 +1,178 @@
+#include "ShaderValidator.hpp"
+
+#include <QCryptographicHash>
+
+/**
+ * @brief ShaderValidator::Result::ok
+ * @return True if neither stage has an error
+ */
+bool ShaderValidator::Result::ok() const noexcept{
+    return !ShaderDiagnostics::hasErrors(vertex) && !ShaderDiagnostics::hasErrors(fragment);
+}
+
+/**
+ * @brief ShaderValidator::ShaderValidator
+ */
+ShaderValidator::ShaderValidator()
+{ }
+
+/**
+ * @brief ShaderValidator::setSearchPaths
+ * @param paths Directories to look up includes in, in order
+ */
+void ShaderValidator::setSearchPaths(const QStringList &paths) noexcept{
+    preprocessor.setSearchPaths(paths);
+}
+
+/**
+ * @brief ShaderValidator::validate
+ * @param vertexSource Code of the vertex shader
+ * @param fragmentSource Code of the fragment shader
+ * @param directory Directory quoted includes are relative to
+ * @return The diagnostics of both stages
+ *
+ * The interface is only matched if both stages are free of
+ * errors, as their declarations may be incomplete otherwise.
+ */
+ShaderValidator::Result ShaderValidator::validate(const QString &vertexSource, const QString &fragmentSource,
+                                                  const QString &directory) noexcept{
+    Result result;
+    ShaderPreprocessor::Result vertexExpansion, fragmentExpansion;
+    GlslParseResult vertexParsed, fragmentParsed;
+    bool vertexOk = check(vertexSource, directory, vertexParser, vertexExpansion, vertexParsed, result.vertex);
+    bool fragmentOk = check(fragmentSource, directory, fragmentParser, fragmentExpansion, fragmentParsed, result.fragment);
+    if(vertexOk && fragmentOk)
+        matchInterface(vertexParsed, fragmentParsed, fragmentExpansion, result.fragment);
+
+    if(vertexExpansion.ok() && fragmentExpansion.ok()){
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        hash.addData(normalize(vertexExpansion.source).toUtf8());
+        hash.addData("\0", 1);
+        hash.addData(normalize(fragmentExpansion.source).toUtf8());
+        // Lifted literals are not part of the code
+        for(auto expansion : {&vertexExpansion, &fragmentExpansion})
+            for(auto &tweak : expansion->tweaks)
+                hash.addData(QByteArray::number(tweak.value, 'g', 17));
+        result.hash = hash.result();
+    }
+    return result;
+}
+
+/**
+ * @brief ShaderValidator::normalize
+ * @param source Shader code
+ * @return The code without comments and redundant whitespace
+ *
+ * Comments become a space, as in the preprocessor of the
+ * driver, even if they span lines. Runs of whitespace become
+ * one space, or one line break if they span lines, as
+ * directives end with theirs.
+ */
+QString ShaderValidator::normalize(const QString &source) noexcept{
+    QString result;
+    result.reserve(source.length());
+    const QChar *data = source.constData();
+    const int length = source.length();
+    // Whitespace seen since the last character kept
+    bool space = false, lineBreak = true;
+
+    for(int i = 0; i < length; ++i){
+        QChar c = data[i];
+        QChar next = i + 1 < length ? data[i + 1] : QChar();
+        if(c == '/' && next == '/'){
+            while(i + 1 < length && data[i + 1] != '\n')
+                ++i;
+            space = true;
+        } else if(c == '/' && next == '*'){
+            int end = source.indexOf(QLatin1String("*/"), i + 2);
+            i = (end < 0 ? length : end + 2) - 1;
+            space = true;
+        } else if(c == '\n')
+            lineBreak = true;
+        else if(c.isSpace())
+            space = true;
+        else {
+            if(lineBreak && !result.isEmpty())
+                result += '\n';
+            else if(space && !lineBreak)
+                result += ' ';
+            result += c;
+            space = lineBreak = false;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief ShaderValidator::check
+ * @param source Code of one stage
+ * @param directory Directory quoted includes are relative to
+ * @param parser The parser of the stage
+ * @param expansion Receives the expanded code
+ * @param parsed Receives its symbols
+ * @param diagnostics Receives its errors and warnings
+ * @return False on an error
+ */
+bool ShaderValidator::check(const QString &source, const QString &directory, GlslParser &parser,
+                            ShaderPreprocessor::Result &expansion, GlslParseResult &parsed,
+                            QList<ShaderDiagnostic> &diagnostics) noexcept{
+    expansion = preprocessor.process(source, directory);
+    if(!expansion.ok()){
+        auto &location = expansion.errorLocation;
+        diagnostics.append(ShaderDiagnostic{ShaderDiagnostic::Error, location.file, location.line, -1, expansion.error});
+        return false;
+    }
+
+    parsed = parser.parse(expansion.source);
+    for(auto &error : parsed.errors)
+        diagnostics.append(locate(error, expansion));
+    return !ShaderDiagnostics::hasErrors(parsed.errors);
+}
+
+/**
+ * @brief ShaderValidator::matchInterface
+ * @param vertex Symbols of the vertex shader
+ * @param fragment Symbols of the fragment shader
+ * @param fragmentExpansion Expanded code of the fragment shader
+ * @param diagnostics Receives the inputs that do not match
+ *
+ * Inputs are reported where the fragment shader declares them.
+ */
+void ShaderValidator::matchInterface(const GlslParseResult &vertex, const GlslParseResult &fragment,
+                                     const ShaderPreprocessor::Result &fragmentExpansion,
+                                     QList<ShaderDiagnostic> &diagnostics) noexcept{
+    QHash<QString, const GlslSymbol *> outputs;
+    for(auto &symbol : vertex.symbols)
+        if(symbol.kind == GlslSymbol::Output)
+            outputs.insert(symbol.name, &symbol);
+
+    for(auto &input : fragment.symbols){
+        if(input.kind != GlslSymbol::Input)
+            continue;
+        ShaderDiagnostic diagnostic{ShaderDiagnostic::Error, QString(), input.line, input.column, QString()};
+        auto output = outputs.value(input.name);
+        if(!output){
+            diagnostic.severity = ShaderDiagnostic::Warning;
+            diagnostic.message = QString("input '%1' is not an output of the vertex shader").arg(input.name);
+        } else if(output->detail != input.detail)
+            diagnostic.message = QString("input '%1' is %2, but the vertex shader outputs %3")
+                    .arg(input.name).arg(input.detail).arg(output->detail);
+        else
+            continue;
+        diagnostics.append(locate(diagnostic, fragmentExpansion));
+    }
+}
+
+/**
+ * @brief ShaderValidator::locate
+ * @param diagnostic A diagnostic at a line of expanded code
+ * @param expansion The expanded code
+ * @return The diagnostic at the file and line it came from
+ */
+ShaderDiagnostic ShaderValidator::locate(ShaderDiagnostic diagnostic,
+                                         const ShaderPreprocessor::Result &expansion) noexcept{
+    auto location = expansion.locateLine(diagnostic.line);
+    diagnostic.file = location.file;
+    diagnostic.line = location.line;
+    return diagnostic;
+}
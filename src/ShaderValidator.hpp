@@ -0,0 +1,67 @@
+#ifndef SHADERVALIDATOR_HPP
+#define SHADERVALIDATOR_HPP
+
+#include "ShaderPreprocessor.hpp"
+#include "ShaderDiagnostics.hpp"
+#include "GlslParser.hpp"
+
+/**
+ * @brief The ShaderValidator class
+ *
+ * Checks the code of both stages without a GL context before
+ * it is handed to a renderer. The includes are expanded like
+ * the renderer does, both stages are parsed for syntax errors
+ * and the inputs of the fragment shader are matched against
+ * the outputs of the vertex shader by name and type.
+ *
+ * Only errors fail a validation: includes that are not found,
+ * brackets that do not match, unterminated comments and
+ * declarations, and inputs whose type differs from the output.
+ * A missing semicolon is guessed from the layout of the lines,
+ * so it is a warning and the driver has the last word; an input
+ * without an output is a warning too, as drivers accept it as
+ * long as it is not read.
+ * Diagnostics point into the file they came from, like the
+ * ones of the driver. The hash of a result identifies the
+ * expanded code without comments and redundant whitespace,
+ * so edits that do not change the shader can be skipped.
+ *
+ * A validator is not thread-safe; use one per thread.
+ */
+class ShaderValidator{
+public:
+    struct Result{
+        QList<ShaderDiagnostic> vertex;
+        QList<ShaderDiagnostic> fragment;
+        // Empty if an include was not found
+        QByteArray hash;
+
+        bool ok() const noexcept;
+    };
+
+    ShaderValidator();
+    void setSearchPaths(const QStringList &paths) noexcept;
+    Result validate(const QString &vertexSource, const QString &fragmentSource,
+                    const QString &directory = QString()) noexcept;
+    static QString normalize(const QString &source) noexcept;
+
+private:
+    ShaderValidator(const ShaderValidator &);
+    ShaderValidator& operator=(const ShaderValidator& rhs);
+
+    bool check(const QString &source, const QString &directory, GlslParser &parser,
+               ShaderPreprocessor::Result &expansion, GlslParseResult &parsed,
+               QList<ShaderDiagnostic> &diagnostics) noexcept;
+    static void matchInterface(const GlslParseResult &vertex, const GlslParseResult &fragment,
+                               const ShaderPreprocessor::Result &fragmentExpansion,
+                               QList<ShaderDiagnostic> &diagnostics) noexcept;
+    static ShaderDiagnostic locate(ShaderDiagnostic diagnostic,
+                                   const ShaderPreprocessor::Result &expansion) noexcept;
+
+    ShaderPreprocessor preprocessor;
+    GlslParser vertexParser, fragmentParser;
+};
+
+Q_DECLARE_METATYPE(ShaderValidator::Result)
+
+#endif // SHADERVALIDATOR_HPP
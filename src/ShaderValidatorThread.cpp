@@ -0,0 +1,102 @@
+#include "ShaderValidatorThread.hpp"
+
+/**
+ * @brief ShaderValidatorThread::ShaderValidatorThread
+ * @param parent Parent object
+ */
+ShaderValidatorThread::ShaderValidatorThread(QObject *parent) :
+    QThread(parent), stopping(false)
+{
+    // Results are delivered to the GUI thread
+    qRegisterMetaType<ShaderValidator::Result>("ShaderValidator::Result");
+}
+
+/**
+ * @brief ShaderValidatorThread::~ShaderValidatorThread
+ *
+ * Waits for a validation that is running.
+ */
+ShaderValidatorThread::~ShaderValidatorThread(){
+    stop();
+}
+
+/**
+ * @brief ShaderValidatorThread::request
+ * @param id The instance the code belongs to
+ * @param request Code to validate and where to find its includes
+ *
+ * Starts the thread if needed and returns immediately.
+ */
+void ShaderValidatorThread::request(long id, const Request &request) noexcept{
+    QMutexLocker lock(&mutex);
+    if(stopping)
+        return;
+    if(!pending.contains(id))
+        order.append(id);
+    pending.insert(id, request);
+    forgotten.removeAll(id);
+    changed.wakeAll();
+    lock.unlock();
+    if(!isRunning())
+        start(QThread::LowPriority);
+}
+
+/**
+ * @brief ShaderValidatorThread::forget
+ * @param id An instance that is gone
+ *
+ * Drops its waiting request and its validator.
+ */
+void ShaderValidatorThread::forget(long id) noexcept{
+    QMutexLocker lock(&mutex);
+    order.removeAll(id);
+    pending.remove(id);
+    forgotten.append(id);
+    changed.wakeAll();
+}
+
+/**
+ * @brief ShaderValidatorThread::stop
+ *
+ * Drops what is waiting and waits until the thread quit.
+ */
+void ShaderValidatorThread::stop() noexcept{
+    mutex.lock();
+    stopping = true;
+    order.clear();
+    pending.clear();
+    changed.wakeAll();
+    mutex.unlock();
+    wait();
+}
+
+/**
+ * @brief ShaderValidatorThread::run
+ *
+ * Validates the waiting requests one after the other, then
+ * sleeps until the next.
+ */
+void ShaderValidatorThread::run() noexcept{
+    QHash<long, std::shared_ptr<ShaderValidator>> validators;
+    QMutexLocker lock(&mutex);
+    while(!stopping){
+        for(auto id : forgotten)
+            validators.remove(id);
+        forgotten.clear();
+        if(order.isEmpty()){
+            changed.wait(&mutex);
+            continue;
+        }
+        long id = order.takeFirst();
+        Request request = pending.take(id);
+
+        lock.unlock();
+        auto &validator = validators[id];
+        if(!validator)
+            validator.reset(new ShaderValidator());
+        validator->setSearchPaths(request.includePaths);
+        auto result = validator->validate(request.vertexSource, request.fragmentSource, request.directory);
+        Q_EMIT validated(id, request.revision, request.vertexSource, request.fragmentSource, result);
+        lock.relock();
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef SHADERVALIDATORTHREAD_HPP
+#define SHADERVALIDATORTHREAD_HPP
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <memory>
+
+#include "ShaderValidator.hpp"
+
+/**
+ * @brief The ShaderValidatorThread class
+ *
+ * Validates the code of the instances off the GUI thread, so
+ * that only code without errors reaches the render thread.
+ * Each instance has its own validator and only its latest
+ * request counts: code that arrives while older code of the
+ * same instance still waits replaces it. Results carry the
+ * revision they were requested with, so the receiver can drop
+ * stale ones.
+ */
+class ShaderValidatorThread : public QThread{
+    Q_OBJECT
+public:
+    struct Request{
+        QString vertexSource;
+        QString fragmentSource;
+        QString directory;
+        QStringList includePaths;
+        int revision;
+    };
+
+    explicit ShaderValidatorThread(QObject *parent = 0);
+    ~ShaderValidatorThread();
+    void request(long id, const Request &request) noexcept;
+    void forget(long id) noexcept;
+    void stop() noexcept;
+
+Q_SIGNALS:
+    void validated(long id, int revision, QString vertexSource, QString fragmentSource,
+                   ShaderValidator::Result result);
+
+protected:
+    void run() noexcept Q_DECL_OVERRIDE;
+
+private:
+    ShaderValidatorThread(const ShaderValidatorThread &);
+    ShaderValidatorThread& operator=(const ShaderValidatorThread& rhs);
+
+    QMutex mutex;
+    QWaitCondition changed;
+    // Waiting requests in the order of their instances' first
+    QList<long> order;
+    QHash<long, Request> pending;
+    QList<long> forgotten;
+    bool stopping;
+};
+
+#endif // SHADERVALIDATORTHREAD_HPP
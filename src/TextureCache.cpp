@@ -0,0 +1,497 @@
+#include "TextureCache.hpp"
+
+#include <QDebug>
+#include <QDir>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+
+/**
+ * @brief TextureImage::TextureImage
+ * @param path Absolute path of the image file
+ * @param modified Modification time of the file when it was requested
+ *
+ * Creates an empty image that is still pending decoding.
+ */
+TextureImage::TextureImage(const QString &path, const QDateTime &modified) :
+    path(path), modified(modified), pixelFormat(TextureCodec::rgba8), size(0), state(Pending)
+{ }
+
+/**
+ * @brief TextureImage::isReady
+ * @return True if decoding has finished, successfully or not
+ */
+bool TextureImage::isReady() const noexcept{
+    return state.load() != Pending;
+}
+
+/**
+ * @brief TextureImage::isValid
+ * @return True if the image was decoded successfully
+ */
+bool TextureImage::isValid() const noexcept{
+    return state.load() == Ready;
+}
+
+/**
+ * @brief TextureImage::levelCount
+ * @return The number of mip levels, 0 while pending
+ */
+int TextureImage::levelCount() const noexcept{
+    QMutexLocker lock(&mutex);
+    return levels.size();
+}
+
+/**
+ * @brief TextureImage::level
+ * @param index Mip level, 0 being the full resolution
+ * @return The pixel data of the level, see format()
+ */
+TextureImage::Level TextureImage::level(int index) const noexcept{
+    QMutexLocker lock(&mutex);
+    return levels.value(index);
+}
+
+/**
+ * @brief TextureImage::format
+ * @return The GL format the levels are stored in
+ */
+TextureCodec::Format TextureImage::format() const noexcept{
+    QMutexLocker lock(&mutex);
+    return pixelFormat;
+}
+
+/**
+ * @brief TextureImage::byteSize
+ * @return The memory used by all levels together
+ */
+qint64 TextureImage::byteSize() const noexcept{
+    QMutexLocker lock(&mutex);
+    return size;
+}
+
+/**
+ * @brief TextureImage::publish
+ * @param decoded The finished mip chain
+ * @param format The GL format of the levels
+ *
+ * Hands the decoded levels over to the readers.
+ */
+void TextureImage::publish(const QVector<Level> &decoded, const TextureCodec::Format &format) noexcept{
+    QMutexLocker lock(&mutex);
+    levels = decoded;
+    pixelFormat = format;
+    size = 0;
+    for(auto &level : levels)
+        size += level.data.size();
+    state.store(Ready);
+}
+
+/**
+ * @brief TextureImage::fail
+ *
+ * Marks the image as undecodable.
+ */
+void TextureImage::fail() noexcept{
+    state.store(Failed);
+}
+
+
+/**
+ * @brief TextureDecoder::TextureDecoder
+ * @param image The image to fill in
+ * @param cacheFile Where to keep the compressed image, empty for no compression
+ * @param extensions Extensions of the renderers' contexts, empty if unknown
+ */
+TextureDecoder::TextureDecoder(std::shared_ptr<TextureImage> image, const QString &cacheFile,
+                               const QSet<QByteArray> &extensions) :
+    image(image), cacheFile(cacheFile), extensions(extensions)
+{ }
+
+/**
+ * @brief TextureDecoder::run
+ *
+ * Reads containers and already compressed images directly.
+ * Everything else is decoded to RGBA8 and halved down to 1x1
+ * to build the mip chain, then compressed if requested and
+ * the context can sample BC1/BC3. Containers in a format the
+ * context lacks the extension for are expanded to RGBA8.
+ */
+void TextureDecoder::run() noexcept{
+    TextureCodec::Format format;
+    QVector<TextureImage::Level> levels;
+
+    if(TextureCodec::isContainer(image->path)){
+        if(!readFile(image->path, format, levels)){
+            qWarning() << "Failed to read texture container:" << image->path;
+            image->fail();
+        } else if(!TextureCodec::isSupported(format, extensions)
+                  && !TextureCodec::decompress(format, levels)){
+            qWarning() << "Texture container needs" << TextureCodec::extension(format.internalFormat)
+                       << ":" << image->path;
+            image->fail();
+        } else
+            image->publish(levels, format);
+        return;
+    }
+
+    if(!TextureCodec::canCompress(extensions))
+        cacheFile.clear();
+    if(!cacheFile.isEmpty() && readFile(cacheFile, format, levels)){
+        image->publish(levels, format);
+        return;
+    }
+
+    QImage decoded(image->path);
+    if(decoded.isNull()){
+        qWarning() << "Failed to decode texture image:" << image->path;
+        image->fail();
+        return;
+    }
+
+    QVector<QImage> chain;
+    decoded = decoded.convertToFormat(QImage::Format_RGBA8888);
+    Q_FOREVER{
+        chain.append(decoded);
+        if(decoded.width() == 1 && decoded.height() == 1)
+            break;
+        decoded = decoded.scaled(qMax(1, decoded.width() / 2), qMax(1, decoded.height() / 2),
+                                 Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+
+    if(cacheFile.isEmpty()){
+        format = TextureCodec::rgba8;
+        for(auto &scaled : chain){
+            TextureImage::Level level;
+            level.width = scaled.width();
+            level.height = scaled.height();
+            level.data = QByteArray(reinterpret_cast<const char*>(scaled.constBits()), scaled.byteCount());
+            levels.append(level);
+        }
+    } else {
+        levels = TextureCodec::compress(chain, format);
+        QDir().mkpath(QFileInfo(cacheFile).path());
+        QSaveFile file(cacheFile);
+        if(!file.open(QIODevice::WriteOnly) ||
+           file.write(TextureCodec::writeKtx(format, levels)) < 0 || !file.commit())
+            qWarning() << "Failed to write texture cache:" << cacheFile;
+    }
+
+    image->publish(levels, format);
+}
+
+/**
+ * @brief TextureDecoder::readFile
+ * @param path A KTX or DDS file
+ * @param format Receives the GL format
+ * @param levels Receives the mip levels
+ * @return True on success, otherwise false
+ */
+bool TextureDecoder::readFile(const QString &path, TextureCodec::Format &format,
+                              QVector<TextureImage::Level> &levels) noexcept{
+    QFile file(path);
+    if(!file.open(QIODevice::ReadOnly))
+        return false;
+    return TextureCodec::read(file.readAll(), format, levels) && !levels.isEmpty();
+}
+
+
+/**
+ * @brief TextureCache::TextureCache
+ *
+ * Creates the cache with a worker pool that leaves
+ * one core to the GUI and render threads.
+ */
+TextureCache::TextureCache() : limit(512 * 1024 * 1024), compress(false){
+    pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+/**
+ * @brief TextureCache::instance
+ * @return The process-wide cache
+ */
+TextureCache *TextureCache::instance() noexcept{
+    static TextureCache cache;
+    return &cache;
+}
+
+/**
+ * @brief TextureCache::keyFor
+ * @param file The image file
+ * @return A key that changes whenever the file is modified
+ */
+QString TextureCache::keyFor(const QFileInfo &file) noexcept{
+    return file.absoluteFilePath() + "@" + QString::number(file.lastModified().toMSecsSinceEpoch());
+}
+
+/**
+ * @brief TextureCache::request
+ * @param path Path to the image file
+ * @return The cached image; it may still be pending decoding
+ *
+ * Looks the image up by path and modification time and
+ * starts decoding it in the background if it is unknown.
+ */
+std::shared_ptr<TextureImage> TextureCache::request(const QString &path) noexcept{
+    QFileInfo file(path);
+    auto key = keyFor(file);
+
+    QMutexLocker lock(&mutex);
+    recentlyUsed.removeOne(key);
+    recentlyUsed.append(key);
+    if(images.contains(key))
+        return images[key];
+
+    QString cacheFile;
+    if(compress){
+        auto hash = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex();
+        cacheFile = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/textures/" + hash + ".ktx";
+    }
+
+    std::shared_ptr<TextureImage> image(new TextureImage(file.absoluteFilePath(), file.lastModified()));
+    images.insert(key, image);
+    pool.start(new TextureDecoder(image, cacheFile, extensions));
+    evict();
+    return image;
+}
+
+/**
+ * @brief TextureCache::setLimit
+ * @param bytes Maximum memory of images that are not in use
+ */
+void TextureCache::setLimit(qint64 bytes) noexcept{
+    QMutexLocker lock(&mutex);
+    limit = bytes;
+    evict();
+}
+
+/**
+ * @brief TextureCache::setCompression
+ * @param enabled Whether to compress plain images to BC1/BC3
+ *
+ * Compressed images are written to the cache directory once
+ * and read from there on subsequent runs. Only affects images
+ * that are not decoded yet.
+ */
+void TextureCache::setCompression(bool enabled) noexcept{
+    QMutexLocker lock(&mutex);
+    if(compress == enabled)
+        return;
+    compress = enabled;
+    for(auto key : images.keys()){
+        if(images[key].use_count() == 1){
+            images.remove(key);
+            recentlyUsed.removeOne(key);
+        }
+    }
+}
+
+/**
+ * @brief TextureCache::compression
+ * @return True if plain images are compressed on load
+ */
+bool TextureCache::compression() const noexcept{
+    return compress;
+}
+
+/**
+ * @brief TextureCache::setExtensions
+ * @param extensions Extensions of a renderer's context
+ *
+ * Decides which compressed formats images are decoded to. Set
+ * once a context exists, before the first image is requested.
+ */
+void TextureCache::setExtensions(const QSet<QByteArray> &extensions) noexcept{
+    QMutexLocker lock(&mutex);
+    this->extensions = extensions;
+}
+
+/**
+ * @brief TextureCache::evict
+ *
+ * Drops the least recently used images until the cache
+ * fits into its limit. Images still referenced by a renderer
+ * are never dropped. Expects the mutex to be held.
+ */
+void TextureCache::evict() noexcept{
+    qint64 total = 0;
+    for(auto &image : images)
+        total += image->byteSize();
+
+    for(int i = 0; total > limit && i < recentlyUsed.size();){
+        auto key = recentlyUsed[i];
+        auto &image = images[key];
+        if(image.use_count() > 1 || !image->isReady()){
+            ++i;
+            continue;
+        }
+        total -= image->byteSize();
+        images.remove(key);
+        recentlyUsed.removeAt(i);
+    }
+}
+
+
+/**
+ * @brief StreamingTexture::StreamingTexture
+ * @param image The decoded image to upload
+ *
+ * Creates the GPU side of an image. The GL texture object is
+ * created lazily by the first upload() after decoding finished.
+ */
+StreamingTexture::StreamingTexture(std::shared_ptr<TextureImage> image) :
+    image(image), id(0), level(0), row(0), complete(false), allocated(false), refill(false)
+{
+    initializeOpenGLFunctions();
+}
+
+/**
+ * @brief StreamingTexture::~StreamingTexture
+ *
+ * Frees the GL texture object.
+ */
+StreamingTexture::~StreamingTexture(){
+    if(id)
+        glDeleteTextures(1, &id);
+}
+
+/**
+ * @brief StreamingTexture::upload
+ * @param budget Number of bytes that may be uploaded
+ * @return Number of bytes actually uploaded
+ *
+ * Continues uploading the mip chain, coarsest level first,
+ * in row strips or whole levels for compressed formats. At least one strip is uploaded whenever the
+ * budget is positive, so the texture always makes progress.
+ * The base level is lowered each time a finer level is complete.
+ * A reloaded image of the same shape is written into the storage
+ * in place, if an earlier upload specified all of its levels.
+ */
+qint64 StreamingTexture::upload(qint64 budget) noexcept{
+    if(complete || !image->isReady())
+        return 0;
+    if(previous){
+        // Storage of another shape, or storage whose finer levels
+        // were never specified, is allocated anew
+        refill = id && allocated && image->isValid() && fits(*previous);
+        if(!refill && id){
+            glDeleteTextures(1, &id);
+            id = 0;
+        }
+        previous.reset();
+        level = image->levelCount() - 1;
+        row = 0;
+    }
+    if(!image->isValid()){
+        complete = true;
+        return 0;
+    }
+
+    if(!id){
+        level = image->levelCount() - 1;
+        row = 0;
+        allocated = false;
+        glGenTextures(1, &id);
+        glBindTexture(GL_TEXTURE_2D, id);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, level ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level);
+    } else
+        glBindTexture(GL_TEXTURE_2D, id);
+
+    auto format = image->format();
+    qint64 used = 0;
+    while(!complete && used < budget){
+        auto current = image->level(level);
+
+        if(format.compressed){
+            if(refill)
+                glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, current.width, current.height,
+                                          format.internalFormat, current.data.size(), current.data.constData());
+            else
+                glCompressedTexImage2D(GL_TEXTURE_2D, level, format.internalFormat, current.width, current.height, 0,
+                                       current.data.size(), current.data.constData());
+            used += current.data.size();
+            row = current.height;
+        } else {
+            qint64 rowSize = current.data.size() / current.height;
+            if(row == 0 && !refill)
+                glTexImage2D(GL_TEXTURE_2D, level, format.internalFormat, current.width, current.height, 0,
+                             format.format, format.type, 0);
+
+            int rows = qBound(qint64(1), (budget - used) / rowSize, qint64(current.height - row));
+            glTexSubImage2D(GL_TEXTURE_2D, level, 0, row, current.width, rows,
+                            format.format, format.type, current.data.constData() + row * rowSize);
+            used += rows * rowSize;
+            row += rows;
+        }
+
+        if(row == current.height){
+            if(!refill)
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+            row = 0;
+            if(level == 0)
+                complete = allocated = true;
+            else
+                --level;
+        }
+    }
+    return used;
+}
+
+/**
+ * @brief StreamingTexture::reload
+ * @param image The image the file decodes to now
+ *
+ * The texture keeps showing the old image until the new one is
+ * decoded; uploading continues with the next upload().
+ */
+void StreamingTexture::reload(std::shared_ptr<TextureImage> image) noexcept{
+    if(image == this->image)
+        return;
+    if(!previous)
+        previous = this->image;
+    this->image = image;
+    complete = false;
+}
+
+/**
+ * @brief StreamingTexture::fits
+ * @param other The image the storage was allocated for
+ * @return True if the image has the same size, format and levels
+ */
+bool StreamingTexture::fits(const TextureImage &other) const noexcept{
+    if(!other.isValid() || other.levelCount() != image->levelCount()
+            || other.format().internalFormat != image->format().internalFormat
+            || other.format().compressed != image->format().compressed)
+        return false;
+    for(int i = 0; i < image->levelCount(); ++i)
+        if(other.level(i).width != image->level(i).width || other.level(i).height != image->level(i).height)
+            return false;
+    return true;
+}
+
+/**
+ * @brief StreamingTexture::source
+ * @return The image shown, or the one decoded to replace it
+ */
+std::shared_ptr<TextureImage> StreamingTexture::source() const noexcept{
+    return image;
+}
+
+/**
+ * @brief StreamingTexture::isComplete
+ * @return True if every level is on the GPU or the image failed to decode
+ */
+bool StreamingTexture::isComplete() const noexcept{
+    return complete;
+}
+
+/**
+ * @brief StreamingTexture::textureId
+ * @return The GL texture name, 0 before the first upload
+ */
+GLuint StreamingTexture::textureId() const noexcept{
+    return id;
+}
@@ -0,0 +1,154 @@
+#ifndef TEXTURECACHE_HPP
+#define TEXTURECACHE_HPP
+
+#include <memory>
+
+#include <QHash>
+#include <QMutex>
+#include <QImage>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QOpenGLFunctions>
+
+#include "TextureCodec.hpp"
+
+/**
+ * @brief The TextureImage class
+ *
+ * The decoded pixel data of one image file, including its
+ * complete mip chain. It is filled in by a worker thread of
+ * the TextureCache and read by the renderers once it is ready.
+ */
+class TextureImage{
+public:
+    typedef TextureCodec::Level Level;
+
+    TextureImage(const QString &path, const QDateTime &modified);
+    bool isReady() const noexcept;
+    bool isValid() const noexcept;
+    int levelCount() const noexcept;
+    Level level(int) const noexcept;
+    TextureCodec::Format format() const noexcept;
+    qint64 byteSize() const noexcept;
+
+    const QString path;
+    const QDateTime modified;
+
+private:
+    friend class TextureDecoder;
+    enum State{ Pending, Ready, Failed };
+
+    void publish(const QVector<Level> &, const TextureCodec::Format &) noexcept;
+    void fail() noexcept;
+
+    mutable QMutex mutex;
+    QVector<Level> levels;
+    TextureCodec::Format pixelFormat;
+    qint64 size;
+    QAtomicInt state;
+};
+
+/**
+ * @brief The TextureDecoder class
+ *
+ * A runnable that decodes an image file and generates
+ * its mip chain off the render thread. KTX and DDS files
+ * are read as they are; other images are optionally
+ * compressed once and kept in the on-disk cache. Formats the
+ * context cannot sample are expanded or not produced at all.
+ */
+class TextureDecoder : public QRunnable{
+public:
+    TextureDecoder(std::shared_ptr<TextureImage> image, const QString &cacheFile,
+                   const QSet<QByteArray> &extensions);
+    void run() noexcept Q_DECL_OVERRIDE;
+
+private:
+    bool readFile(const QString &path, TextureCodec::Format &format, QVector<TextureImage::Level> &levels) noexcept;
+
+    std::shared_ptr<TextureImage> image;
+    QString cacheFile;
+    QSet<QByteArray> extensions;
+};
+
+/**
+ * @brief The TextureCache class
+ *
+ * A process-wide cache of decoded images, keyed by
+ * path and modification time. Images that are requested
+ * for the first time are decoded on a pool of worker
+ * threads; recompiling a shader that references the same
+ * files does not touch the disk again.
+ */
+class TextureCache{
+public:
+    static TextureCache *instance() noexcept;
+    static QString keyFor(const QFileInfo &) noexcept;
+    std::shared_ptr<TextureImage> request(const QString &path) noexcept;
+    void setLimit(qint64 bytes) noexcept;
+    void setCompression(bool) noexcept;
+    bool compression() const noexcept;
+    void setExtensions(const QSet<QByteArray> &extensions) noexcept;
+
+private:
+    TextureCache();
+    TextureCache(const TextureCache &);
+    TextureCache& operator=(const TextureCache& rhs);
+    void evict() noexcept;
+
+    QMutex mutex;
+    QThreadPool pool;
+    QHash<QString, std::shared_ptr<TextureImage>> images;
+    QList<QString> recentlyUsed;
+    qint64 limit;
+    bool compress;
+    // Of the renderers' contexts, empty until one is created
+    QSet<QByteArray> extensions;
+};
+
+/**
+ * @brief The StreamingTexture class
+ *
+ * The GPU side of a TextureImage. Uploads the mip chain
+ * from the coarsest to the finest level within a per-frame
+ * byte budget, so that large images show up blurry at first
+ * and sharpen over the next frames instead of stalling the
+ * renderer. Block compressed images are uploaded a whole
+ * level at a time. Must only be used with the owning context
+ * current.
+ *
+ * An image that changed on disk is swapped in with reload().
+ * If it has the same size, format and mip chain, the storage of
+ * the texture is kept and refilled with sub image uploads, so
+ * the program that samples it is not touched at all.
+ */
+class StreamingTexture : protected QOpenGLFunctions{
+public:
+    explicit StreamingTexture(std::shared_ptr<TextureImage> image);
+    ~StreamingTexture();
+    qint64 upload(qint64 budget) noexcept;
+    void reload(std::shared_ptr<TextureImage> image) noexcept;
+    bool isComplete() const noexcept;
+    GLuint textureId() const noexcept;
+    std::shared_ptr<TextureImage> source() const noexcept;
+
+private:
+    StreamingTexture(const StreamingTexture &);
+    StreamingTexture& operator=(const StreamingTexture& rhs);
+
+    bool fits(const TextureImage &other) const noexcept;
+
+    std::shared_ptr<TextureImage> image;
+    // The image the storage was allocated for until a reload is decoded
+    std::shared_ptr<TextureImage> previous;
+    GLuint id;
+    int level, row;
+    // Whether every level of the storage was specified, and whether
+    // the current upload writes into that storage
+    bool complete, allocated, refill;
+};
+
+#endif // TEXTURECACHE_HPP
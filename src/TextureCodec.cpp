@@ -0,0 +1,590 @@
+#include "TextureCodec.hpp"
+
+#include <cstring>
+
+#include <QtEndian>
+#include <QFileInfo>
+#include <QDebug>
+
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT       0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT      0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT      0x83F2
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT      0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT       0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT 0x8C4D
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT 0x8C4E
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+#ifndef GL_COMPRESSED_RED_RGTC1
+#define GL_COMPRESSED_RED_RGTC1               0x8DBB
+#define GL_COMPRESSED_SIGNED_RED_RGTC1        0x8DBC
+#define GL_COMPRESSED_RG_RGTC2                0x8DBD
+#define GL_COMPRESSED_SIGNED_RG_RGTC2         0x8DBE
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM         0x8E8C
+#define GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM   0x8E8D
+#define GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT   0x8E8E
+#define GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT 0x8E8F
+#endif
+
+static const uchar ktxIdentifier[12] = {
+    0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+
+static inline quint32 fourCC(char a, char b, char c, char d){
+    return quint32(uchar(a)) | quint32(uchar(b)) << 8 | quint32(uchar(c)) << 16 | quint32(uchar(d)) << 24;
+}
+
+static inline quint32 read32(const QByteArray &data, qint64 offset){
+    return qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(data.constData()) + offset);
+}
+
+const TextureCodec::Format TextureCodec::rgba8 = {GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, false};
+
+/**
+ * @brief TextureCodec::isContainer
+ * @param path Path to an image file
+ * @return True if the file is a KTX or DDS container
+ */
+bool TextureCodec::isContainer(const QString &path) noexcept{
+    auto suffix = QFileInfo(path).suffix().toLower();
+    return suffix == "ktx" || suffix == "dds";
+}
+
+/**
+ * @brief TextureCodec::blockSize
+ * @param internalFormat A GL internal format
+ * @return Bytes per 4x4 block, or 0 if the format is no supported BCn format
+ */
+int TextureCodec::blockSize(GLenum internalFormat) noexcept{
+    switch(internalFormat){
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RED_RGTC1:
+    case GL_COMPRESSED_SIGNED_RED_RGTC1:
+        return 8;
+    case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+    case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+    case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+    case GL_COMPRESSED_RG_RGTC2:
+    case GL_COMPRESSED_SIGNED_RG_RGTC2:
+    case GL_COMPRESSED_RGBA_BPTC_UNORM:
+    case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+    case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+    case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief TextureCodec::read
+ * @param file Contents of a KTX or DDS file
+ * @param format Receives the GL format of the data
+ * @param levels Receives the mip levels
+ * @return True on success, otherwise false
+ *
+ * Reads a container, picking the parser by its magic number.
+ */
+bool TextureCodec::read(const QByteArray &file, Format &format, QVector<Level> &levels) noexcept{
+    if(file.startsWith("DDS "))
+        return readDds(file, format, levels);
+    return readKtx(file, format, levels);
+}
+
+/**
+ * @brief TextureCodec::readKtx
+ * @param file Contents of a KTX 1.1 file
+ * @param format Receives the GL format of the data
+ * @param levels Receives the mip levels
+ * @return True on success, otherwise false
+ *
+ * Reads a little endian 2D KTX file. Arrays, cube maps and
+ * 3D textures are rejected.
+ */
+bool TextureCodec::readKtx(const QByteArray &file, Format &format, QVector<Level> &levels) noexcept{
+    if(file.size() < 64 || std::memcmp(file.constData(), ktxIdentifier, sizeof(ktxIdentifier)) != 0)
+        return false;
+    if(read32(file, 12) != 0x04030201){
+        qWarning() << "Big endian KTX files are not supported.";
+        return false;
+    }
+
+    format.type = read32(file, 16);
+    format.format = read32(file, 24);
+    format.internalFormat = read32(file, 28);
+    format.compressed = format.type == 0;
+    int width = read32(file, 36), height = qMax(1u, read32(file, 40));
+    if(read32(file, 44) > 1 || read32(file, 48) > 0 || read32(file, 52) != 1){
+        qWarning() << "Only plain 2D KTX textures are supported.";
+        return false;
+    }
+    if(format.compressed && blockSize(format.internalFormat) == 0){
+        qWarning() << "Unsupported KTX format:" << QString::number(format.internalFormat, 16);
+        return false;
+    }
+
+    int count = qMax(1u, read32(file, 56));
+    qint64 offset = 64 + read32(file, 60);
+    levels.clear();
+    for(int i = 0; i < count; ++i){
+        if(offset + 4 > file.size())
+            return false;
+        qint64 size = read32(file, offset);
+        offset += 4;
+        if(offset + size > file.size())
+            return false;
+
+        Level level;
+        level.width = qMax(1, width >> i);
+        level.height = qMax(1, height >> i);
+        level.data = file.mid(offset, size);
+        levels.append(level);
+        offset += (size + 3) & ~3;
+    }
+    return true;
+}
+
+/**
+ * @brief TextureCodec::readDds
+ * @param file Contents of a DDS file
+ * @param format Receives the GL format of the data
+ * @param levels Receives the mip levels
+ * @return True on success, otherwise false
+ *
+ * Reads a 2D DDS file holding BC1 to BC7 data, either by
+ * its FourCC or by its DX10 extension header.
+ */
+bool TextureCodec::readDds(const QByteArray &file, Format &format, QVector<Level> &levels) noexcept{
+    if(file.size() < 128 || !file.startsWith("DDS "))
+        return false;
+
+    int height = read32(file, 12), width = read32(file, 16);
+    int count = (read32(file, 8) & 0x20000) ? qMax(1u, read32(file, 28)) : 1;
+    if(read32(file, 112) & (0x200 | 0x200000)){
+        qWarning() << "Only plain 2D DDS textures are supported.";
+        return false;
+    }
+    if(!(read32(file, 80) & 0x4)){
+        qWarning() << "Only block compressed DDS textures are supported.";
+        return false;
+    }
+
+    qint64 offset = 128;
+    format.format = format.type = 0;
+    format.compressed = true;
+    auto code = read32(file, 84);
+    if(code == fourCC('D', 'X', 'T', '1'))
+        format.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    else if(code == fourCC('D', 'X', 'T', '3'))
+        format.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+    else if(code == fourCC('D', 'X', 'T', '5'))
+        format.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    else if(code == fourCC('A', 'T', 'I', '1') || code == fourCC('B', 'C', '4', 'U'))
+        format.internalFormat = GL_COMPRESSED_RED_RGTC1;
+    else if(code == fourCC('B', 'C', '4', 'S'))
+        format.internalFormat = GL_COMPRESSED_SIGNED_RED_RGTC1;
+    else if(code == fourCC('A', 'T', 'I', '2') || code == fourCC('B', 'C', '5', 'U'))
+        format.internalFormat = GL_COMPRESSED_RG_RGTC2;
+    else if(code == fourCC('B', 'C', '5', 'S'))
+        format.internalFormat = GL_COMPRESSED_SIGNED_RG_RGTC2;
+    else if(code == fourCC('D', 'X', '1', '0') && file.size() >= 148){
+        offset = 148;
+        switch(read32(file, 128)){
+        case 71: format.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT; break;
+        case 72: format.internalFormat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT; break;
+        case 74: format.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT; break;
+        case 75: format.internalFormat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT; break;
+        case 77: format.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; break;
+        case 78: format.internalFormat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT; break;
+        case 80: format.internalFormat = GL_COMPRESSED_RED_RGTC1; break;
+        case 81: format.internalFormat = GL_COMPRESSED_SIGNED_RED_RGTC1; break;
+        case 83: format.internalFormat = GL_COMPRESSED_RG_RGTC2; break;
+        case 84: format.internalFormat = GL_COMPRESSED_SIGNED_RG_RGTC2; break;
+        case 95: format.internalFormat = GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT; break;
+        case 96: format.internalFormat = GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT; break;
+        case 98: format.internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM; break;
+        case 99: format.internalFormat = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM; break;
+        default:
+            qWarning() << "Unsupported DXGI format in DDS file:" << read32(file, 128);
+            return false;
+        }
+    } else {
+        qWarning() << "Unsupported DDS FourCC:" << QByteArray(file.constData() + 84, 4);
+        return false;
+    }
+
+    auto block = blockSize(format.internalFormat);
+    levels.clear();
+    for(int i = 0; i < count; ++i){
+        Level level;
+        level.width = qMax(1, width >> i);
+        level.height = qMax(1, height >> i);
+        qint64 size = qint64((level.width + 3) / 4) * ((level.height + 3) / 4) * block;
+        if(offset + size > file.size())
+            return false;
+        level.data = file.mid(offset, size);
+        levels.append(level);
+        offset += size;
+    }
+    return true;
+}
+
+/**
+ * @brief TextureCodec::extension
+ * @param internalFormat A GL internal format
+ * @return The extension a GL 3.3 context needs to sample it,
+ * empty if it is core
+ */
+QByteArray TextureCodec::extension(GLenum internalFormat) noexcept{
+    switch(internalFormat){
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+    case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+    case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+        return "GL_EXT_texture_compression_s3tc";
+    case GL_COMPRESSED_RGBA_BPTC_UNORM:
+    case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+    case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+    case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+        return "GL_ARB_texture_compression_bptc";
+    default:
+        return QByteArray();
+    }
+}
+
+/**
+ * @brief TextureCodec::isSupported
+ * @param format GL format of an image
+ * @param extensions Extensions of the context, empty if unknown
+ * @return True if the context can sample the format
+ */
+bool TextureCodec::isSupported(const Format &format, const QSet<QByteArray> &extensions) noexcept{
+    auto needed = extension(format.internalFormat);
+    return extensions.isEmpty() || needed.isEmpty() || extensions.contains(needed);
+}
+
+/**
+ * @brief TextureCodec::canCompress
+ * @param extensions Extensions of the context, empty if unknown
+ * @return True if the context can sample what compress() emits
+ */
+bool TextureCodec::canCompress(const QSet<QByteArray> &extensions) noexcept{
+    return extensions.isEmpty() || extensions.contains(extension(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT));
+}
+
+/**
+ * @brief TextureCodec::decompress
+ * @param format GL format of the levels, becomes rgba8
+ * @param levels The mip levels, expanded in place
+ * @return False if the format cannot be expanded
+ *
+ * Expands S3TC (BC1 to BC3) levels to RGBA8.
+ */
+bool TextureCodec::decompress(Format &format, QVector<Level> &levels) noexcept{
+    bool threeColor = false, alpha = true, explicitAlpha = false;
+    switch(format.internalFormat){
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+        threeColor = true;
+        alpha = false;
+        break;
+    case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+    case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+        explicitAlpha = true;
+        break;
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+    case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+        break;
+    default:
+        return false;
+    }
+
+    int size = alpha ? 16 : 8;
+    for(auto &level : levels){
+        int blocksX = (level.width + 3) / 4, blocksY = (level.height + 3) / 4;
+        if(level.data.size() < blocksX * blocksY * size)
+            return false;
+        QByteArray data(level.width * level.height * 4, 0);
+        auto in = reinterpret_cast<const uchar*>(level.data.constData());
+        auto out = reinterpret_cast<uchar*>(data.data());
+
+        uchar block[64];
+        for(int by = 0; by < blocksY; ++by){
+            for(int bx = 0; bx < blocksX; ++bx){
+                if(alpha){
+                    decompressColorBlock(in + 8, false, block);
+                    decompressAlphaBlock(in, explicitAlpha, block);
+                } else
+                    decompressColorBlock(in, threeColor, block);
+                in += size;
+
+                // Edge blocks hold pixels outside of the level
+                for(int i = 0; i < 16; ++i){
+                    int x = bx * 4 + i % 4, y = by * 4 + i / 4;
+                    if(x < level.width && y < level.height)
+                        std::memcpy(out + (y * level.width + x) * 4, block + i * 4, 4);
+                }
+            }
+        }
+        level.data = data;
+    }
+    format = rgba8;
+    return true;
+}
+
+/**
+ * @brief TextureCodec::writeKtx
+ * @param format GL format of the data
+ * @param levels The mip levels
+ * @return A KTX 1.1 file holding the levels
+ */
+QByteArray TextureCodec::writeKtx(const Format &format, const QVector<Level> &levels) noexcept{
+    QByteArray file(64, 0);
+    auto header = reinterpret_cast<uchar*>(file.data());
+    std::memcpy(header, ktxIdentifier, sizeof(ktxIdentifier));
+    qToLittleEndian<quint32>(0x04030201, header + 12);
+    qToLittleEndian<quint32>(format.compressed ? 0 : format.type, header + 16);
+    qToLittleEndian<quint32>(format.compressed ? 1 : 0, header + 20);
+    qToLittleEndian<quint32>(format.compressed ? 0 : format.format, header + 24);
+    qToLittleEndian<quint32>(format.internalFormat, header + 28);
+    qToLittleEndian<quint32>(GL_RGBA, header + 32);
+    qToLittleEndian<quint32>(levels.isEmpty() ? 0 : levels[0].width, header + 36);
+    qToLittleEndian<quint32>(levels.isEmpty() ? 0 : levels[0].height, header + 40);
+    qToLittleEndian<quint32>(1, header + 52);
+    qToLittleEndian<quint32>(levels.size(), header + 56);
+
+    for(auto &level : levels){
+        uchar size[4];
+        qToLittleEndian<quint32>(level.data.size(), size);
+        file.append(reinterpret_cast<const char*>(size), 4);
+        file.append(level.data);
+        file.append(QByteArray((4 - level.data.size() % 4) % 4, 0));
+    }
+    return file;
+}
+
+/**
+ * @brief TextureCodec::compress
+ * @param levels Mip chain in QImage::Format_RGBA8888
+ * @param format Receives the format that was chosen
+ * @return The compressed mip chain
+ *
+ * Compresses to BC1 if the image is opaque and to BC3 otherwise.
+ */
+QVector<TextureCodec::Level> TextureCodec::compress(const QVector<QImage> &levels, Format &format) noexcept{
+    bool alpha = false;
+    if(!levels.isEmpty()){
+        auto &image = levels[0];
+        for(int y = 0; !alpha && y < image.height(); ++y){
+            auto line = image.constScanLine(y);
+            for(int x = 0; !alpha && x < image.width(); ++x)
+                alpha = line[x * 4 + 3] != 255;
+        }
+    }
+
+    format.internalFormat = alpha ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    format.format = format.type = 0;
+    format.compressed = true;
+
+    QVector<Level> compressed;
+    for(auto &image : levels){
+        Level level;
+        level.width = image.width();
+        level.height = image.height();
+        level.data = compressLevel(image, alpha);
+        compressed.append(level);
+    }
+    return compressed;
+}
+
+/**
+ * @brief TextureCodec::compressLevel
+ * @param image One mip level in QImage::Format_RGBA8888
+ * @param alpha Whether to emit BC3 instead of BC1 blocks
+ * @return The compressed level
+ *
+ * Edge blocks are padded by repeating the border pixels.
+ */
+QByteArray TextureCodec::compressLevel(const QImage &image, bool alpha) noexcept{
+    int blocksX = (image.width() + 3) / 4, blocksY = (image.height() + 3) / 4;
+    int size = alpha ? 16 : 8;
+    QByteArray data(blocksX * blocksY * size, 0);
+    auto out = reinterpret_cast<uchar*>(data.data());
+
+    uchar block[64];
+    for(int by = 0; by < blocksY; ++by){
+        for(int bx = 0; bx < blocksX; ++bx){
+            for(int i = 0; i < 16; ++i){
+                int x = qMin(bx * 4 + i % 4, image.width() - 1);
+                int y = qMin(by * 4 + i / 4, image.height() - 1);
+                std::memcpy(block + i * 4, image.constScanLine(y) + x * 4, 4);
+            }
+            if(alpha){
+                compressAlphaBlock(block, out);
+                compressColorBlock(block, out + 8);
+            } else
+                compressColorBlock(block, out);
+            out += size;
+        }
+    }
+    return data;
+}
+
+/**
+ * @brief TextureCodec::compressColorBlock
+ * @param block 4x4 RGBA pixels
+ * @param out Receives the 8 byte BC1 color block
+ *
+ * Fits the block with the inset diagonal of its bounding
+ * box and projects every pixel onto it.
+ */
+void TextureCodec::compressColorBlock(const uchar *block, uchar *out) noexcept{
+    int low[3] = {255, 255, 255}, high[3] = {0, 0, 0};
+    for(int i = 0; i < 16; ++i){
+        for(int c = 0; c < 3; ++c){
+            low[c] = qMin(low[c], int(block[i * 4 + c]));
+            high[c] = qMax(high[c], int(block[i * 4 + c]));
+        }
+    }
+    for(int c = 0; c < 3; ++c){
+        int inset = (high[c] - low[c]) >> 4;
+        low[c] += inset;
+        high[c] -= inset;
+    }
+
+    auto pack = [](const int *c){
+        return quint16(((c[0] >> 3) << 11) | ((c[1] >> 2) << 5) | (c[2] >> 3));
+    };
+    quint16 color0 = pack(high), color1 = pack(low);
+
+    // BC1 orders its palette as color0, color1, 2/3 color0, 1/3 color0
+    static const quint32 order[4] = {1, 3, 2, 0};
+    quint32 indices = 0;
+    if(color0 != color1){
+        int axis[3] = {high[0] - low[0], high[1] - low[1], high[2] - low[2]};
+        int length = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+        for(int i = 0; i < 16; ++i){
+            int t = 0;
+            for(int c = 0; c < 3; ++c)
+                t += (block[i * 4 + c] - low[c]) * axis[c];
+            int step = qBound(0, (t * 3 + length / 2) / length, 3);
+            indices |= order[step] << (2 * i);
+        }
+    }
+
+    qToLittleEndian<quint16>(color0, out);
+    qToLittleEndian<quint16>(color1, out + 2);
+    qToLittleEndian<quint32>(indices, out + 4);
+}
+
+/**
+ * @brief TextureCodec::compressAlphaBlock
+ * @param block 4x4 RGBA pixels
+ * @param out Receives the 8 byte BC3 alpha block
+ *
+ * Uses the eight value mode between the alpha extremes.
+ */
+void TextureCodec::compressAlphaBlock(const uchar *block, uchar *out) noexcept{
+    int low = 255, high = 0;
+    for(int i = 0; i < 16; ++i){
+        low = qMin(low, int(block[i * 4 + 3]));
+        high = qMax(high, int(block[i * 4 + 3]));
+    }
+
+    quint64 indices = 0;
+    if(high != low){
+        for(int i = 0; i < 16; ++i){
+            int step = ((block[i * 4 + 3] - low) * 7 + (high - low) / 2) / (high - low);
+            quint64 code = step == 7 ? 0 : step == 0 ? 1 : 8 - step;
+            indices |= code << (3 * i);
+        }
+    }
+
+    out[0] = uchar(high);
+    out[1] = uchar(low);
+    for(int i = 0; i < 6; ++i)
+        out[2 + i] = uchar(indices >> (8 * i));
+}
+
+/**
+ * @brief TextureCodec::decompressColorBlock
+ * @param in An 8 byte BC1 color block
+ * @param threeColor Whether color0 <= color1 selects the mode
+ * with three colors and transparent black, as in BC1
+ * @param block Receives 4x4 RGBA pixels
+ */
+void TextureCodec::decompressColorBlock(const uchar *in, bool threeColor, uchar *block) noexcept{
+    quint16 color0 = qFromLittleEndian<quint16>(in), color1 = qFromLittleEndian<quint16>(in + 2);
+    quint32 indices = qFromLittleEndian<quint32>(in + 4);
+
+    int palette[4][4];
+    for(int i = 0; i < 2; ++i){
+        quint16 color = i ? color1 : color0;
+        palette[i][0] = ((color >> 11) & 31) * 255 / 31;
+        palette[i][1] = ((color >> 5) & 63) * 255 / 63;
+        palette[i][2] = (color & 31) * 255 / 31;
+        palette[i][3] = 255;
+    }
+    for(int c = 0; c < 3; ++c){
+        if(!threeColor || color0 > color1){
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        } else {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+    palette[2][3] = 255;
+    palette[3][3] = !threeColor || color0 > color1 ? 255 : 0;
+
+    for(int i = 0; i < 16; ++i)
+        for(int c = 0; c < 4; ++c)
+            block[i * 4 + c] = uchar(palette[(indices >> (2 * i)) & 3][c]);
+}
+
+/**
+ * @brief TextureCodec::decompressAlphaBlock
+ * @param in An 8 byte BC2 or BC3 alpha block
+ * @param explicitAlpha True for BC2, false for BC3
+ * @param block Receives the alpha of 4x4 RGBA pixels
+ */
+void TextureCodec::decompressAlphaBlock(const uchar *in, bool explicitAlpha, uchar *block) noexcept{
+    if(explicitAlpha){
+        for(int i = 0; i < 16; ++i)
+            block[i * 4 + 3] = uchar(((in[i / 2] >> (4 * (i % 2))) & 15) * 17);
+        return;
+    }
+
+    int alpha[8] = {in[0], in[1]};
+    for(int i = 1; i < 7; ++i){
+        if(alpha[0] > alpha[1])
+            alpha[i + 1] = ((7 - i) * alpha[0] + i * alpha[1]) / 7;
+        else if(i < 5)
+            alpha[i + 1] = ((5 - i) * alpha[0] + i * alpha[1]) / 5;
+    }
+    if(alpha[0] <= alpha[1]){
+        alpha[6] = 0;
+        alpha[7] = 255;
+    }
+
+    quint64 indices = 0;
+    for(int i = 0; i < 6; ++i)
+        indices |= quint64(in[2 + i]) << (8 * i);
+    for(int i = 0; i < 16; ++i)
+        block[i * 4 + 3] = uchar(alpha[(indices >> (3 * i)) & 7]);
+}
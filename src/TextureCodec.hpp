@@ -0,0 +1,53 @@
+#ifndef TEXTURECODEC_HPP
+#define TEXTURECODEC_HPP
+
+#include <QImage>
+#include <QVector>
+#include <QSet>
+#include <QByteArray>
+#include <QOpenGLFunctions>
+
+/**
+ * @brief The TextureCodec class
+ *
+ * Reads and writes GPU ready texture containers (KTX and DDS)
+ * and compresses decoded images to BC1/BC3, so that they can be
+ * uploaded without ever being expanded to RGBA on the GPU.
+ * S3TC and BPTC need an extension on a GL 3.3 context; S3TC
+ * images are expanded to RGBA8 for contexts without it.
+ */
+class TextureCodec{
+public:
+    struct Level{
+        int width, height;
+        QByteArray data;
+    };
+
+    struct Format{
+        GLenum internalFormat, format, type;
+        bool compressed;
+    };
+
+    static const Format rgba8;
+
+    static bool isContainer(const QString &path) noexcept;
+    static bool read(const QByteArray &file, Format &format, QVector<Level> &levels) noexcept;
+    static bool readKtx(const QByteArray &file, Format &format, QVector<Level> &levels) noexcept;
+    static bool readDds(const QByteArray &file, Format &format, QVector<Level> &levels) noexcept;
+    static QByteArray writeKtx(const Format &format, const QVector<Level> &levels) noexcept;
+    static QVector<Level> compress(const QVector<QImage> &levels, Format &format) noexcept;
+    static int blockSize(GLenum internalFormat) noexcept;
+    static QByteArray extension(GLenum internalFormat) noexcept;
+    static bool isSupported(const Format &format, const QSet<QByteArray> &extensions) noexcept;
+    static bool canCompress(const QSet<QByteArray> &extensions) noexcept;
+    static bool decompress(Format &format, QVector<Level> &levels) noexcept;
+
+private:
+    static QByteArray compressLevel(const QImage &level, bool alpha) noexcept;
+    static void compressColorBlock(const uchar *block, uchar *out) noexcept;
+    static void compressAlphaBlock(const uchar *block, uchar *out) noexcept;
+    static void decompressColorBlock(const uchar *in, bool threeColor, uchar *block) noexcept;
+    static void decompressAlphaBlock(const uchar *in, bool explicitAlpha, uchar *block) noexcept;
+};
+
+#endif // TEXTURECODEC_HPP
@@ -0,0 +1,203 @@
+#include "UniformTable.hpp"
+
+#include <cstring>
+
+const char *UniformTable::blockName = "SandboxFrame";
+
+const char *UniformTable::builtinNames[BuiltinCount] = {
+    "P", "V", "M", "mouse", "time", "timeDelta", "frame", "ration",
+    "audioLevel", "audioPeak", "audioOnset", "beat", "bpm", "timeSeconds"
+};
+
+/**
+ * @brief UniformTable::UniformTable
+ *
+ * Creates an empty table. Requires a current 3.3 core context.
+ */
+UniformTable::UniformTable() : buffer(0), dirty(false){
+    initializeOpenGLFunctions();
+    for(auto &builtin : builtins)
+        builtin = Uniform{-1, -1, 0, false};
+}
+
+/**
+ * @brief UniformTable::~UniformTable
+ *
+ * Frees the uniform buffer.
+ */
+UniformTable::~UniformTable(){
+    if(buffer)
+        glDeleteBuffers(1, &buffer);
+}
+
+/**
+ * @brief UniformTable::reflect
+ * @param program A successfully linked program
+ *
+ * Queries all active uniforms of program with their locations
+ * or block offsets, and sets up the uniform buffer if the
+ * program declares the SandboxFrame block.
+ */
+void UniformTable::reflect(GLuint program) noexcept{
+    uniforms.clear();
+    staging.clear();
+    dirty = false;
+
+    GLuint frameBlock = glGetUniformBlockIndex(program, blockName);
+    QString blockPrefix = QString(blockName) + ".";
+
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    QByteArray name(qMax(1, maxLength), 0);
+
+    for(GLuint i = 0; i < GLuint(count); ++i){
+        GLsizei length = 0;
+        GLint size, block, offset, rowMajor;
+        GLenum type;
+        glGetActiveUniform(program, i, name.size(), &length, &size, &type, name.data());
+        glGetActiveUniformsiv(program, 1, &i, GL_UNIFORM_BLOCK_INDEX, &block);
+        glGetActiveUniformsiv(program, 1, &i, GL_UNIFORM_OFFSET, &offset);
+        glGetActiveUniformsiv(program, 1, &i, GL_UNIFORM_IS_ROW_MAJOR, &rowMajor);
+
+        Uniform uniform;
+        uniform.type = type;
+        uniform.rowMajor = rowMajor;
+        uniform.location = block < 0 ? glGetUniformLocation(program, name.constData()) : -1;
+        uniform.offset = (block >= 0 && GLuint(block) == frameBlock) ? offset : -1;
+
+        auto uniformName = QString::fromLatin1(name.constData(), length);
+        if(uniformName.endsWith("[0]"))
+            uniformName.chop(3);
+        uniforms.insert(uniformName, uniform);
+    }
+
+    // A built-in may be a member of the block and a plain
+    // uniform at once; both are set
+    for(int i = 0; i < BuiltinCount; ++i){
+        builtins[i] = Uniform{-1, -1, 0, false};
+        auto plain = uniforms.find(builtinNames[i]);
+        if(plain != uniforms.end())
+            builtins[i] = plain.value();
+        auto member = uniforms.find(blockPrefix + builtinNames[i]);
+        if(member != uniforms.end() && member->offset >= 0){
+            builtins[i].offset = member->offset;
+            builtins[i].rowMajor = member->rowMajor;
+            builtins[i].type = member->type;
+        }
+    }
+
+    if(frameBlock != GL_INVALID_INDEX){
+        GLint size = 0;
+        glGetActiveUniformBlockiv(program, frameBlock, GL_UNIFORM_BLOCK_DATA_SIZE, &size);
+        staging = QByteArray(size, 0);
+
+        glUniformBlockBinding(program, frameBlock, blockBinding);
+        if(!buffer)
+            glGenBuffers(1, &buffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+        glBufferData(GL_UNIFORM_BUFFER, size, 0, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, blockBinding, buffer);
+    }
+}
+
+/**
+ * @brief UniformTable::isActive
+ * @param name Name of a uniform
+ * @return True if the program uses the uniform
+ */
+bool UniformTable::isActive(const QString &name) const noexcept{
+    return uniforms.contains(name);
+}
+
+/**
+ * @brief UniformTable::isActive
+ * @param builtin One of the per-frame values
+ * @return True if the program uses the value
+ */
+bool UniformTable::isActive(Builtin builtin) const noexcept{
+    return builtins[builtin].location >= 0 || builtins[builtin].offset >= 0;
+}
+
+/**
+ * @brief UniformTable::location
+ * @param name Name of a uniform outside of any block
+ * @return Its location, or -1 if it is inactive
+ */
+GLint UniformTable::location(const QString &name) const noexcept{
+    auto it = uniforms.find(name);
+    return it == uniforms.end() ? -1 : it->location;
+}
+
+/**
+ * @brief UniformTable::hasBlock
+ * @return True if the program declares the SandboxFrame block
+ */
+bool UniformTable::hasBlock() const noexcept{
+    return !staging.isEmpty();
+}
+
+/**
+ * @brief UniformTable::set
+ * @param builtin One of the per-frame values
+ * @param value Its value for this frame
+ *
+ * Stages the value in the block or sets the plain uniform.
+ * Does nothing if the program does not use it. The program
+ * has to be bound.
+ */
+void UniformTable::set(Builtin builtin, float value) noexcept{
+    auto &uniform = builtins[builtin];
+    if(uniform.offset >= 0){
+        std::memcpy(staging.data() + uniform.offset, &value, sizeof(value));
+        dirty = true;
+    }
+    if(uniform.location >= 0)
+        glUniform1f(uniform.location, value);
+}
+
+void UniformTable::set(Builtin builtin, int value) noexcept{
+    auto &uniform = builtins[builtin];
+    if(uniform.offset >= 0){
+        std::memcpy(staging.data() + uniform.offset, &value, sizeof(value));
+        dirty = true;
+    }
+    if(uniform.location >= 0)
+        glUniform1i(uniform.location, value);
+}
+
+void UniformTable::set(Builtin builtin, const QVector2D &value) noexcept{
+    auto &uniform = builtins[builtin];
+    GLfloat data[2] = {value.x(), value.y()};
+    if(uniform.offset >= 0){
+        std::memcpy(staging.data() + uniform.offset, data, sizeof(data));
+        dirty = true;
+    }
+    if(uniform.location >= 0)
+        glUniform2fv(uniform.location, 1, data);
+}
+
+void UniformTable::set(Builtin builtin, const QMatrix4x4 &value) noexcept{
+    auto &uniform = builtins[builtin];
+    if(uniform.offset >= 0){
+        auto matrix = uniform.rowMajor ? value.transposed() : value;
+        std::memcpy(staging.data() + uniform.offset, matrix.constData(), 16 * sizeof(GLfloat));
+        dirty = true;
+    }
+    if(uniform.location >= 0)
+        glUniformMatrix4fv(uniform.location, 1, GL_FALSE, value.constData());
+}
+
+/**
+ * @brief UniformTable::flush
+ *
+ * Uploads the staged block with a single glBufferSubData
+ * if any of its values changed.
+ */
+void UniformTable::flush() noexcept{
+    if(!dirty || !buffer)
+        return;
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, staging.size(), staging.constData());
+    dirty = false;
+}
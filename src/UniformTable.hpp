@@ -0,0 +1,86 @@
+#ifndef UNIFORMTABLE_HPP
+#define UNIFORMTABLE_HPP
+
+#include <QHash>
+#include <QVector>
+#include <QByteArray>
+#include <QMatrix4x4>
+#include <QVector2D>
+#include <QOpenGLFunctions_3_3_Core>
+
+/**
+ * @brief The UniformTable class
+ *
+ * The reflection of a linked shader program. It is built
+ * once per link and knows every live uniform, so the per-frame
+ * values of the renderer (matrices, time, mouse, ...) are only
+ * sent to uniforms the program actually uses.
+ *
+ * If the program declares the std140 block SandboxFrame, the
+ * built-in values it contains are written to a staging copy
+ * at their reflected offsets and uploaded with one
+ * glBufferSubData per frame. The block is bound to binding
+ * point 0, which all programs of a renderer share. Built-ins
+ * that are declared as plain uniforms are still supported,
+ * also next to the block: one stage may use sandbox.time
+ * while the other declares "uniform float time;". Members
+ * of the block are known as SandboxFrame.name, plain
+ * uniforms by their name.
+ */
+class UniformTable : protected QOpenGLFunctions_3_3_Core{
+public:
+    enum Builtin{
+        ProjectionMatrix,
+        ViewMatrix,
+        ModelMatrix,
+        Mouse,
+        Time,
+        TimeDelta,
+        Frame,
+        Ration,
+        AudioLevel,
+        AudioPeak,
+        AudioOnset,
+        Beat,
+        Bpm,
+        TimeSeconds,
+        BuiltinCount
+    };
+
+    static const char *blockName;
+    static const GLuint blockBinding = 0;
+
+    UniformTable();
+    ~UniformTable();
+    void reflect(GLuint program) noexcept;
+    bool isActive(const QString &name) const noexcept;
+    bool isActive(Builtin) const noexcept;
+    GLint location(const QString &name) const noexcept;
+    bool hasBlock() const noexcept;
+
+    void set(Builtin, float) noexcept;
+    void set(Builtin, int) noexcept;
+    void set(Builtin, const QVector2D &) noexcept;
+    void set(Builtin, const QMatrix4x4 &) noexcept;
+    void flush() noexcept;
+
+private:
+    UniformTable(const UniformTable &);
+    UniformTable& operator=(const UniformTable& rhs);
+
+    struct Uniform{
+        GLint location, offset;
+        GLenum type;
+        bool rowMajor;
+    };
+
+    static const char *builtinNames[BuiltinCount];
+
+    QHash<QString, Uniform> uniforms;
+    Uniform builtins[BuiltinCount];
+    QByteArray staging;
+    GLuint buffer;
+    bool dirty;
+};
+
+#endif // UNIFORMTABLE_HPP
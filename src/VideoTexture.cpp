@@ -0,0 +1,254 @@
+#include "VideoTexture.hpp"
+
+#include <algorithm>
+
+#include <QCollator>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+
+/**
+ * @brief FrameDecoder::FrameDecoder
+ * @param files The frames of the sequence, in order
+ * @param capacity Number of frames to hold at most
+ * @param parent Parent object
+ */
+FrameDecoder::FrameDecoder(const QStringList &files, int capacity, QObject *parent) :
+    QThread(parent), files(files), capacity(qMin(capacity, files.size())), target(0), stopping(false)
+{ }
+
+/**
+ * @brief FrameDecoder::~FrameDecoder
+ *
+ * Lets the decoding loop run out and waits for it.
+ */
+FrameDecoder::~FrameDecoder(){
+    mutex.lock();
+    stopping = true;
+    wanted.wakeAll();
+    mutex.unlock();
+    wait();
+}
+
+/**
+ * @brief FrameDecoder::seek
+ * @param index The frame the renderer wants to show next
+ *
+ * Moves the decoding window so it starts at index.
+ */
+void FrameDecoder::seek(int index) noexcept{
+    QMutexLocker lock(&mutex);
+    if(target == index)
+        return;
+    target = index;
+    wanted.wakeAll();
+}
+
+/**
+ * @brief FrameDecoder::frame
+ * @param index Index of the frame
+ * @return The decoded frame, or a null image if it is not decoded
+ * (yet) or was skipped
+ *
+ * Never waits for decoding; the lock is only held by the
+ * decoder while it updates its bookkeeping.
+ */
+QImage FrameDecoder::frame(int index) noexcept{
+    QMutexLocker lock(&mutex);
+    return frames.value(index);
+}
+
+/**
+ * @brief FrameDecoder::frameCount
+ * @return Length of the sequence
+ */
+int FrameDecoder::frameCount() const noexcept{
+    return files.size();
+}
+
+/**
+ * @brief FrameDecoder::inWindow
+ * @param index Index of a frame
+ * @return True if the frame is one of the next capacity frames
+ */
+bool FrameDecoder::inWindow(int index) const noexcept{
+    return (index - target + files.size()) % files.size() < capacity;
+}
+
+/**
+ * @brief FrameDecoder::run
+ *
+ * Decodes the first missing frame of the window, drops frames
+ * that fell out of it and sleeps once the window is full. Frames
+ * that leave the window are tried again when they come back.
+ */
+void FrameDecoder::run() noexcept{
+    QMutexLocker lock(&mutex);
+    while(!stopping){
+        for(auto index : frames.keys())
+            if(!inWindow(index))
+                frames.remove(index);
+        for(auto index : failures.keys())
+            if(!inWindow(index))
+                failures.remove(index);
+        for(auto index : skipped.values())
+            if(!inWindow(index))
+                skipped.remove(index);
+
+        int missing = -1;
+        for(int i = 0; missing < 0 && i < capacity; ++i){
+            int index = (target + i) % files.size();
+            if(!frames.contains(index) && !skipped.contains(index))
+                missing = index;
+        }
+        if(missing < 0){
+            wanted.wait(&mutex);
+            continue;
+        }
+
+        auto file = files[missing];
+        lock.unlock();
+        auto image = QImage(file).convertToFormat(QImage::Format_RGBA8888);
+        lock.relock();
+
+        if(!inWindow(missing))
+            continue;
+        if(!image.isNull()){
+            failures.remove(missing);
+            frames.insert(missing, image);
+        } else if(++failures[missing] >= attempts){
+            failures.remove(missing);
+            skipped.insert(missing);
+        }
+    }
+}
+
+
+/**
+ * @brief VideoTexture::VideoTexture
+ * @param files The frames of the sequence, in order
+ * @param fps Frames per second of the sequence
+ * @param state State cache of the owning context
+ * @param unit Texture unit the video is sampled from
+ *
+ * Creates the textures and buffers and starts decoding
+ * from the first frame.
+ */
+VideoTexture::VideoTexture(const QStringList &files, double fps, GlStateCache &state, GLuint unit) :
+    decoder(new FrameDecoder(files, 3)), fps(fps), current(0), shown(-1), buffer(0), pending(-1)
+{
+    initializeOpenGLFunctions();
+    glGenTextures(2, textures);
+    glGenBuffers(2, buffers);
+    for(auto texture : textures){
+        state.bindTexture(unit, GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    decoder->start(QThread::LowPriority);
+}
+
+/**
+ * @brief VideoTexture::~VideoTexture
+ *
+ * Stops the decoder and frees the GL objects.
+ */
+VideoTexture::~VideoTexture(){
+    decoder.reset();
+    glDeleteBuffers(2, buffers);
+    glDeleteTextures(2, textures);
+}
+
+/**
+ * @brief VideoTexture::update
+ * @param state State cache of the owning context
+ * @param unit Texture unit the video is sampled from
+ * @param msecs The renderers' time
+ *
+ * Copies the frame written into a buffer by the last update
+ * into the texture that is not sampled, and writes the frame
+ * that belongs to msecs into the other buffer if it changed
+ * and is decoded already. The sequence loops.
+ */
+void VideoTexture::update(GlStateCache &state, GLuint unit, qint64 msecs) noexcept{
+    int index = qint64(msecs * fps / 1000) % decoder->frameCount();
+
+    if(pending >= 0){
+        int slot = (current + 1) % 2;
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffers[buffer]);
+        state.bindTexture(unit, GL_TEXTURE_2D, textures[slot]);
+        if(sizes[slot] != pendingSize){
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, pendingSize.width(), pendingSize.height(), 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, 0);
+            sizes[slot] = pendingSize;
+        }
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, pendingSize.width(), pendingSize.height(),
+                        GL_RGBA, GL_UNSIGNED_BYTE, 0);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        current = slot;
+        shown = pending;
+        pending = -1;
+        buffer = (buffer + 1) % 2;
+    }
+    if(index == shown)
+        return;
+
+    decoder->seek(index);
+    auto image = decoder->frame(index);
+    if(image.isNull())
+        return;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffers[buffer]);
+    // Orphan the old storage so the driver does not have to wait for it
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, image.byteCount(), 0, GL_STREAM_DRAW);
+    glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, image.byteCount(), image.constBits());
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    pending = index;
+    pendingSize = image.size();
+}
+
+/**
+ * @brief VideoTexture::textureId
+ * @return The texture holding the current frame
+ */
+GLuint VideoTexture::textureId() const noexcept{
+    return textures[current];
+}
+
+/**
+ * @brief VideoTexture::frameFiles
+ * @param pattern A directory or a file pattern with wildcards
+ * @return The matching image files, sorted by name; numbers in
+ * names are compared by value, so frame2 comes before frame10
+ */
+QStringList VideoTexture::frameFiles(const QString &pattern) noexcept{
+    QFileInfo info(pattern);
+    QDir dir;
+    QStringList filters;
+
+    if(info.isDir())
+        dir = QDir(info.absoluteFilePath());
+    else {
+        dir = info.absoluteDir();
+        filters << info.fileName();
+    }
+    if(filters.isEmpty())
+        for(auto &format : QImageReader::supportedImageFormats())
+            filters << "*." + QString(format);
+
+    auto entries = dir.entryInfoList(filters, QDir::Files, QDir::NoSort);
+    QCollator collator;
+    collator.setNumericMode(true);
+    std::sort(entries.begin(), entries.end(), [&collator](const QFileInfo &a, const QFileInfo &b){
+        return collator.compare(a.fileName(), b.fileName()) < 0;
+    });
+
+    QStringList files;
+    for(auto &file : entries)
+        files << file.absoluteFilePath();
+    return files;
+}
@@ -0,0 +1,93 @@
+#ifndef VIDEOTEXTURE_HPP
+#define VIDEOTEXTURE_HPP
+
+#include <memory>
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QHash>
+#include <QSet>
+#include <QImage>
+#include <QStringList>
+#include <QOpenGLFunctions>
+
+#include "GlStateCache.hpp"
+
+/**
+ * @brief The FrameDecoder class
+ *
+ * A subclass of QThread that decodes the frames of an image
+ * sequence ahead of the renderer. It only ever holds a small
+ * window of frames starting at the one that was asked for
+ * last, no matter how long the sequence is. A frame that
+ * does not decode is tried a few times and then skipped until
+ * it leaves the window.
+ */
+class FrameDecoder : public QThread{
+public:
+    FrameDecoder(const QStringList &files, int capacity, QObject *parent = 0);
+    ~FrameDecoder();
+    void seek(int index) noexcept;
+    QImage frame(int index) noexcept;
+    int frameCount() const noexcept;
+
+protected:
+    void run() noexcept Q_DECL_OVERRIDE;
+
+private:
+    bool inWindow(int index) const noexcept;
+
+    static const int attempts = 3;
+
+    const QStringList files;
+    const int capacity;
+    QMutex mutex;
+    QWaitCondition wanted;
+    QHash<int, QImage> frames;
+    // Failed decodes of frames in the window, and frames given up on
+    QHash<int, int> failures;
+    QSet<int> skipped;
+    int target;
+    bool stopping;
+};
+
+/**
+ * @brief The VideoTexture class
+ *
+ * The texture behind a #video directive. Shows the frame of
+ * an image sequence that belongs to the renderers' time and
+ * uploads new frames through a pair of pixel buffer objects
+ * into a pair of textures, so the frame being sampled is never
+ * the one being written. A frame is written into a buffer in
+ * one update and copied into a texture in the next, so the
+ * copy does not wait for the transfer. If a frame is not
+ * decoded yet, the previous one stays visible. Must only be
+ * used with the owning context current, and only binds its
+ * textures on its own unit through the state cache.
+ */
+class VideoTexture : protected QOpenGLFunctions{
+public:
+    VideoTexture(const QStringList &files, double fps, GlStateCache &state, GLuint unit);
+    ~VideoTexture();
+    void update(GlStateCache &state, GLuint unit, qint64 msecs) noexcept;
+    GLuint textureId() const noexcept;
+
+    static QStringList frameFiles(const QString &pattern) noexcept;
+
+private:
+    VideoTexture(const VideoTexture &);
+    VideoTexture& operator=(const VideoTexture& rhs);
+
+    std::unique_ptr<FrameDecoder> decoder;
+    double fps;
+    GLuint textures[2], buffers[2];
+    QSize sizes[2];
+    int current, shown;
+    // The buffer that is written next, and the frame and size it
+    // holds until it is copied, or -1
+    int buffer, pending;
+    QSize pendingSize;
+};
+
+#endif // VIDEOTEXTURE_HPP
@@ -4,6 +4,7 @@
 #include <memory>
 
 #include <QTest>
+#include <QSignalSpy>
 
 #include "../src/CodeEditor.hpp"
 
@@ -12,7 +13,8 @@
  * @author Veit Heller(s0539501) & Tobias Brosge(s0539501)
  *
  * Tests the CodeEditor class; functionality tested includes
- * object creation and writing to the text editor.
+ * object creation, writing to the text editor and loading
+ * large files in slices.
  */
 class CodeEditorTest : public QObject{
 Q_OBJECT
@@ -30,6 +32,17 @@ private slots:
     void LineHighlightingTest(){
         QVERIFY(codeEditor->lineHighlightingWidth() == 10);
     }
+    void loadTextTest(){
+        QString text = QString("float f;\n").repeated(20000);
+        QSignalSpy loaded(codeEditor.get(), SIGNAL(textLoaded()));
+        codeEditor->loadText(text);
+        QVERIFY(codeEditor->isLoading());
+        QVERIFY(codeEditor->isReadOnly());
+        QVERIFY(loaded.wait());
+        QCOMPARE(codeEditor->toPlainText(), text);
+        QVERIFY(!codeEditor->isReadOnly());
+        QVERIFY(!codeEditor->document()->isModified());
+    }
 private:
     std::unique_ptr<CodeEditor> codeEditor;
 };
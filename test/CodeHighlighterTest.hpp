@@ -4,6 +4,9 @@
 #include <memory>
 
 #include <QTest>
+#include <QDir>
+#include <QTextDocument>
+#include <QTextLayout>
 
 #include "../src/CodeHighlighter.hpp"
 
@@ -12,7 +15,8 @@
  * @author Veit Heller(s0539501) & Tobias Brosge(s0539501)
  *
  * Tests the CodeHighlighter class; functionality tested includes
- * object creation and updating highlighting.
+ * object creation, updating highlighting, the tokens of the lexer,
+ * comments spanning blocks and formatting off-screen blocks later.
  */
 class CodeHighlighterTest : public QObject{
 Q_OBJECT
@@ -26,6 +30,73 @@ private slots:
     void updateTest(){
         codeHighlighter->setupHighlighting();
     }
+    void lexerTest(){
+        GlslLexer lexer(QStringList() << "float" << "vec4" << "void");
+        QVector<GlslLexer::Token> tokens;
+        auto state = lexer.tokenize("vec4 floaty = gl_FragCoord * 1.5e-3f; // \"x\"", GlslLexer::Normal, tokens);
+        QCOMPARE(state, GlslLexer::Normal);
+        QCOMPARE(tokens.size(), 4);
+        QCOMPARE(tokens[0].kind, GlslLexer::Token::Keyword);
+        QCOMPARE(tokens[0].length, 4);
+        QCOMPARE(tokens[1].kind, GlslLexer::Token::GlIdentifier);
+        QCOMPARE(tokens[2].kind, GlslLexer::Token::Number);
+        QCOMPARE(tokens[2].length, 7);
+        QCOMPARE(tokens[3].kind, GlslLexer::Token::Comment);
+
+        tokens.clear();
+        lexer.tokenize("  #define X \"a\" /* b */", GlslLexer::Normal, tokens);
+        QCOMPARE(tokens.size(), 2);
+        QCOMPARE(tokens[0].kind, GlslLexer::Token::Directive);
+        QCOMPARE(tokens[1].kind, GlslLexer::Token::Comment);
+    }
+    void multiLineCommentTest(){
+        QTextDocument document("void /* a\n b // c\n d */ float x; /* e */\n float y;");
+        CodeHighlighter highlighter(&document);
+        highlighter.rehighlight();
+        QCOMPARE(document.findBlockByNumber(0).userState(), int(GlslLexer::InComment));
+        QCOMPARE(document.findBlockByNumber(1).userState(), int(GlslLexer::InComment));
+        QCOMPARE(document.findBlockByNumber(2).userState(), int(GlslLexer::Normal));
+        QCOMPARE(document.findBlockByNumber(3).userState(), int(GlslLexer::Normal));
+
+        GlslLexer lexer(QStringList() << "float");
+        QVector<GlslLexer::Token> tokens;
+        lexer.tokenize(" d */ float x; /* e */", GlslLexer::InComment, tokens);
+        QCOMPARE(tokens.size(), 3);
+        QCOMPARE(tokens[0].length, 5);
+        QCOMPARE(tokens[1].kind, GlslLexer::Token::Keyword);
+        QCOMPARE(tokens[2].kind, GlslLexer::Token::Comment);
+    }
+    void lazyHighlightTest(){
+        QTextDocument document;
+        CodeHighlighter highlighter(&document);
+        highlighter.setVisibleBlocks(0, 10);
+        document.setPlainText(QString("float x = 1.0; /* a\n b */\n").repeated(2500));
+
+        // Only the visible blocks are formatted, but all states are known
+        QVERIFY(highlighter.hasPendingBlocks());
+        QVERIFY(!document.findBlockByNumber(0).layout()->additionalFormats().isEmpty());
+        QVERIFY(document.findBlockByNumber(4000).layout()->additionalFormats().isEmpty());
+        QCOMPARE(document.findBlockByNumber(4000).userState(), int(GlslLexer::InComment));
+
+        QTRY_VERIFY(!highlighter.hasPendingBlocks());
+        QVERIFY(!document.findBlockByNumber(4000).layout()->additionalFormats().isEmpty());
+    }
+    void highlightBenchmark(){
+        QString examples;
+        QDir dir(QFINDTESTDATA("../examples"));
+        for(auto &name : dir.entryList(QStringList() << "*.glsl", QDir::Files)){
+            QFile file(dir.filePath(name));
+            if(file.open(QIODevice::ReadOnly | QIODevice::Text))
+                examples += QString::fromUtf8(file.readAll()) + "\n";
+        }
+        QVERIFY(!examples.isEmpty());
+
+        QTextDocument document(examples.repeated(100));
+        CodeHighlighter highlighter(&document);
+        QBENCHMARK{
+            highlighter.rehighlight();
+        }
+    }
 private:
     std::unique_ptr<CodeHighlighter> codeHighlighter;
 };
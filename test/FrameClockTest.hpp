@@ -0,0 +1,76 @@
+#ifndef FRAMECLOCKTEST_H
+#define FRAMECLOCKTEST_H
+
+#include <QTest>
+
+#include "../src/FrameClock.hpp"
+
+/**
+ * @brief The FrameClock Testing class
+ *
+ * Tests the FrameClock class; functionality tested includes
+ * the fixed step, pausing, scrubbing and the wrapped seconds.
+ * Only the fixed step is used, so the times are exact.
+ */
+class FrameClockTest : public QObject{
+Q_OBJECT
+private slots:
+    void fixedStepTest(){
+        FrameClock clock;
+        clock.setFixedStep(10);
+        clock.tick();
+        QCOMPARE(clock.frame(), qint64(0));
+        QCOMPARE(clock.msecs(), 0.0);
+        QCOMPARE(clock.delta(), 0.0);
+
+        for(int i = 0; i < 3; ++i)
+            clock.tick();
+        QCOMPARE(clock.frame(), qint64(3));
+        QCOMPARE(clock.msecs(), 30.0);
+        QCOMPARE(clock.delta(), 10.0);
+
+        clock.restart();
+        clock.tick();
+        clock.tick();
+        QCOMPARE(clock.frame(), qint64(1));
+        QCOMPARE(clock.msecs(), 10.0);
+    }
+    void pauseScrubTest(){
+        FrameClock clock;
+        clock.setFixedStep(10);
+        clock.tick();
+        clock.setPaused(true);
+        clock.tick();
+        QCOMPARE(clock.frame(), qint64(1));
+        QCOMPARE(clock.msecs(), 0.0);
+
+        clock.scrub(500);
+        clock.tick();
+        QCOMPARE(clock.msecs(), 500.0);
+        clock.setPaused(false);
+        clock.tick();
+        QCOMPARE(clock.msecs(), 510.0);
+
+        clock.scrub(-5);
+        clock.tick();
+        QCOMPARE(clock.msecs(), 10.0);
+    }
+    void secondsTest(){
+        FrameClock clock;
+        clock.setFixedStep(250);
+        clock.tick();
+        clock.tick();
+        QCOMPARE(clock.seconds(), 0.25);
+
+        // A day in, the seconds still resolve a single step
+        clock.scrub(24.0 * 3600 * 1000);
+        clock.tick();
+        QCOMPARE(clock.seconds(), 0.25);
+
+        clock.scrub((FrameClock::wrapSeconds - 0.25) * 1000);
+        clock.tick();
+        QCOMPARE(clock.seconds(), 0.0);
+    }
+};
+
+#endif // FRAMECLOCKTEST_H
@@ -0,0 +1,93 @@
+#ifndef GLSLPARSERTEST_H
+#define GLSLPARSERTEST_H
+
+#include <QTest>
+
+#include "../src/GlslParser.hpp"
+
+/**
+ * @brief The GlslParser Testing class
+ *
+ * Tests the GlslParser class; functionality tested includes
+ * the symbol index, syntax errors and reparsing only the
+ * chunks that changed.
+ */
+class GlslParserTest : public QObject{
+Q_OBJECT
+private slots:
+    void symbolTest(){
+        GlslParser parser;
+        auto result = parser.parse(
+                    "#version 330 core\n"
+                    "#include <sandbox.glsl>\n"
+                    "#texture wood images/wood.png\n"
+                    "layout(std140) uniform Frame{ mat4 P; float time; };\n"
+                    "uniform sampler2D a, b[2];\n"
+                    "in vec2 uv;\n"
+                    "out vec4 color;\n"
+                    "struct Light{ vec3 position; };\n"
+                    "float shade(vec3 n, Light l);\n"
+                    "float shade(vec3 n, Light l){\n"
+                    "    return max(dot(n, l.position), 0.0);\n"
+                    "}\n"
+                    "void main(){ color = vec4(shade(vec3(uv, 1), Light(vec3(1)))); }\n");
+        QVERIFY(result.errors.isEmpty());
+
+        QStringList names;
+        for(auto &symbol : result.symbols)
+            names.append(symbol.name);
+        QCOMPARE(names, QStringList() << "sandbox.glsl" << "wood" << "Frame" << "P" << "time"
+                                      << "a" << "b" << "uv" << "color" << "Light" << "shade" << "main");
+
+        auto shade = result.find("shade");
+        QVERIFY(shade);
+        QCOMPARE(shade->kind, GlslSymbol::Function);
+        QCOMPARE(shade->line, 10);
+        QCOMPARE(shade->column, 7);
+        QCOMPARE(shade->detail, QString("float shade(vec3 n, Light l)"));
+        QCOMPARE(result.find("time")->kind, GlslSymbol::Uniform);
+        QCOMPARE(result.find("wood")->kind, GlslSymbol::Texture);
+        QCOMPARE(result.find("uv")->kind, GlslSymbol::Input);
+    }
+    void errorTest(){
+        GlslParser parser;
+        auto result = parser.parse(
+                    "void main(){\n"
+                    "    float a = 1.0\n"
+                    "    float b = (a;\n"
+                    "    if(a > b)\n"
+                    "        a = b;\n"
+                    "}\n"
+                    "float c = 2.0\n");
+        QCOMPARE(result.errors.size(), 2);
+        QCOMPARE(result.errors[0].line, 3);
+        QCOMPARE(result.errors[0].message, QString("expected ')' before ';'"));
+        QCOMPARE(result.errors[0].severity, ShaderDiagnostic::Error);
+        QCOMPARE(result.errors[1].line, 7);
+
+        result = parser.parse("void main(){\n    float a = 1.0\n    float b;\n}\n/* open");
+        QCOMPARE(result.errors.size(), 2);
+        QCOMPARE(result.errors[0].line, 2);
+        QCOMPARE(result.errors[0].column, 18);
+        QCOMPARE(result.errors[0].severity, ShaderDiagnostic::Warning);
+        QCOMPARE(result.errors[1].message, QString("unterminated comment"));
+        QCOMPARE(result.errors[1].severity, ShaderDiagnostic::Error);
+    }
+    void incrementalTest(){
+        GlslParser parser;
+        QString first = "float f(){ return 1.0; }\n";
+        QString second = "float g(){ return 2.0; }\n";
+        parser.parse(first + second);
+        QCOMPARE(parser.chunksParsed(), quint64(2));
+
+        // Only the edited function is parsed again, lines still move
+        QString edited = "\n" + first + QString(second).replace("2.0", "3.0");
+        auto result = parser.parse(edited);
+        QCOMPARE(parser.chunksParsed(), quint64(3));
+        QCOMPARE(result.find("g")->line, 3);
+        parser.parse(edited);
+        QCOMPARE(parser.chunksParsed(), quint64(3));
+    }
+};
+
+#endif // GLSLPARSERTEST_H
@@ -2,8 +2,15 @@
 #define RENDERERTEST
 
 #include <QTest>
+#include <QSignalSpy>
+#include <QDir>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLShaderProgram>
 
-#include "../src/LiveThread.hpp"
+#include "../src/RenderThread.hpp"
+#include "../src/ShaderPreprocessor.hpp"
+#include "../src/ShaderDiagnostics.hpp"
 
 /**
  * @brief The RendererTest class
@@ -11,61 +18,110 @@
  *
  * Tests the Renderer class; functionality tested
  * includes object creation, thread management, code
- * execution and return validity.
+ * execution, the diagnostics of failed compiles,
+ * cooperative shutdown and linking the examples against
+ * the default vertex shader.
  */
 class RendererTest : public QObject{
 Q_OBJECT
 private slots:
+    void initTestCase(){
+        qRegisterMetaType<QList<ShaderDiagnostic>>("QList<ShaderDiagnostic>");
+    }
     void init(){
-        thread = new GlLiveThread(0);
+        thread = new RenderThread();
+        thread->start();
+        renderer = 0;
     }
     void objectCreationTest() {
         QVERIFY(thread);
     }
     void runTest(){
-        connect(thread, SIGNAL(errorSignal(GlLiveThread*, QString, int)),
-                this, SLOT(finishedTest(GlLiveThread*, QString, int)));
-        connect(thread, SIGNAL(doneSignal(GlLiveThread*, QString)),
-                 this, SLOT(doneTest(GlLiveThread*, QString)));
-        auto runObj = new Renderer("this is not valid code", "this as well");
-        thread->initialize(runObj);
-        thread->start();
+        renderer = new Renderer("this is not valid code", "this as well");
+        QSignalSpy vertex(renderer, SIGNAL(vertexDiagnostics(QList<ShaderDiagnostic>)));
+        renderer->show();
+        thread->add(renderer);
         QTest::qWait(1000);
-        thread->terminate();
+
+        // The vertex stage fails first, the fragment stage is not compiled
+        QVERIFY(vertex.count() > 0);
+        auto diagnostics = vertex.takeFirst().at(0).value<QList<ShaderDiagnostic>>();
+        QVERIFY(ShaderDiagnostics::hasErrors(diagnostics));
+
+        QSignalSpy released(thread, SIGNAL(released(Renderer*)));
+        thread->remove(renderer);
+        QVERIFY(released.wait(1000));
+        QCOMPARE(released.takeFirst().at(0).value<Renderer*>(), renderer);
     }
     void commandTest(){
-        connect(thread, SIGNAL(errorSignal(GlLiveThread*, QString, int)),
-                this, SLOT(finishedCommandTest(GlLiveThread*, QString, int)));
-        connect(thread, SIGNAL(doneSignal(GlLiveThread*, QString)),
-                 this, SLOT(doneTest(GlLiveThread*, QString)));
-        auto runObj = new Renderer("#version 330 core", "#version 330 core");
-        thread->initialize(runObj);
-        thread->start();
+        QFile vertexFile(":/rc/template.vert");
+        QVERIFY(vertexFile.open(QFile::ReadOnly));
+        renderer = new Renderer(QString(vertexFile.readAll()), "#version 330 core\nvoid main(){\n    x = 1;\n}\n");
+        QSignalSpy vertex(renderer, SIGNAL(vertexDiagnostics(QList<ShaderDiagnostic>)));
+        QSignalSpy fragment(renderer, SIGNAL(fragmentDiagnostics(QList<ShaderDiagnostic>)));
+        renderer->show();
+        thread->add(renderer);
         QTest::qWait(1000);
-        thread->terminate();
-    }
-    void finishedTest(GlLiveThread* returnedThread, QString returned, int lineno){
-        QVERIFY(returnedThread == thread);
-        QVERIFY(returned != "");
-        QCOMPARE(returned, QStringLiteral("ERROR: 0:1: '' :  #version required and missing.\nERROR: 0:4: 'This' : syntax error: syntax error\n"));
-        QVERIFY(lineno == 1);
-    }
-    void finishedCommandTest(GlLiveThread* returnedThread, QString returned, int lineno){
-        QVERIFY(returnedThread == thread);
-        QVERIFY(returned != "");
-        QCOMPARE(returned, QStringLiteral("ERROR: 0:1: '' :  #version required and missing.\n"));
-        QVERIFY(lineno == 1);
+
+        // Lines are counted in the code as written
+        QCOMPARE(vertex.count(), 0);
+        QVERIFY(fragment.count() > 0);
+        auto diagnostics = fragment.takeFirst().at(0).value<QList<ShaderDiagnostic>>();
+        QVERIFY(!diagnostics.isEmpty());
+        QCOMPARE(diagnostics[0].severity, ShaderDiagnostic::Error);
+        QCOMPARE(diagnostics[0].line, 3);
+
+        QSignalSpy released(thread, SIGNAL(released(Renderer*)));
+        thread->remove(renderer);
+        QVERIFY(released.wait(1000));
+        QCOMPARE(released.takeFirst().at(0).value<Renderer*>(), renderer);
     }
-    void doneTest(GlLiveThread* returnedThread, QString err){
-        QVERIFY(returnedThread == thread);
-        Q_UNUSED(err);
+    void exampleLinkTest(){
+        QSurfaceFormat format;
+        format.setVersion(3, 3);
+        format.setProfile(QSurfaceFormat::CoreProfile);
+        QOffscreenSurface surface;
+        surface.setFormat(format);
+        surface.create();
+        QOpenGLContext context;
+        context.setFormat(format);
+        if(!context.create() || !context.makeCurrent(&surface))
+            QSKIP("No OpenGL 3.3 context available");
+
+        QFile vertexFile(":/rc/template.vert");
+        QVERIFY(vertexFile.open(QFile::ReadOnly));
+        ShaderPreprocessor preprocessor;
+        auto vertex = preprocessor.process(QString(vertexFile.readAll()));
+        QVERIFY(vertex.ok());
+
+        QDir examples(QFINDTESTDATA("../examples"));
+        auto names = examples.entryList(QStringList() << "*.glsl", QDir::Files);
+        QVERIFY(!names.isEmpty());
+        for(auto &name : names){
+            QFile file(examples.filePath(name));
+            QVERIFY(file.open(QFile::ReadOnly));
+            QString code(file.readAll());
+            // Textures are resolved relative to the example
+            if(code.contains("#texture") || code.contains("#video"))
+                continue;
+            auto fragment = preprocessor.process(code, examples.path(), "_fragmentTweak");
+            QVERIFY2(fragment.ok(), qPrintable(name));
+
+            QOpenGLShaderProgram program;
+            QVERIFY2(program.addShaderFromSourceCode(QOpenGLShader::Vertex, vertex.source), qPrintable(name));
+            QVERIFY2(program.addShaderFromSourceCode(QOpenGLShader::Fragment, fragment.source), qPrintable(name));
+            QVERIFY2(program.link(), qPrintable(name + ": " + program.log()));
+        }
+        context.doneCurrent();
     }
     void cleanup(){
         delete thread;
+        delete renderer;
     }
 
 private:
-    LiveThread* thread;
+    RenderThread* thread;
+    Renderer* renderer;
 };
 
 #endif // RENDERERTEST
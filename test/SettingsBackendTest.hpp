@@ -10,7 +10,8 @@
  * @author Veit Heller(s0539501) & Tobias Brosge(s0539501)
  *
  * Tests the SettingsBackend class; functionality tested includes
- * object creation, writing to and reading from the settings.
+ * object creation, writing to and reading from the settings
+ * and batching writes through a settings store.
  */
 class SettingsBackendTest : public QObject{
 Q_OBJECT
@@ -30,6 +31,35 @@ private slots:
     void settingsRemoveTest(){
         SettingsBackend::removeSettings(4711);
     }
+    void storeTest(){
+        {
+            SettingsStore store(SettingsBackend::globalName);
+            QVERIFY(SettingsStore::active() == &store);
+
+            SettingsBackend::saveSettingsFor(4712, QStringLiteral("testkey"), QVariant(1));
+            SettingsBackend::saveSettingsFor(4712, QStringLiteral("testkey"), QVariant(2));
+            SettingsBackend::saveSettingsFor(4712, QHash<QString, QVariant>{{"testkey2", "joy"}});
+            QCOMPARE(SettingsBackend::getSettingsFor("testkey", 0, 4712).toInt(), 2);
+            QCOMPARE(SettingsBackend::getSettings(4712).size(), 2);
+
+            // The burst is written once, after the delay
+            QCOMPARE(store.flushes(), quint64(0));
+            QTRY_COMPARE_WITH_TIMEOUT(store.flushes(), quint64(1), SettingsStore::flushDelay * 4);
+            store.sync();
+            QCOMPARE(QSettings(SettingsBackend::globalName, "Live Code Editor/4712").value("testkey").toInt(), 2);
+
+            // Values that did not change are not written again
+            SettingsBackend::saveSettingsFor(4712, QStringLiteral("testkey"), QVariant(2));
+            store.flush();
+            QCOMPARE(store.flushes(), quint64(1));
+
+            SettingsBackend::removeSettings(4712);
+            QVERIFY(SettingsBackend::getSettings(4712).isEmpty());
+        }
+        // Destroying the store wrote the removal
+        QVERIFY(!SettingsStore::active());
+        QVERIFY(QSettings(SettingsBackend::globalName, "Live Code Editor/4712").allKeys().isEmpty());
+    }
 };
 
 #endif // SETTINGSBACKENDTEST
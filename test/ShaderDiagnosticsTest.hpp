@@ -0,0 +1,76 @@
+#ifndef SHADERDIAGNOSTICSTEST_H
+#define SHADERDIAGNOSTICSTEST_H
+
+#include <QTest>
+
+#include "../src/ShaderDiagnostics.hpp"
+
+/**
+ * @brief The ShaderDiagnostics Testing class
+ *
+ * Tests the ShaderDiagnostics class; functionality tested includes
+ * the log formats of the drivers and mapping through the source map.
+ */
+class ShaderDiagnosticsTest : public QObject{
+Q_OBJECT
+private slots:
+    void initTestCase(){
+        expansion = ShaderPreprocessor().process("#version 330 core\nvoid main(){\n    x = 1;\n}\n");
+        QVERIFY(expansion.ok());
+        // An included file as source string 1
+        expansion.files.append("common.glsl");
+    }
+    void mesaTest(){
+        auto diagnostics = ShaderDiagnostics::parse(
+                    "0:3(5): error: `x' undeclared\n"
+                    "0:3(5): warning: unused value\n"
+                    "1:7(1): error: syntax error\n", expansion);
+        QCOMPARE(diagnostics.size(), 3);
+        QCOMPARE(diagnostics[0].severity, ShaderDiagnostic::Error);
+        QCOMPARE(diagnostics[0].line, 3);
+        QCOMPARE(diagnostics[0].column, 5);
+        QCOMPARE(diagnostics[0].message, QString("`x' undeclared"));
+        QVERIFY(diagnostics[0].file.isEmpty());
+        QCOMPARE(diagnostics[1].severity, ShaderDiagnostic::Warning);
+        QCOMPARE(diagnostics[2].file, QString("common.glsl"));
+        QCOMPARE(diagnostics[2].line, 7);
+    }
+    void nvidiaTest(){
+        auto diagnostics = ShaderDiagnostics::parse(
+                    "0(3) : error C1008: undefined variable \"x\"\n"
+                    "0(2) : warning C7050: \"y\" might be used before being initialized\n", expansion);
+        QCOMPARE(diagnostics.size(), 2);
+        QCOMPARE(diagnostics[0].line, 3);
+        QCOMPARE(diagnostics[0].message, QString("C1008: undefined variable \"x\""));
+        QCOMPARE(diagnostics[1].severity, ShaderDiagnostic::Warning);
+        QCOMPARE(diagnostics[1].line, 2);
+    }
+    void amdTest(){
+        auto diagnostics = ShaderDiagnostics::parse(
+                    "ERROR: 0:3: 'x' : undeclared identifier\n"
+                    "WARNING: 1:4: implicit cast\n"
+                    "ERROR: 1 compilation errors.  No code generated.\n", expansion);
+        QCOMPARE(diagnostics.size(), 2);
+        QCOMPARE(diagnostics[0].line, 3);
+        QCOMPARE(diagnostics[0].message, QString("'x' : undeclared identifier"));
+        QCOMPARE(diagnostics[1].severity, ShaderDiagnostic::Warning);
+        QCOMPARE(diagnostics[1].file, QString("common.glsl"));
+    }
+    void unknownFormatTest(){
+        auto diagnostics = ShaderDiagnostics::parse("something went wrong\n", expansion);
+        QCOMPARE(diagnostics.size(), 1);
+        QCOMPARE(diagnostics[0].line, -1);
+        QVERIFY(ShaderDiagnostics::hasErrors(diagnostics));
+        QVERIFY(ShaderDiagnostics::parse("", expansion).isEmpty());
+    }
+    void sourceMapTest(){
+        // The #line after #version keeps the lines of the editor
+        QCOMPARE(expansion.locateLine(1).line, 1);
+        QCOMPARE(expansion.locateLine(3).line, 2);
+        QCOMPARE(expansion.locateLine(4).line, 3);
+    }
+private:
+    ShaderPreprocessor::Result expansion;
+};
+
+#endif // SHADERDIAGNOSTICSTEST_H
@@ -0,0 +1,114 @@
+#ifndef SHADERFILETEST_H
+#define SHADERFILETEST_H
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QSignalSpy>
+
+#include "../src/ShaderFile.hpp"
+#include "../src/ShaderFileThread.hpp"
+
+/**
+ * @brief The ShaderFile Testing class
+ *
+ * Tests the ShaderFile class; functionality tested includes
+ * detecting the encoding, keeping encoding and line endings
+ * when writing back, failed writes and the tickets of saves
+ * on the file thread.
+ */
+class ShaderFileTest : public QObject{
+Q_OBJECT
+private slots:
+    void initTestCase(){
+        QVERIFY(dir.isValid());
+    }
+    void utf8Test(){
+        QByteArray data("// \xc3\xa4\nvoid main(){}\n");
+        auto content = read("utf8.glsl", data);
+        QVERIFY(content.ok());
+        QCOMPARE(content.codec, QByteArray("UTF-8"));
+        QVERIFY(!content.bom);
+        QCOMPARE(content.text, QString::fromUtf8(data));
+        QCOMPARE(rewritten("utf8.glsl", content), data);
+    }
+    void bomTest(){
+        QByteArray data("\xef\xbb\xbfvoid main(){}");
+        auto content = read("bom.glsl", data);
+        QVERIFY(content.bom);
+        QCOMPARE(content.text, QStringLiteral("void main(){}"));
+        QCOMPARE(rewritten("bom.glsl", content), data);
+
+        data = QByteArray("\xff\xfev\0o\0i\0d\0", 10);
+        content = read("utf16.glsl", data);
+        QVERIFY(content.bom);
+        QCOMPARE(content.text, QStringLiteral("void"));
+        QCOMPARE(rewritten("utf16.glsl", content), data);
+    }
+    void latin1Test(){
+        QByteArray data("// \xe4\n");
+        auto content = read("latin1.glsl", data);
+        QCOMPARE(content.codec, QByteArray("ISO-8859-1"));
+        QCOMPARE(content.text, QString::fromUtf8("// \xc3\xa4\n"));
+        QCOMPARE(rewritten("latin1.glsl", content), data);
+
+        // Text Latin-1 cannot hold is saved as UTF-8
+        content.text = QString::fromUtf8("// \xe2\x82\xac\n");
+        QCOMPARE(ShaderFile::encode(content), QByteArray("// \xe2\x82\xac\n"));
+    }
+    void lineEndingTest(){
+        QByteArray data("void main(){\r\n}\r\n");
+        auto content = read("crlf.glsl", data);
+        QVERIFY(content.crlf);
+        QCOMPARE(content.text, QStringLiteral("void main(){\n}\n"));
+        QCOMPARE(rewritten("crlf.glsl", content), data);
+    }
+    void failedWriteTest(){
+        QVERIFY(!ShaderFile::read(dir.filePath("missing.glsl")).ok());
+
+        ShaderFile::Content content;
+        content.text = "void main(){}";
+        QVERIFY(!ShaderFile::write(dir.filePath("missing/shader.glsl"), content).isEmpty());
+        QVERIFY(!QFile::exists(dir.filePath("missing/shader.glsl")));
+    }
+    void supersededSaveTest(){
+        ShaderFileThread thread;
+        QSignalSpy saved(&thread, SIGNAL(saved(int,QString,QString)));
+        ShaderFile::Content first, second;
+        first.text = "void first(){}";
+        second.text = "void second(){}";
+        int firstTicket = thread.save(dir.filePath("twice.glsl"), first);
+        int secondTicket = thread.save(dir.filePath("twice.glsl"), second);
+
+        // Every ticket is reported, replaced or not
+        for(int i = 0; i < 20 && saved.size() < 2; ++i)
+            saved.wait(100);
+        QCOMPARE(saved.size(), 2);
+        QList<int> tickets;
+        for(auto &arguments : saved)
+            tickets << arguments.at(0).toInt();
+        QVERIFY(tickets.contains(firstTicket));
+        QVERIFY(tickets.contains(secondTicket));
+        QVERIFY(saved.last().at(2).toString().isEmpty());
+        QCOMPARE(ShaderFile::read(dir.filePath("twice.glsl")).text, second.text);
+    }
+private:
+    ShaderFile::Content read(const QString &name, const QByteArray &data){
+        QFile file(dir.filePath(name));
+        file.open(QFile::WriteOnly);
+        file.write(data);
+        file.close();
+        return ShaderFile::read(dir.filePath(name));
+    }
+    QByteArray rewritten(const QString &name, const ShaderFile::Content &content){
+        if(!ShaderFile::write(dir.filePath(name), content).isEmpty())
+            return QByteArray();
+        QFile file(dir.filePath(name));
+        file.open(QFile::ReadOnly);
+        return file.readAll();
+    }
+
+    QTemporaryDir dir;
+};
+
+#endif // SHADERFILETEST_H
@@ -0,0 +1,143 @@
+#ifndef SHADERPREPROCESSORTEST_H
+#define SHADERPREPROCESSORTEST_H
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include "../src/ShaderPreprocessor.hpp"
+
+/**
+ * @brief The ShaderPreprocessor Testing class
+ *
+ * Tests the ShaderPreprocessor class; functionality tested includes
+ * include expansion, error locations, the expansion cache and
+ * lifting literals into uniforms.
+ */
+class ShaderPreprocessorTest : public QObject{
+Q_OBJECT
+private slots:
+    void initTestCase(){
+        QVERIFY(dir.isValid());
+        write("common.glsl", "float common(){ return 1.0; }\n");
+        write("nested.glsl", "#include \"common.glsl\"\nfloat nested(){ return common(); }\n");
+    }
+    void expansionTest(){
+        ShaderPreprocessor preprocessor;
+        auto result = preprocessor.process("#version 330 core\n#include \"nested.glsl\"\nvoid main(){}", dir.path());
+        QVERIFY(result.ok());
+        QCOMPARE(result.files.size(), 3);
+        QVERIFY(result.source.contains("float common()"));
+        QVERIFY(result.source.contains("float nested()"));
+        QVERIFY(result.source.startsWith("#version 330 core\n#line 2 0\n"));
+        QVERIFY(result.source.contains("#line 1 1\n#line 1 2\n"));
+        QVERIFY(result.source.endsWith("#line 3 0\nvoid main(){}"));
+
+        auto location = result.locate(2, 1);
+        QCOMPARE(location.file, dir.filePath("common.glsl"));
+        QCOMPARE(location.line, 1);
+        QVERIFY(result.locate(0, 3).file.isEmpty());
+    }
+    void missingIncludeTest(){
+        ShaderPreprocessor preprocessor;
+        auto result = preprocessor.process("#version 330 core\n\n#include <missing.glsl>\n", dir.path());
+        QVERIFY(!result.ok());
+        QVERIFY(result.errorLocation.file.isEmpty());
+        QCOMPARE(result.errorLocation.line, 3);
+    }
+    void includeOnceTest(){
+        ShaderPreprocessor preprocessor;
+        auto result = preprocessor.process("#include \"common.glsl\"\n#include \"nested.glsl\"\n", dir.path());
+        QVERIFY(result.ok());
+        QCOMPARE(result.source.count("float common()"), 1);
+    }
+    void searchPathTest(){
+        ShaderPreprocessor preprocessor;
+        QVERIFY(!preprocessor.process("#include <common.glsl>\n").ok());
+        preprocessor.setSearchPaths(QStringList() << dir.path());
+        QVERIFY(preprocessor.process("#include <common.glsl>\n").ok());
+    }
+    void cacheTest(){
+        ShaderPreprocessor preprocessor;
+        QString source = "#include \"nested.glsl\"\n";
+        auto first = preprocessor.process(source, dir.path());
+        auto reads = preprocessor.reads();
+        QCOMPARE(reads, quint64(2));
+
+        auto second = preprocessor.process(source, dir.path());
+        QCOMPARE(preprocessor.reads(), reads);
+        QCOMPARE(second.source, first.source);
+
+        // Only the file that changed is read again
+        write("common.glsl", "float common(){ return 2.0; }\n\n");
+        auto third = preprocessor.process(source, dir.path());
+        QCOMPARE(preprocessor.reads(), reads + 1);
+        QVERIFY(third.source.contains("return 2.0"));
+    }
+    void tweakTest(){
+        ShaderPreprocessor preprocessor;
+        QString source = "#version 330 core\n"
+                         "const int n = 4;\n"
+                         "#pragma tweak on\n"
+                         "float scale = 4.5; // 1.0\n"
+                         "int iter = 0x10;\n"
+                         "const float k = 2.0;\n"
+                         "float a[3];\n"
+                         "layout(location = 0) out vec4 color;\n"
+                         "#pragma tweak off\n"
+                         "float fixed = 1.0;\n";
+        auto result = preprocessor.process(source);
+        QVERIFY(result.ok());
+        QCOMPARE(result.tweaks.size(), 2);
+        QCOMPARE(result.tweaks[0].name, QString("_tweak0"));
+        QCOMPARE(result.tweaks[0].type, ShaderPreprocessor::Tweak::Float);
+        QCOMPARE(result.tweaks[0].value, 4.5);
+        QCOMPARE(result.tweaks[1].type, ShaderPreprocessor::Tweak::Int);
+        QCOMPARE(result.tweaks[1].value, 16.0);
+
+        QVERIFY(result.source.startsWith("#version 330 core\nuniform float _tweak0;\nuniform int _tweak1;\n#line 2 0\n"));
+        QVERIFY(result.source.contains("float scale = _tweak0; // 1.0\nint iter = _tweak1;\n"));
+        QVERIFY(result.source.contains("const int n = 4;"));
+        QVERIFY(result.source.contains("const float k = 2.0;"));
+        QVERIFY(result.source.contains("float a[3];"));
+        QVERIFY(result.source.contains("layout(location = 0)"));
+        QVERIFY(result.source.contains("float fixed = 1.0;"));
+
+        // Lines stay where they were
+        int line = result.source.left(result.source.indexOf("int iter")).count('\n') + 1;
+        QCOMPARE(result.locateLine(line).line, 5);
+
+        // Other numbers expand to the same code
+        auto other = preprocessor.process(QString(source).replace("4.5", "5.5"));
+        QCOMPARE(other.source, result.source);
+        QCOMPARE(other.tweaks[0].value, 5.5);
+    }
+    void tweakVersionTest(){
+        ShaderPreprocessor preprocessor;
+        auto result = preprocessor.process("// Header\n"
+                                           "/* block\n"
+                                           "   comment */\n"
+                                           "\n"
+                                           "#version 330 core\n"
+                                           "#pragma tweak on\n"
+                                           "float scale = 2.0;\n"
+                                           "#pragma tweak off\n");
+        QVERIFY(result.ok());
+        QCOMPARE(result.tweaks.size(), 1);
+        QVERIFY(result.source.startsWith("// Header\n/* block\n   comment */\n\n"
+                                         "#version 330 core\nuniform float _tweak0;\n#line 6 0\n"));
+
+        int line = result.source.left(result.source.indexOf("float scale")).count('\n') + 1;
+        QCOMPARE(result.locateLine(line).line, 7);
+    }
+private:
+    void write(const QString &name, const QString &content){
+        QFile file(dir.filePath(name));
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        QTextStream(&file) << content;
+    }
+
+    QTemporaryDir dir;
+};
+
+#endif // SHADERPREPROCESSORTEST_H
@@ -44,15 +44,43 @@ HEADERS += \
     RendererTest.hpp \
     ../src/Instances/WindowInstance.hpp \
     CodeHighlighterTest.hpp \
+    ShaderPreprocessorTest.hpp \
+    ShaderDiagnosticsTest.hpp \
+    GlslParserTest.hpp \
+    ShaderValidatorTest.hpp \
+    ShaderFileTest.hpp \
+    FrameClockTest.hpp \
+    TextureCacheTest.hpp \
+    TextureCodecTest.hpp \
     ../src/SettingsWindow.hpp \
     ../src/SettingsTab.hpp \
     ../src/Renderer.hpp \
     ../src/CodeHighlighter.hpp \
-    ../src/LiveThread.hpp \
     ../src/BootLoader.hpp \
     ../src/Instances/IInstance.hpp \
     ../src/Model3D.hpp \
-    ../src/ObjectLoaderDialog.hpp
+    ../src/ObjectLoaderDialog.hpp \
+    ../src/TextureCache.hpp \
+    ../src/TextureCodec.hpp \
+    ../src/VideoTexture.hpp \
+    ../src/UniformTable.hpp \
+    ../src/GlStateCache.hpp \
+    ../src/RenderThread.hpp \
+    ../src/AudioCapture.hpp \
+    ../src/AudioFile.hpp \
+    ../src/AudioAnalyzer.hpp \
+    ../src/FrameClock.hpp \
+    ../src/ShaderPreprocessor.hpp \
+    ../src/ShaderDiagnostics.hpp \
+    ../src/GlslLexer.hpp \
+    ../src/GlslParser.hpp \
+    ../src/GlslParserThread.hpp \
+    ../src/ShaderValidator.hpp \
+    ../src/ShaderValidatorThread.hpp \
+    ../src/FileWatcher.hpp \
+    ../src/ShaderFile.hpp \
+    ../src/ShaderFileThread.hpp \
+    ../src/SettingsStore.hpp
 
 SOURCES += \
     main.cpp \
@@ -68,4 +96,25 @@ SOURCES += \
     ../src/BootLoader.cpp \
     ../src/Instances/WindowInstance.cpp \
     ../src/Model3D.cpp \
-    ../src/ObjectLoaderDialog.cpp
+    ../src/ObjectLoaderDialog.cpp \
+    ../src/TextureCache.cpp \
+    ../src/TextureCodec.cpp \
+    ../src/VideoTexture.cpp \
+    ../src/UniformTable.cpp \
+    ../src/GlStateCache.cpp \
+    ../src/RenderThread.cpp \
+    ../src/AudioCapture.cpp \
+    ../src/AudioFile.cpp \
+    ../src/AudioAnalyzer.cpp \
+    ../src/FrameClock.cpp \
+    ../src/ShaderPreprocessor.cpp \
+    ../src/ShaderDiagnostics.cpp \
+    ../src/GlslLexer.cpp \
+    ../src/GlslParser.cpp \
+    ../src/GlslParserThread.cpp \
+    ../src/ShaderValidator.cpp \
+    ../src/ShaderValidatorThread.cpp \
+    ../src/FileWatcher.cpp \
+    ../src/ShaderFile.cpp \
+    ../src/ShaderFileThread.cpp \
+    ../src/SettingsStore.cpp
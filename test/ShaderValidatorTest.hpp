@@ -0,0 +1,106 @@
+#ifndef SHADERVALIDATORTEST_H
+#define SHADERVALIDATORTEST_H
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include "../src/ShaderValidator.hpp"
+
+/**
+ * @brief The ShaderValidator Testing class
+ *
+ * Tests the ShaderValidator class; functionality tested includes
+ * the templates, errors in included files, matching the
+ * interface of both stages and the hash of the code.
+ */
+class ShaderValidatorTest : public QObject{
+Q_OBJECT
+private slots:
+    void initTestCase(){
+        QVERIFY(dir.isValid());
+        QFile file(dir.filePath("broken.glsl"));
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        QTextStream(&file) << "float broken(){\n    return (1.0;\n}\n";
+    }
+    void templateTest(){
+        ShaderValidator validator;
+        auto result = validator.validate(read(":/rc/template.vert"), read(":/rc/template.frag"));
+        QVERIFY(result.ok());
+        QVERIFY(result.vertex.isEmpty());
+        QVERIFY(result.fragment.isEmpty());
+    }
+    void includeTest(){
+        ShaderValidator validator;
+        auto result = validator.validate("#version 330 core\n#include \"broken.glsl\"\nvoid main(){}\n",
+                                         "#version 330 core\n#include <missing.glsl>\n", dir.path());
+        QVERIFY(!result.ok());
+        QCOMPARE(result.vertex.size(), 1);
+        QCOMPARE(result.vertex[0].file, dir.filePath("broken.glsl"));
+        QCOMPARE(result.vertex[0].line, 2);
+        QCOMPARE(result.vertex[0].severity, ShaderDiagnostic::Error);
+        QCOMPARE(result.fragment.size(), 1);
+        QVERIFY(result.fragment[0].file.isEmpty());
+        QCOMPARE(result.fragment[0].line, 2);
+
+        // A bracket error alone fails the validation
+        result = validator.validate("#version 330 core\n#include \"broken.glsl\"\nvoid main(){}\n",
+                                    read(":/rc/template.frag"), dir.path());
+        QVERIFY(!result.ok());
+
+        // A missing semicolon is only guessed, the driver decides
+        result = validator.validate("#version 330 core\nvoid main(){\n    float a = 1.0\n    float b = a;\n}\n",
+                                    read(":/rc/template.frag"));
+        QVERIFY(result.ok());
+        QCOMPARE(result.vertex.size(), 1);
+        QCOMPARE(result.vertex[0].severity, ShaderDiagnostic::Warning);
+        QCOMPARE(result.vertex[0].line, 3);
+    }
+    void interfaceTest(){
+        ShaderValidator validator;
+        QString vertex = "#version 330 core\n"
+                         "out vec2 uv;\n"
+                         "out vec3 normal;\n"
+                         "void main(){ uv = vec2(0); normal = vec3(0); gl_Position = vec4(0); }\n";
+        auto result = validator.validate(vertex,
+                                         "#version 330 core\n"
+                                         "in vec3 uv;\n"
+                                         "in float depth;\n"
+                                         "out vec4 color;\n"
+                                         "void main(){ color = vec4(uv, 1); }\n");
+        QVERIFY(!result.ok());
+        QVERIFY(result.vertex.isEmpty());
+        QCOMPARE(result.fragment.size(), 2);
+        QCOMPARE(result.fragment[0].severity, ShaderDiagnostic::Error);
+        QCOMPARE(result.fragment[0].line, 2);
+        QCOMPARE(result.fragment[0].column, 9);
+        QCOMPARE(result.fragment[1].severity, ShaderDiagnostic::Warning);
+        QCOMPARE(result.fragment[1].line, 3);
+
+        // An input that is not written is only a warning
+        result = validator.validate(vertex, "#version 330 core\nin vec2 uv;\nin float depth;\nvoid main(){}\n");
+        QVERIFY(result.ok());
+        QCOMPARE(result.fragment.size(), 1);
+    }
+    void hashTest(){
+        ShaderValidator validator;
+        QString vertex = read(":/rc/template.vert"), fragment = read(":/rc/template.frag");
+        auto hash = validator.validate(vertex, fragment).hash;
+        QVERIFY(!hash.isEmpty());
+
+        // Comments and whitespace do not change the shader
+        QCOMPARE(validator.validate(vertex + "\n/* done\n */\n", QString(fragment).replace("    ", "\t")).hash, hash);
+        QVERIFY(validator.validate(vertex, QString(fragment).replace("color.a = 1", "color.a = 0.5")).hash != hash);
+        QVERIFY(validator.validate(vertex, "#version 330 core\n#include <missing.glsl>\n").hash.isEmpty());
+    }
+private:
+    static QString read(const QString &path){
+        QFile file(path);
+        file.open(QIODevice::ReadOnly | QIODevice::Text);
+        return QString::fromUtf8(file.readAll());
+    }
+
+    QTemporaryDir dir;
+};
+
+#endif // SHADERVALIDATORTEST_H
@@ -0,0 +1,77 @@
+#ifndef TEXTURECACHETEST_H
+#define TEXTURECACHETEST_H
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <QImage>
+
+#include "../src/TextureCache.hpp"
+
+/**
+ * @brief The TextureCache Testing class
+ *
+ * Tests the TextureCache class; functionality tested includes
+ * keying images by path and modification time and evicting
+ * the least recently used images that are not in use.
+ */
+class TextureCacheTest : public QObject{
+Q_OBJECT
+private slots:
+    void initTestCase(){
+        QVERIFY(dir.isValid());
+    }
+    void keyTest(){
+        QString path = write("key.png", Qt::red);
+        auto key = TextureCache::keyFor(QFileInfo(path));
+        QVERIFY(key.startsWith(QFileInfo(path).absoluteFilePath() + "@"));
+
+        auto image = TextureCache::instance()->request(path);
+        QCOMPARE(TextureCache::instance()->request(path), image);
+        QTRY_VERIFY(image->isReady());
+        QVERIFY(image->isValid());
+
+        // Modification times can be as coarse as a second
+        QTest::qSleep(1100);
+        write("key.png", Qt::blue);
+        QVERIFY(TextureCache::keyFor(QFileInfo(path)) != key);
+        auto changed = TextureCache::instance()->request(path);
+        QVERIFY(changed != image);
+        QCOMPARE(changed->path, image->path);
+    }
+    void evictionTest(){
+        auto cache = TextureCache::instance();
+        auto first = cache->request(write("first.png", Qt::red));
+        auto second = cache->request(write("second.png", Qt::green));
+        auto used = cache->request(write("used.png", Qt::blue));
+        QTRY_VERIFY(first->isReady() && second->isReady() && used->isReady());
+
+        // first is used more recently than second
+        cache->request(first->path);
+        std::weak_ptr<TextureImage> firstWeak = first, secondWeak = second;
+        first.reset();
+        second.reset();
+
+        // Room for one unused image besides the one in use
+        cache->setLimit(2 * used->byteSize());
+        QVERIFY(secondWeak.expired());
+        QVERIFY(!firstWeak.expired());
+
+        cache->setLimit(0);
+        QVERIFY(firstWeak.expired());
+        QCOMPARE(cache->request(used->path), used);
+        cache->setLimit(512 * 1024 * 1024);
+    }
+
+private:
+    QString write(const QString &name, Qt::GlobalColor color){
+        QImage image(16, 16, QImage::Format_ARGB32);
+        image.fill(color);
+        QString path = dir.filePath(name);
+        image.save(path, "PNG");
+        return path;
+    }
+
+    QTemporaryDir dir;
+};
+
+#endif // TEXTURECACHETEST_H
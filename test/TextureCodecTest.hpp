@@ -0,0 +1,127 @@
+#ifndef TEXTURECODECTEST_H
+#define TEXTURECODECTEST_H
+
+#include <cstring>
+
+#include <QTest>
+#include <QtEndian>
+
+#include "../src/TextureCodec.hpp"
+
+/**
+ * @brief The TextureCodec Testing class
+ *
+ * Tests the TextureCodec class; functionality tested includes
+ * compressing to BC1 and BC3, writing and reading KTX files,
+ * expanding the blocks again and rejecting broken KTX and DDS
+ * headers.
+ */
+class TextureCodecTest : public QObject{
+Q_OBJECT
+private slots:
+    void opaqueRoundTripTest(){
+        roundTrip(gradient(16, 12, false), bc1);
+    }
+    void alphaRoundTripTest(){
+        // Not a multiple of the block size
+        roundTrip(gradient(10, 6, true), bc3);
+    }
+    void ktxHeaderTest(){
+        TextureCodec::Format format;
+        QVector<TextureCodec::Level> levels;
+        auto file = TextureCodec::writeKtx(TextureCodec::rgba8, {{1, 1, QByteArray(4, 'x')}});
+        QVERIFY(TextureCodec::read(file, format, levels));
+        QCOMPARE(levels.size(), 1);
+
+        QVERIFY(!TextureCodec::readKtx(file.left(40), format, levels));
+        QVERIFY(!TextureCodec::readKtx(file.left(file.size() - 1), format, levels));
+        QByteArray broken = file;
+        broken[1] = 'X';
+        QVERIFY(!TextureCodec::readKtx(broken, format, levels));
+        // A cube map
+        broken = file;
+        qToLittleEndian<quint32>(6, reinterpret_cast<uchar*>(broken.data()) + 52);
+        QVERIFY(!TextureCodec::readKtx(broken, format, levels));
+        // More levels than the file holds
+        broken = file;
+        qToLittleEndian<quint32>(2, reinterpret_cast<uchar*>(broken.data()) + 56);
+        QVERIFY(!TextureCodec::readKtx(broken, format, levels));
+    }
+    void ddsHeaderTest(){
+        TextureCodec::Format format;
+        QVector<TextureCodec::Level> levels;
+        auto file = dds("DXT1", 4, 4) + QByteArray(8, 0);
+        QVERIFY(TextureCodec::read(file, format, levels));
+        QCOMPARE(format.internalFormat, GLenum(bc1Alpha));
+        QCOMPARE(levels.size(), 1);
+        QCOMPARE(levels[0].data.size(), 8);
+
+        QVERIFY(!TextureCodec::readDds(file.left(100), format, levels));
+        QVERIFY(!TextureCodec::readDds(file.left(file.size() - 1), format, levels));
+        QVERIFY(!TextureCodec::readDds(dds("ABCD", 4, 4) + QByteArray(8, 0), format, levels));
+        // Not block compressed
+        QByteArray broken = file;
+        qToLittleEndian<quint32>(0x40, reinterpret_cast<uchar*>(broken.data()) + 80);
+        QVERIFY(!TextureCodec::readDds(broken, format, levels));
+    }
+
+private:
+    // The S3TC enums, which the GL headers may not define
+    static const GLenum bc1 = 0x83F0, bc1Alpha = 0x83F1, bc3 = 0x83F3;
+
+    static QImage gradient(int width, int height, bool alpha){
+        QImage image(width, height, QImage::Format_RGBA8888);
+        for(int y = 0; y < height; ++y){
+            auto line = image.scanLine(y);
+            for(int x = 0; x < width; ++x){
+                // Colors on the diagonal of their bounding box, as
+                // the encoder fits them
+                line[x * 4] = uchar(x * 255 / width);
+                line[x * 4 + 1] = uchar(64 + x * 128 / width);
+                line[x * 4 + 2] = 128;
+                line[x * 4 + 3] = alpha ? uchar(y * 255 / height) : 255;
+            }
+        }
+        return image;
+    }
+    static void roundTrip(const QImage &image, GLenum expected){
+        TextureCodec::Format format;
+        auto compressed = TextureCodec::compress({image}, format);
+        QCOMPARE(format.internalFormat, expected);
+        QVERIFY(format.compressed);
+
+        TextureCodec::Format readFormat;
+        QVector<TextureCodec::Level> levels;
+        QVERIFY(TextureCodec::read(TextureCodec::writeKtx(format, compressed), readFormat, levels));
+        QCOMPARE(readFormat.internalFormat, expected);
+        QCOMPARE(levels.size(), 1);
+        QCOMPARE(levels[0].width, image.width());
+        QCOMPARE(levels[0].height, image.height());
+        QCOMPARE(levels[0].data, compressed[0].data);
+
+        QVERIFY(TextureCodec::decompress(readFormat, levels));
+        QCOMPARE(readFormat.internalFormat, GLenum(GL_RGBA8));
+        QCOMPARE(levels[0].data.size(), image.width() * image.height() * 4);
+        auto pixels = reinterpret_cast<const uchar*>(levels[0].data.constData());
+        int worst = 0;
+        for(int y = 0; y < image.height(); ++y)
+            for(int x = 0; x < image.width() * 4; ++x)
+                worst = qMax(worst, qAbs(int(pixels[y * image.width() * 4 + x]) - int(image.constScanLine(y)[x])));
+        QVERIFY2(worst <= 12, qPrintable(QString("Off by %1").arg(worst)));
+    }
+    static QByteArray dds(const char *fourCC, int width, int height){
+        QByteArray file(128, 0);
+        auto header = reinterpret_cast<uchar*>(file.data());
+        std::memcpy(header, "DDS ", 4);
+        qToLittleEndian<quint32>(124, header + 4);
+        qToLittleEndian<quint32>(0x1007, header + 8);
+        qToLittleEndian<quint32>(height, header + 12);
+        qToLittleEndian<quint32>(width, header + 16);
+        qToLittleEndian<quint32>(32, header + 76);
+        qToLittleEndian<quint32>(0x4, header + 80);
+        std::memcpy(header + 84, fourCC, 4);
+        return file;
+    }
+};
+
+#endif // TEXTURECODECTEST_H
@@ -7,6 +7,14 @@
 #include "SettingsBackendTest.hpp"
 #include "RendererTest.hpp"
 #include "CodeHighlighterTest.hpp"
+#include "ShaderPreprocessorTest.hpp"
+#include "ShaderDiagnosticsTest.hpp"
+#include "GlslParserTest.hpp"
+#include "ShaderValidatorTest.hpp"
+#include "ShaderFileTest.hpp"
+#include "FrameClockTest.hpp"
+#include "TextureCacheTest.hpp"
+#include "TextureCodecTest.hpp"
 
 /**
  * @brief The Tests struct
@@ -50,7 +58,15 @@ int main(int argc, char** argv){
             {QStringLiteral("SettingsBackend"), factory<SettingsBackendTest>},
             {QStringLiteral("Renderer"), factory<RendererTest>},
             {QStringLiteral("Backend"), factory<BackendTest>},
-            {QStringLiteral("CodeHighlighter"), factory<CodeHighlighterTest>}
+            {QStringLiteral("CodeHighlighter"), factory<CodeHighlighterTest>},
+            {QStringLiteral("ShaderPreprocessor"), factory<ShaderPreprocessorTest>},
+            {QStringLiteral("ShaderDiagnostics"), factory<ShaderDiagnosticsTest>},
+            {QStringLiteral("GlslParser"), factory<GlslParserTest>},
+            {QStringLiteral("ShaderValidator"), factory<ShaderValidatorTest>},
+            {QStringLiteral("ShaderFile"), factory<ShaderFileTest>},
+            {QStringLiteral("FrameClock"), factory<FrameClockTest>},
+            {QStringLiteral("TextureCache"), factory<TextureCacheTest>},
+            {QStringLiteral("TextureCodec"), factory<TextureCodecTest>}
             };
 	    
     unsigned int size = sizeof(testcases)/sizeof(Tests);